@@ -0,0 +1,194 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Packed bits of MATLAB matrices with the kernels of libyaldpc ( ykernel.c ),
+	code independent, so one build serves every code:
+	MEX: QCLDPCBitsMEX.c ykernel.c
+*/
+
+#include <string.h>
+#include <stdint.h>
+
+#include "mex.h"
+#include "matrix.h"
+#include "yaldpc.h"
+#include "yaldpc_int.h"
+
+static int Ready = 0 ;	// YKernelInit() done
+
+
+#ifdef MATLAB_MEX_FILE
+/*
+	MATLAB calls:
+		Bits	= QCLDPCBitsMEX( 'pack', X )
+		X		= QCLDPCBitsMEX( 'unpack', Bits [, n ] )
+		Errors	= QCLDPCBitsMEX( 'errors', A, B )
+	Assuming:
+		columns are independent vectors, bits are packed MSB first into uint8,
+		( rows + 7 ) / 8 bytes per column, the last one zero padded,
+		like the bits of QCLDPCDecodeMEX and Bits( 'uint8' ).
+		X to pack is logical or uint8 ( nonzero > 1 ) or single LLRs ( negative > 1 ),
+		unpack returns the first n bits of every column as logical, default all,
+		errors returns the nr. of different bits of every column of two uint8
+		bitmaps of the same size as a double row vector ( popcount ).
+*/
+
+	static void packColumns( mxArray *plhs[], const mxArray *X ){
+		const int r = ( int ) mxGetM( X ), c = ( int ) mxGetN( X ), rb = ( r + 7 ) / 8 ;
+		const uint8_t *v	= NULL ;
+		const float *z		= NULL ;
+		uint8_t *bits 		= NULL ;
+		int j ;
+
+		if( mxIsLogical( X ) ){
+			v = ( const uint8_t * ) mxGetLogicals( X ) ;
+		} else if( mxIsUint8( X ) ){
+			v = ( const uint8_t * ) mxGetUint8s( X ) ;
+		} else if( mxIsSingle( X ) && !mxIsComplex( X ) ){
+			z = ( const float * ) mxGetSingles( X ) ;
+		} else {
+			mexErrMsgIdAndTxt("LDPCBitsMEX:packClass", "pack: input must be logical, uint8 or real single.") ;
+		}
+
+		if( ( plhs[ 0 ] = mxCreateNumericMatrix( rb, c, mxUINT8_CLASS, mxREAL ) ) == NULL ){
+			mexErrMsgIdAndTxt("LDPCBitsMEX:outputFail", "Allocating output bits for MATLAB failed.") ;
+		}
+		if( r == 0 || c == 0 ){
+			return ;
+		}
+		bits = ( uint8_t * ) mxGetUint8s( plhs[ 0 ] ) ;
+
+		for( j = 0 ; j < c ; j++ ){
+			if( z != NULL ){
+				YKern.packBits( NULL, z + ( size_t ) r * j, bits + ( size_t ) rb * j, r ) ;
+			} else {
+				YKern.packBytes( NULL, v + ( size_t ) r * j, bits + ( size_t ) rb * j, r ) ;
+			}
+		}
+	}
+
+	static void unpackColumns( mxArray *plhs[], int nrhs, const mxArray *prhs[] ){
+		const mxArray *B = prhs[ 1 ] ;
+		const int rb = ( int ) mxGetM( B ), c = ( int ) mxGetN( B ) ;
+		const uint8_t *bits	= NULL ;
+		uint8_t *v 			= NULL ;
+		int j, n = 8 * rb ;
+
+		if( !mxIsUint8( B ) ){
+			mexErrMsgIdAndTxt("LDPCBitsMEX:unpackClass", "unpack: bits must be uint8.") ;
+		}
+		if( nrhs > 2 ){
+			if( !mxIsDouble( prhs[ 2 ] ) || mxGetNumberOfElements( prhs[ 2 ] ) != 1 ){
+				mexErrMsgIdAndTxt("LDPCBitsMEX:unpackN", "unpack: n must be a double scalar.") ;
+			}
+			n = ( int ) mxGetScalar( prhs[ 2 ] ) ;
+			if( n < 0 || n > 8 * rb ){
+				mexErrMsgIdAndTxt("LDPCBitsMEX:unpackN", "unpack: n must be 0 .. 8 x rows of bits.") ;
+			}
+		}
+
+		if( ( plhs[ 0 ] = mxCreateLogicalMatrix( n, c ) ) == NULL ){
+			mexErrMsgIdAndTxt("LDPCBitsMEX:outputFail", "Allocating output matrix for MATLAB failed.") ;
+		}
+		if( n == 0 || c == 0 ){
+			return ;
+		}
+		bits	= ( const uint8_t * ) mxGetUint8s( B ) ;
+		v		= ( uint8_t * ) mxGetLogicals( plhs[ 0 ] ) ;
+
+		for( j = 0 ; j < c ; j++ ){
+			YKern.unpackBits( NULL, bits + ( size_t ) rb * j, v + ( size_t ) n * j, n ) ;
+		}
+	}
+
+	static void countErrors( mxArray *plhs[], const mxArray *A, const mxArray *B ){
+		const int rb = ( int ) mxGetM( A ), c = ( int ) mxGetN( A ) ;
+		const uint8_t *a, *b ;
+		double *e ;
+		int j ;
+
+		if( !mxIsUint8( A ) || !mxIsUint8( B ) ){
+			mexErrMsgIdAndTxt("LDPCBitsMEX:errorsClass", "errors: both bitmaps must be uint8.") ;
+		}
+		if( ( int ) mxGetM( B ) != rb || ( int ) mxGetN( B ) != c ){
+			mexErrMsgIdAndTxt("LDPCBitsMEX:errorsSize", "errors: bitmaps must be of the same size.") ;
+		}
+
+		if( ( plhs[ 0 ] = mxCreateDoubleMatrix( 1, c, mxREAL ) ) == NULL ){
+			mexErrMsgIdAndTxt("LDPCBitsMEX:outputFail", "Allocating output errors for MATLAB failed.") ;
+		}
+		if( rb == 0 || c == 0 ){
+			return ;
+		}
+		a = ( const uint8_t * ) mxGetUint8s( A ) ;
+		b = ( const uint8_t * ) mxGetUint8s( B ) ;
+		e = mxGetDoubles( plhs[ 0 ] ) ;
+
+		for( j = 0 ; j < c ; j++ ){
+			e[ j ] = ( double ) YKern.bitErrors( NULL, a + ( size_t ) rb * j, b + ( size_t ) rb * j, rb ) ;
+		}
+	}
+
+	void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] ) {
+		char cmd[ 8 ] ;
+
+		if( nrhs < 2 || !mxIsChar( prhs[ 0 ] ) || mxGetString( prhs[ 0 ], cmd, sizeof( cmd ) ) != 0 ){
+			mexErrMsgIdAndTxt("LDPCBitsMEX:nrhs", "Usage: QCLDPCBitsMEX( 'pack' | 'unpack' | 'errors', ... ).") ;
+		}
+		if( nlhs > 1 ){
+			mexErrMsgIdAndTxt("LDPCBitsMEX:nlhs", "One output only.") ;
+		}
+
+		if( !Ready ){
+			YKernelInit() ;
+			Ready = 1 ;
+		}
+
+		if( strcmp( cmd, "pack" ) == 0 && nrhs == 2 ){
+			packColumns( plhs, prhs[ 1 ] ) ;
+		} else if( strcmp( cmd, "unpack" ) == 0 && nrhs <= 3 ){
+			unpackColumns( plhs, nrhs, prhs ) ;
+		} else if( strcmp( cmd, "errors" ) == 0 && nrhs == 3 ){
+			countErrors( plhs, prhs[ 1 ], prhs[ 2 ] ) ;
+		} else {
+			mexErrMsgIdAndTxt("LDPCBitsMEX:nrhs", "Usage: QCLDPCBitsMEX( 'pack', X ), ( 'unpack', Bits [, n ] ) or ( 'errors', A, B ).") ;
+		}
+	}
+
+#endif
@@ -54,6 +54,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ldpc.h"
 #include "debug.h"
 #include "decoder.h"
+#include "kernel.h"
 
 int NChan = 1 ;			//nr. of channels (MATLAB columns) to process
 int NIter ;
@@ -62,13 +63,26 @@ FP Beta ;				// offset, ignored in fixed-point implementation
 int Termination = 1 ;	// 1 > early, 0 > after all NIter
 int HD = 0 ;			// also return decoded bits
 int No = 0 ;			// the number of output array elements is BITMAP dependent
+int InType ;			// LLR_* of kernel.h: channel LLRs and posteriors, converted by MSDecodeT()
+int OutType ;
+size_t InSize ;			// their element sizes
+size_t OutSize ;
+int Bits = 0 ;			// 1 > packed systematic bits instead of posteriors, see MSDecodeBits()
+size_t OutStride ;		// bytes of an output column: N posteriors or ( K + 7 ) / 8 packed bits
+
+#ifdef FIXED
+	#define FP_LLR LLR_INT16
+#else
+	#define FP_LLR LLR_SINGLE
+#endif
 
 typedef struct thread_args {
 	pthread_t 	id ;
 	int 		idx ;
 	int 		c ;		// nr. columns to process per thread
-	FP			*in ;	// chanell LLRs block for this thread
-	FP			*out ;	// posterior LLRs
+	const char	*in ;	// chanell LLRs block for this thread, InType
+	char		*out ;	// posterior LLRs, OutType, or packed systematic bits
+	char		*sys ;	// systematic posterior LLRs in bits-only mode, NULL > not needed
 	WORD 		*hd ;	// decoded bits
 	double 		*ite ;	// nr. of actual iterations
 
@@ -76,24 +90,115 @@ typedef struct thread_args {
 
 THREAD_ARGS args[ N_TH ] ;
 
+/*
+	decoder context kept between calls: MSInitDecoder() only runs when the options
+	change ( the code is compiled in ), the worker threads wait for the next call
+	QCLDPCDecodeMEX() with no arguments or unloading the MEX file releases them
+*/
+typedef struct dec_context {
+	int		ready ;		// MSInitDecoder() done for the options below
+	int		nIter ;
+	FP		lambda ;
+	FP		beta ;
+	int		term ;
+
+	int		nth ;		// worker threads running
+	int		quit ;
+	long	job ;		// nr. of the current block, workers wait for the next one
+	int		done ;		// workers finished with the current block
+	pthread_mutex_t	mx ;
+	pthread_cond_t	work ;
+	pthread_cond_t	fin ;
+} DEC_CONTEXT ;
+
+DEC_CONTEXT Ctx = { .mx = PTHREAD_MUTEX_INITIALIZER, .work = PTHREAD_COND_INITIALIZER, .fin = PTHREAD_COND_INITIALIZER } ;
+
 #define handle_error( en, msg ) do { errno = en ; print( msg ) ; return -1 ; } while ( 0 )
 
-void *fun( void *args ){
-	THREAD_ARGS a = *(THREAD_ARGS *)args ;
+/*
+ * columns of a thread in batches of F_B, decoded layer by layer together
+ * */
+void decodeColumns( THREAD_ARGS *a ){
+	int iter[ F_B ] ;
+	int i, j, f, r ;
+
+	for( i = 0 ; i < a->c ; i += f ){
+		f = ( a->c - i < F_B ) ? a->c - i : F_B ;
+		if( Bits ){
+			r = MSDecodeBatchBits( a->in + i * N * InSize, InType, ( uint8_t * )a->out + i * OutStride,
+				( a->sys == NULL ) ? NULL : a->sys + i * K * OutSize, OutType, f, iter, a->idx ) ;
+		}else{
+			r = MSDecodeBatchT( a->in + i * N * InSize, InType, a->out + i * OutStride, OutType,
+				( a->hd == NULL ) ? NULL : a->hd + i * No, f, iter, a->idx ) ;
+		}
+		for( j = 0 ; j < f ; j++ )
+			a->ite[ i + j ] = ( double )( r < 0 ? r : iter[ j ] ) ;
+	}
+}
+
+void *fun( void *arg ){
+	THREAD_ARGS *a = ( THREAD_ARGS * )arg ;
+	long seen = 0 ;
 
 	//carefull: print statements here only work in CLI, will crash MATLAB
 
-	for( int i = 0 ; i < a.c ; i++ ){
-		a.ite[ i ] = ( double )MSDecode( a.in + i * N , a.out + i * N, a.idx ) ;
-		if( a.hd != NULL ){
-			HardDecision( a.out + i * N, a.hd + i * No, N ) ;
-		}
+	pthread_mutex_lock( &Ctx.mx ) ;
+	for( ;; ){
+		while( !Ctx.quit && Ctx.job == seen )
+			pthread_cond_wait( &Ctx.work, &Ctx.mx ) ;
+		if( Ctx.quit )
+			break ;
+		seen = Ctx.job ;
+		pthread_mutex_unlock( &Ctx.mx ) ;
+
+		decodeColumns( a ) ;
+
+		pthread_mutex_lock( &Ctx.mx ) ;
+		if( ++Ctx.done == Ctx.nth )
+			pthread_cond_signal( &Ctx.fin ) ;
 	}
+	pthread_mutex_unlock( &Ctx.mx ) ;
+
+	return NULL ;
+}
+
+/*
+ * decoder options of this call, MSInitDecoder() only if they differ from the context
+ * */
+void initContext( int nIter, FP lambda, FP beta, int term ){
+	if( Ctx.ready && Ctx.nIter == nIter && Ctx.lambda == lambda && Ctx.beta == beta && Ctx.term == term )
+		return ;
+
+	MSInitDecoder( nIter, lambda, beta, term ) ;
+	Ctx.nIter	= nIter ;
+	Ctx.lambda	= lambda ;
+	Ctx.beta	= beta ;
+	Ctx.term	= term ;
+	Ctx.ready	= 1 ;
+}
 
-	pthread_exit( NULL ) ;
+/*
+ * ends the worker threads, the next call initializes the decoder again
+ * */
+void clearContext( void ){
+	int t ;
+
+	if( Ctx.nth > 0 ){
+		pthread_mutex_lock( &Ctx.mx ) ;
+		Ctx.quit = 1 ;
+		pthread_cond_broadcast( &Ctx.work ) ;
+		pthread_mutex_unlock( &Ctx.mx ) ;
+
+		for( t = 0 ; t < Ctx.nth ; t++ )
+			pthread_join( args[ t ].id, NULL ) ;
+	}
+	Ctx.nth		= 0 ;
+	Ctx.quit	= 0 ;
+	Ctx.job		= 0 ;
+	Ctx.ready	= 0 ;
 }
 
-int decodeMT( FP *in, FP *out, double *ite, int n, int c, WORD *hd ){
+int decodeMT( const void *in, void *out, void *sys, double *ite, int n, int c, WORD *hd ){
 	int t, r, cpt ;
 
  	assert( c % N_TH == 0 ) ;
@@ -102,27 +207,34 @@ int decodeMT( FP *in, FP *out, double *ite, int n, int c, WORD *hd ){
 	cpt = c / N_TH ;	//columns per thread
 
 	dbg(1, "Running %d threads, each processing %d columns.\n", N_TH, cpt ) ;
+	pthread_mutex_lock( &Ctx.mx ) ;
 	for( t = 0 ; t < N_TH ; t++ ){
 		args[ t ].idx 	= t ;
 		args[ t ].c 	= cpt ;
-		args[ t ].in 	= in + t * N * cpt ;
-		args[ t ].out 	= out + t * N * cpt ;
+		args[ t ].in 	= ( const char * )in + t * N * cpt * InSize ;
+		args[ t ].out 	= ( char * )out + t * cpt * OutStride ;
+		args[ t ].sys 	= ( sys == NULL ) ? NULL : ( char * )sys + t * K * cpt * OutSize ;
 		args[ t ].ite 	= ite + t * cpt ;
 		args[ t ].hd 	= ( hd == NULL ) ? NULL : hd + t * No * cpt ;
+	}
 
-		if( ( r = pthread_create( &( args[ t ].id ) , NULL, &fun, (void *)( args + t ) ) ) != 0 )
+	//first call: start the workers, they keep waiting for the next block
+	for( ; Ctx.nth < N_TH ; Ctx.nth++ ){
+		if( ( r = pthread_create( &( args[ Ctx.nth ].id ) , NULL, &fun, (void *)( args + Ctx.nth ) ) ) != 0 ){
+			pthread_mutex_unlock( &Ctx.mx ) ;
+			clearContext() ;
 			handle_error( r, "pthread_create" ) ;
-
+		}
 	}
-	dbg( 1, "All threads created OK.\n" ) ;
-
-	for( t = 0 ; t < N_TH ; t++ ){
 
-		if(	( r = pthread_join( args[ t ].id, NULL ) )  != 0 )
-			handle_error( r, "pthread_join") ;
+	Ctx.done = 0 ;
+	Ctx.job++ ;
+	pthread_cond_broadcast( &Ctx.work ) ;
+	while( Ctx.done < Ctx.nth )
+		pthread_cond_wait( &Ctx.fin, &Ctx.mx ) ;
+	pthread_mutex_unlock( &Ctx.mx ) ;
 
-	}
-	dbg( 1, "All threads joined OK.\n" ) ;
+	dbg( 1, "All threads done OK.\n" ) ;
 	return 0 ;
 }
 
@@ -130,12 +242,20 @@ int decodeMT( FP *in, FP *out, double *ite, int n, int c, WORD *hd ){
 #ifdef MATLAB_MEX_FILE
 
 /*	
-	MATLAB call: [ aLLR, nIter ] = QCLDPCDecodeMEX( LLCh,  Options ) ;
+	MATLAB call: [ aLLR, nIter [, HD ] ] = QCLDPCDecodeMEX( LLCh,  Options ) ;
+	MATLAB call: [ Bits, nIter [, sysLLR ] ] = QCLDPCDecodeMEX( LLCh,  [ Options 1 ] ) ;
+	MATLAB call: QCLDPCDecodeMEX() ends the worker threads and drops the decoder context
 	Assuming: 
 		Codewords is a column vector or matrix where NChan vectors are stored column-wise.
 		The number of rows must be equal to N that is compiled in the auto-generated header file ldpc.h
+		LLCh is single, double, int16 or int8, converted column by column while the decoder loads it,
+		the fixed point decoder quantizes single and double like float2int( LLCh, QB, FP_MAX ),
+		takes int16 and int8 as already quantized
 		Options is a row vector of normal MATLAB variables (stored as double)
-		Options = [ NIter, Lambda, Beta, Debuglevel ]
+		Options = [ NIter, Lambda, Beta, Debuglevel, Termination [, OutClass [, BitsOnly ] ] ]
+		OutClass of aLLR: 0 > the decoder's own ( single or int16, default ), 1 > double, 2 > single
+		BitsOnly = 1: Bits are the K systematic hard decisions packed MSB first, ( K + 7 ) / 8 uint8
+		per column, straight from the final posteriors, sysLLR the K systematic posteriors in OutClass
 
 		TODO: Method can also be used to run unit tests
 */
@@ -143,8 +263,8 @@ int decodeMT( FP *in, FP *out, double *ite, int n, int c, WORD *hd ){
 	void getOptions( const mxArray *prhs[], int i ){
 		double *opts 	= NULL ;
 		
-		if( !mxIsDouble( prhs[ i ] ) || mxIsComplex( prhs[ i ] ) || !( mxGetM( prhs[ i ] ) == 1 && mxGetN( prhs[ i ] ) == 5 ) ) {
-			mexErrMsgIdAndTxt("LDPCEncodeMEX:optsFail", "Options vector not of size == [ 1, 5 ].") ;
+		if( !mxIsDouble( prhs[ i ] ) || mxIsComplex( prhs[ i ] ) || !( mxGetM( prhs[ i ] ) == 1 && mxGetN( prhs[ i ] ) >= 5 && mxGetN( prhs[ i ] ) <= 7 ) ) {
+			mexErrMsgIdAndTxt("LDPCEncodeMEX:optsFail", "Options vector not of size == [ 1, 5 ] to [ 1, 7 ].") ;
 		}
 		if( ( opts = ( double * ) mxGetDoubles( prhs[ i ] ) ) == NULL ){
 			mexErrMsgIdAndTxt("LDPCEncodeMEX:optsFail", "Options vector access failed.") ;
@@ -154,36 +274,100 @@ int decodeMT( FP *in, FP *out, double *ite, int n, int c, WORD *hd ){
 		Beta 	= ( FP )( opts[ 2 ] ) ;
 		Debug	= ( int )( opts[ 3 ] ) ;		//global variable Debug defined in debug.h
 		Termination = ( int )( opts[ 4 ] ) ;
+
+		OutType = FP_LLR ;
+		if( mxGetN( prhs[ i ] ) >= 6 ){
+			switch( ( int )( opts[ 5 ] ) ){
+				case 0:		OutType = FP_LLR ; break ;
+				case 1:		OutType = LLR_DOUBLE ; break ;
+				case 2:		OutType = LLR_SINGLE ; break ;
+				default:	mexErrMsgIdAndTxt("LDPCEncodeMEX:optsFail", "Output class must be 0 ( decoder's ), 1 ( double ) or 2 ( single ).") ;
+			}
+		}
+		OutSize = ( OutType == LLR_DOUBLE ) ? sizeof( double ) : ( OutType == LLR_SINGLE ) ? sizeof( float ) : sizeof( int16_t ) ;
+
+		Bits = ( mxGetN( prhs[ i ] ) == 7 ) ? ( opts[ 6 ] != 0.0 ) : 0 ;
+		OutStride = Bits ? ( K + 7 ) / 8 : N * OutSize ;
+	}
+
+	/*
+	 * output matrix of OutType
+	 * */
+	char *newLLR( mxArray **a, int r, int c ){
+		mxClassID oc = ( OutType == LLR_DOUBLE ) ? mxDOUBLE_CLASS : ( OutType == LLR_SINGLE ) ? mxSINGLE_CLASS : FP_CLASS ;
+
+		if( ( *a = mxCreateNumericMatrix( r, c, oc, mxREAL ) ) == NULL ){
+			mexErrMsgIdAndTxt("LDPCMSDecodeMEX:outputFail", "Allocating output matrix aLLR for MATLAB failed.") ;
+		}
+		return ( OutType == LLR_DOUBLE ) ? ( char * )mxGetDoubles( *a ) : ( OutType == LLR_SINGLE ) ? ( char * )mxGetSingles( *a ) : ( char * )GET_FP( *a ) ;
+	}
+
+	/*
+	 * channel LLRs of any supported class, sets InType and InSize
+	 * */
+	const void *getLLR( const mxArray *a ){
+		switch( mxGetClassID( a ) ){
+			case mxSINGLE_CLASS:
+				InType = LLR_SINGLE ;
+				InSize = sizeof( float ) ;
+				return mxGetSingles( a ) ;
+			case mxDOUBLE_CLASS:
+				InType = LLR_DOUBLE ;
+				InSize = sizeof( double ) ;
+				return mxGetDoubles( a ) ;
+			case mxINT16_CLASS:
+				InType = LLR_INT16 ;
+				InSize = sizeof( int16_t ) ;
+				return mxGetInt16s( a ) ;
+			case mxINT8_CLASS:
+				InType = LLR_INT8 ;
+				InSize = sizeof( int8_t ) ;
+				return mxGetInt8s( a ) ;
+			default:
+				return NULL ;
+		}
 	}
 	
 
 	void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
-		FP *llrch 	= NULL ;
-		FP *allr 	= NULL ;
-		WORD *hd 	= NULL ;
+		const char *llrch 	= NULL ;
+		char *allr 			= NULL ;
+		char *sys 			= NULL ;
+		WORD *hd 			= NULL ;
 
-		int i, n ;
+		int n ;
 		double *iter = NULL ;
 
+		mexAtExit( clearContext ) ;
+
+		if( nrhs == 0 && nlhs == 0 ){
+			clearContext() ;
+			return ;
+		}
+
 		if( nrhs != 2 ) {
 			mexErrMsgIdAndTxt("LDPCMSDecodeMEX:nrhs", "Two inputs required: channel LLR and options.") ;
 		}
 
 		if( nlhs < 2 || nlhs > 3 ) {
-			mexErrMsgIdAndTxt("LDPCMSDecodeMEX:nlhs", "Two or three outputs required: posterior LLR, nIter [,HD ] .") ;
+			mexErrMsgIdAndTxt("LDPCMSDecodeMEX:nlhs", "Two or three outputs required: posterior LLR ( or bits ), nIter [,HD ( or sysLLR ) ] .") ;
 		}
 		
-		if( mxGetClassID( prhs[ 0 ] ) != FP_CLASS ){
-			mexErrMsgIdAndTxt("LDPCMSDecodeMEX:notFP_CLASS", "The first input must be of FP type.") ;
+		if( mxIsComplex( prhs[ 0 ] ) || ( llrch = ( const char * )getLLR( prhs[ 0 ] ) ) == NULL ){
+			mexErrMsgIdAndTxt("LDPCMSDecodeMEX:notFP_CLASS", "The first input must be real single, double, int16 or int8.") ;
 		}
 		
-    	llrch 	= ( FP * ) GET_FP( prhs[ 0 ] ) ;
-		
 		n		= ( int ) mxGetM( prhs[ 0 ] ) ;
 		NChan	= ( int ) mxGetN( prhs[ 0 ] ) ;
 
+		if( n != N ){
+			mexErrMsgIdAndTxt("LDPCMSDecodeMEX:rows", "Number of rows not equal to compiled N.") ;
+		}
+
+		getOptions( prhs, 1 ) ;
+
 		HD = 0 ;
-		if( nlhs == 3 ){
+		if( nlhs == 3 && !Bits ){
 			HD = 1 ;
 			#ifdef BITMAP
 				No = NW ;
@@ -196,51 +380,46 @@ int decodeMT( FP *in, FP *out, double *ite, int n, int c, WORD *hd ){
 			}
 		}
 
-
-		if( n != N ){
-			mexErrMsgIdAndTxt("LDPCMSDecodeMEX:rows", "Number of rows not equal to compiled N.") ;
-		}
-
-		getOptions( prhs, 1 ) ;
-
 		dbg( 1, "Runtime params: LLCh size: %d x %d, NIter: %d, Lambda: %f, Beta: %f, Debug: %d, termination: %d, HD: %d\n", n, NChan, NIter, Lambda, Beta, Debug, Termination, HD ) ;
 
 		dbg( 1, "Compiled in params:\n  N: %d, K: %d, M: %d, Z: %d, NB: %d, KB: %d, MB: %d, G_MAX: %d, N_TH: %d \n", N, K, M, Z, NB, KB, MB, G_MAX, N_TH ) ;
 		
 		debugArray( 1, "HBM:", ( int * ) HBM, MB, NB, 3 ) ;
 
-		if( ( plhs[ 0 ] = mxCreateNumericMatrix( n, NChan, FP_CLASS, mxREAL ) ) == NULL ){
-			mexErrMsgIdAndTxt("LDPCMSDecodeMEX:outputFail", "Allocating output matrix aLLR for MATLAB failed.") ;
+		if( Bits ){
+			if( ( plhs[ 0 ] = mxCreateNumericMatrix( ( K + 7 ) / 8, NChan, mxUINT8_CLASS, mxREAL ) ) == NULL ){
+				mexErrMsgIdAndTxt("LDPCMSDecodeMEX:outputFail", "Allocating output matrix Bits for MATLAB failed.") ;
+			}
+			allr = ( char * )mxGetUint8s( plhs[ 0 ] ) ;
+			if( nlhs == 3 ){
+				sys = newLLR( &plhs[ 2 ], K, NChan ) ;
+			}
+		}else{
+			allr = newLLR( &plhs[ 0 ], n, NChan ) ;
 		}
 
 		if( ( plhs[ 1 ] = mxCreateDoubleMatrix( 1, NChan, mxREAL ) ) == NULL ){
 			mexErrMsgIdAndTxt("LDPCMSDecodeMEX:outputFail", "Allocating output vector iter for MATLAB failed.") ;
 		}
 
-		allr = ( FP * )GET_FP( plhs[ 0 ] ) ;
 		iter = mxGetDoubles( plhs[ 1 ] ) ;
 
-		MSInitDecoder( NIter, Lambda, Beta, Termination ) ;
+		initContext( NIter, Lambda, Beta, Termination ) ;
 
 
+		hd = HD ? ( WORD * )GET_UINTXY( plhs[ 2 ] ) : NULL ;
 		if( N_TH == 1 ){
-			dbg( 1, "Decoding single thread.\n") ;
-			for( i = 0 ; i < NChan ; i++ ){
-				iter[ i ] = ( double )MSDecode( llrch + i * N , allr + i * N, 1 ) ;
-			}
+			THREAD_ARGS a = { .idx = 0, .c = NChan, .in = llrch, .out = allr, .sys = sys, .hd = hd, .ite = iter } ;
 
-			if( HD ){
-				hd = ( WORD * )GET_UINTXY( plhs[ 2 ] ) ;
-				for( i = 0 ; i < NChan ; i++ ){
-					HardDecision( allr + i * N, hd + i * No, N ) ;
-				}
-			}
+			dbg( 1, "Decoding single thread.\n") ;
+			decodeColumns( &a ) ;
 		}else{
 			if( NChan % N_TH != 0 ){
 				mexErrMsgIdAndTxt("LDPCMSDecodeMEX:outputFail", "Nr. of columns must be dividible by nr. of threads.") ;
 			}
-			hd = HD ? ( WORD * )GET_UINTXY( plhs[ 2 ] ) : NULL ;
-			decodeMT( llrch, allr, iter, n, NChan, hd ) ;
+			if( decodeMT( llrch, allr, sys, iter, n, NChan, hd ) != 0 ){
+				mexErrMsgIdAndTxt("LDPCMSDecodeMEX:threadFail", "Starting the decoder threads failed.") ;
+			}
 		}
 
 	}
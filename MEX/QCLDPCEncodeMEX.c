@@ -55,11 +55,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 		Datawords is a column vector or matrix where data vectors 
 		are stored column-wise. 
 		The number of rows must be equal to (K * MWF) / WB  that is compiled in header file.
+		Codewords are returned whole: systematic part followed by parity part,
+		the output matrix is allocated only once and written directly by the encoder.
 		Options is a row vector of normal MATLAB veriables (int stored as double)
 		Options = [ Debuglevel, Method ]	
-		Method can also be used to run unit tests TODO		
+		Method: 0 > Annex G dual-diagonal procedure, 1 > generic block-circulant inverse
 */
 	
+	int Method = ENC_ANNEXG ;
+
 	void getOptions( const mxArray *prhs[], int i ){
 		double *opts 	= NULL ;
 		
@@ -70,14 +74,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 			mexErrMsgIdAndTxt("LDPCEncodeMEX:optsFail", "Options vector access failed.") ;
 		}
 		Debug 	= ( int )( opts[ 0 ] ) ;	// global variable defined in debug.cpp
+		Method	= ( int )( opts[ 1 ] ) ;
 	}
 	
 
 	void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
 		WORD *data 	= NULL ;
-		WORD *par 	= NULL ;
+		WORD *cw 	= NULL ;
 		
-		int chan, k, m, i ; 
+		int chan, k, n, i ; 
 		
 		if(  nrhs != 2 ) {
 			mexErrMsgIdAndTxt("LDPCEncodeMEX:nrhs", "Two inputs required: column uintXY vector or matrix and options.") ;
@@ -103,7 +108,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 		getOptions( prhs, 1 ) ;
 		
 		dbg( 1, "Compiled-in parameters:\n  N = %d, K = %d, M = %d, Z = %d, NB = %d, KB = %d, MB = %d\n", N, K, M, Z, NB, KB, MB ) ;
-		dbg( 1, "Runtime parameters:\n Data: %d rows , %d columns , Options: %d \n", k, chan, Debug ) ;
+		dbg( 1, "Runtime parameters:\n Data: %d rows , %d columns , Options: %d %d \n", k, chan, Debug, Method ) ;
+
+		if( !QCLDPCInitEncoder( Method ) ){
+			if( Method == ENC_GENERIC ){
+				mexErrMsgIdAndTxt("LDPCEncodeMEX:singular", "Generic encoder: parity part of H is not invertible.") ;
+			}else{
+				mexErrMsgIdAndTxt("LDPCEncodeMEX:notAnnexG", "Parity part of H is not dual-diagonal, use the generic encoder.") ;
+			}
+		}
 		
 		#ifdef BITMAP
 			if( K % WB != 0  || N % WB != 0 || M % WB != 0 || Z % WB != 0){
@@ -112,7 +125,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 			if( k != KW ){
 				mexErrMsgIdAndTxt("LDPCEncodeMEX:K", "BItmap encoder: runtime k different from compiled-in KW. Rebuild MEX file.") ;
 			}
-			m = MW ;
+			n = NW ;
 		#else
 			if( k != K ){
 				mexErrMsgIdAndTxt("LDPCEncodeMEX:K", "Array encoder: runtime k different from compiled-in K. Rebuild MEX file.") ;
@@ -120,21 +133,21 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 			if( !CheckEncoderInput( data, k, chan ) ){
 				mexErrMsgIdAndTxt("LDPCEncodeMEX:inputValuesFail", "Input not binary.") ;
 			} 
-			m = M ;
+			n = N ;
 		#endif
 
-		if( ( plhs[ 0 ] = mxCreateNumericMatrix( m, chan, UINTXY_CLASS, mxREAL ) ) == NULL ){
-			mexErrMsgIdAndTxt("LDPCEncodeMEX:outputFail", "Allocating output parity matrix for MATLAB failed.") ;
+		if( ( plhs[ 0 ] = mxCreateNumericMatrix( n, chan, UINTXY_CLASS, mxREAL ) ) == NULL ){
+			mexErrMsgIdAndTxt("LDPCEncodeMEX:outputFail", "Allocating output codeword matrix for MATLAB failed.") ;
 		}
-		par	= ( WORD * )GET_UINTXY( plhs[ 0 ] ) ;
+		cw	= ( WORD * )GET_UINTXY( plhs[ 0 ] ) ;
 
 		/*
-		dbg( 1, "Allocated output buffer of size: M x NChan: %d x %d\n", M, NChan ) ;
+		dbg( 1, "Allocated output buffer of size: N x NChan: %d x %d\n", N, NChan ) ;
 		debugArray( 1, "HBM:", ( int * ) HBM, MB, NB, 3 ) ;
 		*/
 
 		for( i = 0 ; i < chan ; i++ ){
-			QCLDPCEncode( data + k * i , par + m * i ) ;
+			QCLDPCEncodeCW( data + k * i , cw + n * i ) ;
 		}
 	}
 	
@@ -0,0 +1,250 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	dont forget build switch, the simulation engine always uses POSIX threads:
+	MEX: -lpthread
+*/
+
+#include <assert.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+#include "mex.h"
+#include "matrix.h"
+#include "ldpc.h"
+#include "debug.h"
+#include "encoder.h"
+#include "decoder.h"
+#include "rng.h"
+#include "demap.h"
+#include "sim.h"
+
+int NIter ;
+FP Lambda ;				// normalization factor, ignored in fixed-point implementation
+FP Beta ;				// offset, ignored in fixed-point implementation
+int Termination = 1 ;	// 1 > early, 0 > after all NIter
+int Method = ENC_ANNEXG ;
+uint32_t Point = 0 ;	// index of the first Eb/N0 point, selects the RNG stream
+
+SIM_PARAMS Sim ;
+
+#define NCNT 9	// nr. of counters returned per Eb/N0 point
+
+
+#ifdef MATLAB_MEX_FILE
+
+/*
+	MATLAB call: Cnt = QCLDPCSimMEX( EbN0, DecOptions, SimOptions [, CkptFile ] ) ;
+	Assuming:
+		EbN0 is a row vector of Eb/N0 points in dB
+		DecOptions = [ NIter, Lambda, Beta, Debuglevel, Termination ] same as QCLDPCDecodeMEX
+		SimOptions = [ Rate, MinErr, MaxFrames, BlkSize, Seed, Threads, EncMethod, Point, AllZero, RelCI, FerFloor, CkptPeriod, Qam, Demap ]
+			see sim.h for details, Point is the index of the first Eb/N0 point
+			RelCI > 0 runs one adaptive sweep over all points, MinErr is then ignored
+			optional trailing ones: CkptPeriod in seconds, default 60,
+			Qam bits per symbol, default 1 > BPSK, Demap 0 > max-log ( default ), 1 > exact
+		CkptFile is an optional checkpoint file name: an existing checkpoint of the same
+			configuration is resumed, the finished sweep stays in the file
+	Returns:
+		Cnt is a NCNT x numel( EbN0 ) matrix, one column per point:
+		[ bit errors ; frame errors ; frames ; sum of iterations ; wall-clock seconds ;
+		  BER lower ; BER upper ; FER lower ; FER upper ] bounds of 95 % confidence intervals
+*/
+
+	void getDecOptions( const mxArray *prhs[], int i ){
+		double *opts 	= NULL ;
+
+		if( !mxIsDouble( prhs[ i ] ) || mxIsComplex( prhs[ i ] ) || !( mxGetM( prhs[ i ] ) == 1 && mxGetN( prhs[ i ] ) == 5 ) ) {
+			mexErrMsgIdAndTxt("LDPCSimMEX:optsFail", "Decoder options vector not of size == [ 1, 5 ].") ;
+		}
+		if( ( opts = ( double * ) mxGetDoubles( prhs[ i ] ) ) == NULL ){
+			mexErrMsgIdAndTxt("LDPCSimMEX:optsFail", "Decoder options vector access failed.") ;
+		}
+		NIter 	= ( int )( opts[ 0 ] ) ;
+		Lambda	= ( FP )( opts[ 1 ] ) ;
+		Beta 	= ( FP )( opts[ 2 ] ) ;
+		Debug	= ( int )( opts[ 3 ] ) ;		//global variable Debug defined in debug.h
+		Termination = ( int )( opts[ 4 ] ) ;
+	}
+
+	void getSimOptions( const mxArray *prhs[], int i ){
+		double *opts 	= NULL ;
+
+		if( !mxIsDouble( prhs[ i ] ) || mxIsComplex( prhs[ i ] ) || !( mxGetM( prhs[ i ] ) == 1 && mxGetN( prhs[ i ] ) >= 11 && mxGetN( prhs[ i ] ) <= 14 ) ) {
+			mexErrMsgIdAndTxt("LDPCSimMEX:optsFail", "Simulation options vector not of size == [ 1, 11 .. 14 ].") ;
+		}
+		if( ( opts = ( double * ) mxGetDoubles( prhs[ i ] ) ) == NULL ){
+			mexErrMsgIdAndTxt("LDPCSimMEX:optsFail", "Simulation options vector access failed.") ;
+		}
+		Sim.rate		= opts[ 0 ] ;
+		Sim.minErr		= ( uint64_t )( opts[ 1 ] ) ;
+		Sim.maxFrames	= ( uint64_t )( opts[ 2 ] ) ;
+		Sim.blkSize		= ( int )( opts[ 3 ] ) ;
+		Sim.seed		= ( uint64_t )( opts[ 4 ] ) ;
+		Sim.threads		= ( int )( opts[ 5 ] ) ;
+		Method			= ( int )( opts[ 6 ] ) ;
+		Point			= ( uint32_t )( opts[ 7 ] ) ;
+		Sim.allZero		= ( int )( opts[ 8 ] ) ;
+		Sim.relCI		= opts[ 9 ] ;
+		Sim.ferFloor	= opts[ 10 ] ;
+		Sim.ckptPeriod	= mxGetN( prhs[ i ] ) > 11 ? opts[ 11 ] : 60.0 ;
+		Sim.qam			= mxGetN( prhs[ i ] ) > 12 ? ( int )( opts[ 12 ] ) : 1 ;
+		Sim.demap		= mxGetN( prhs[ i ] ) > 13 ? ( int )( opts[ 13 ] ) : DEMAP_MAXLOG ;
+	}
+
+	void report( const SIM_COUNTERS *c ){
+		dbg( 1, "Eb/N0: %.2lf errors: %llu frames: %llu\n", c->ebn0, ( unsigned long long )c->bitErr, ( unsigned long long )c->frames ) ;
+	}
+
+
+	void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+		SIM_COUNTERS *c	= NULL ;
+		SIM_CI ci ;
+		double *ebn0	= NULL ;
+		double *cnt		= NULL ;
+		char *ckpt		= NULL ;
+
+		int i, np, ret ;
+
+		if( nrhs != 3 && nrhs != 4 ) {
+			mexErrMsgIdAndTxt("LDPCSimMEX:nrhs", "Three inputs required: Eb/N0 vector, decoder options and simulation options, fourth optional: checkpoint file.") ;
+		}
+
+		if( nlhs != 1 ) {
+			mexErrMsgIdAndTxt("LDPCSimMEX:nlhs", "One output required: counters matrix.") ;
+		}
+
+		if( !mxIsDouble( prhs[ 0 ] ) || mxIsComplex( prhs[ 0 ] ) || mxGetM( prhs[ 0 ] ) != 1 ){
+			mexErrMsgIdAndTxt("LDPCSimMEX:ebn0", "Eb/N0 must be a real double row vector.") ;
+		}
+
+		ebn0	= mxGetDoubles( prhs[ 0 ] ) ;
+		np		= ( int ) mxGetN( prhs[ 0 ] ) ;
+
+		getDecOptions( prhs, 1 ) ;
+		getSimOptions( prhs, 2 ) ;
+		if( Sim.threads > MSThreads ){
+			mexErrMsgIdAndTxt("LDPCSimMEX:threads", "%d threads need a decoderMT.c build ( dec.nthread > 1 ), this one decodes in %d.", Sim.threads, MSThreads) ;
+		}
+
+		if( nrhs == 4 ){
+			if( !mxIsChar( prhs[ 3 ] ) || ( ckpt = mxArrayToString( prhs[ 3 ] ) ) == NULL ){
+				mexErrMsgIdAndTxt("LDPCSimMEX:ckpt", "Checkpoint file name must be a character vector.") ;
+			}
+		}
+		Sim.ckptFile	= ckpt ;
+		Sim.nIter		= NIter ;
+		Sim.norm		= ( double )Lambda ;
+		Sim.offset		= ( double )Beta ;
+
+		if( Sim.relCI > 0.0 ){
+			if( Sim.maxFrames == 0 && Sim.ferFloor <= 0.0 ){
+				mexErrMsgIdAndTxt("LDPCSimMEX:optsFail", "Adaptive sweep: either MaxFrames or FerFloor must be > 0.") ;
+			}
+		}else if( Sim.minErr == 0 && Sim.maxFrames == 0 ){
+			mexErrMsgIdAndTxt("LDPCSimMEX:optsFail", "Either MinErr or MaxFrames must be > 0.") ;
+		}
+		if( Sim.qam > 1 && !QamValid( Sim.qam ) ){
+			mexErrMsgIdAndTxt("LDPCSimMEX:optsFail", "Qam must be 1 ( BPSK ) or an even nr. of bits per symbol 2 .. %d.", QAM_MAX_BITS ) ;
+		}
+
+		dbg( 1, "Runtime params: points: %d, NIter: %d, Lambda: %f, Beta: %f, Debug: %d, termination: %d\n", np, NIter, Lambda, Beta, Debug, Termination ) ;
+		dbg( 1, "Simulation params: rate: %f, minErr: %llu, maxFrames: %llu, blkSize: %d, seed: %llu, threads: %d, encoder: %d\n",
+			Sim.rate, ( unsigned long long )Sim.minErr, ( unsigned long long )Sim.maxFrames, Sim.blkSize, ( unsigned long long )Sim.seed, Sim.threads, Method ) ;
+
+		if( ( plhs[ 0 ] = mxCreateDoubleMatrix( NCNT, np, mxREAL ) ) == NULL ){
+			mexErrMsgIdAndTxt("LDPCSimMEX:outputFail", "Allocating output counters matrix for MATLAB failed.") ;
+		}
+		cnt = mxGetDoubles( plhs[ 0 ] ) ;
+
+		MSInitDecoder( NIter, Lambda, Beta, Termination ) ;
+
+		if( !Sim.allZero && !QCLDPCInitEncoder( Method ) ){
+			if( Method == ENC_GENERIC ){
+				mexErrMsgIdAndTxt("LDPCSimMEX:singular", "Generic encoder: parity part of H is not invertible.") ;
+			}else{
+				mexErrMsgIdAndTxt("LDPCSimMEX:notAnnexG", "Parity part of H is not dual-diagonal, use the generic encoder.") ;
+			}
+		}
+
+		if( ( c = ( SIM_COUNTERS * )mxCalloc( np, sizeof( SIM_COUNTERS ) ) ) == NULL ){
+			mexErrMsgIdAndTxt("LDPCSimMEX:outputFail", "Allocating counters failed.") ;
+		}
+
+		for( i = 0 ; i < np ; i++ ){
+			c[ i ].ebn0		= ebn0[ i ] ;
+			c[ i ].point	= Point + ( uint32_t )i ;
+		}
+
+		if( ckpt != NULL ){
+			ret = SimLoadCheckpoint( &Sim, c, np ) ;
+			if( ret == -1 ){
+				mexErrMsgIdAndTxt("LDPCSimMEX:ckpt", "Checkpoint %s is corrupt.", ckpt ) ;
+			}
+			if( ret == -2 ){
+				mexErrMsgIdAndTxt("LDPCSimMEX:ckpt", "Checkpoint %s is from a different configuration.", ckpt ) ;
+			}
+			dbg( 1, "Checkpoint %s: %s\n", ckpt, ret == 1 ? "resumed" : "new" ) ;
+		}
+
+		if( SimRunSweep( &Sim, c, np, report ) != 0 ){
+			mexErrMsgIdAndTxt("LDPCSimMEX:simFail", "Simulation failed, check options, thread creation and checkpoint file.") ;
+		}
+
+		for( i = 0 ; i < np ; i++ ){
+			SimInterval( c + i, &ci ) ;
+
+			cnt[ i * NCNT + 0 ] = ( double )c[ i ].bitErr ;
+			cnt[ i * NCNT + 1 ] = ( double )c[ i ].frameErr ;
+			cnt[ i * NCNT + 2 ] = ( double )c[ i ].frames ;
+			cnt[ i * NCNT + 3 ] = ( double )c[ i ].iter ;
+			cnt[ i * NCNT + 4 ] = c[ i ].time ;
+			cnt[ i * NCNT + 5 ] = ci.berLo ;
+			cnt[ i * NCNT + 6 ] = ci.berHi ;
+			cnt[ i * NCNT + 7 ] = ci.ferLo ;
+			cnt[ i * NCNT + 8 ] = ci.ferHi ;
+		}
+
+		mxFree( c ) ;
+		if( ckpt != NULL ){
+			mxFree( ckpt ) ;
+		}
+	}
+#endif
@@ -0,0 +1,220 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "benchcmp.h"
+
+#define BC_LINE	4096	// max. length of a CSV line
+#define BC_COLS	64		// max. nr. of CSV columns
+
+//columns of the baseline, -1 > missing
+enum { C_LABEL = 0, C_N, C_Z, C_FP, C_NITER, C_EARLY, C_THREADS, C_EBN0, C_MBPS, C_RUNS, C_MBPS_SD, C_P99, C_P99_SD, C_ISA, C_SCHED, C_NR } ;
+
+static const char *ColName[ C_NR ] = { "label", "N", "Z", "fp", "nIter", "early", "threads", "ebn0", "mbps", "runs", "mbps_sd", "p99_us", "p99_sd", "isa", "sched" } ;
+
+static int split( char *line, char **f ) ;
+static int significant( double mb, double sb, int nb, double mc, double sc, int nc ) ;
+static double tQuantile95( double df ) ;
+
+
+//global functions definitions-------------------------------------------------
+
+int BenchLoadBaseline( const char *name, BENCH_ROW **rows ){
+	char line[ BC_LINE ], *f[ BC_COLS ] ;
+	int col[ C_NR ], i, j, nf, nr = 0, cap = 0 ;
+	BENCH_ROW *r = NULL, *t ;
+	FILE *fh ;
+
+	*rows = NULL ;
+	if( ( fh = fopen( name, "r" ) ) == NULL ){
+		printf( "Baseline FAIL: cannot read %s.\n", name ) ;
+		return -1 ;
+	}
+
+	//header: find the columns by name
+	if( fgets( line, sizeof( line ), fh ) == NULL ){
+		printf( "Baseline FAIL: %s is empty.\n", name ) ;
+		fclose( fh ) ;
+		return -1 ;
+	}
+	nf = split( line, f ) ;
+	for( i = 0 ; i < C_NR ; i++ ){
+		for( col[ i ] = -1, j = 0 ; j < nf ; j++ ){
+			if( strcmp( f[ j ], ColName[ i ] ) == 0 )
+				col[ i ] = j ;
+		}
+		if( col[ i ] < 0 && i <= C_MBPS ){
+			printf( "Baseline FAIL: %s has no column %s, not a benchmark CSV.\n", name, ColName[ i ] ) ;
+			fclose( fh ) ;
+			return -1 ;
+		}
+	}
+
+	while( fgets( line, sizeof( line ), fh ) != NULL ){
+		nf = split( line, f ) ;
+		if( nf <= col[ C_MBPS ] || strcmp( f[ 0 ], ColName[ 0 ] ) == 0 )	//empty line or a repeated header
+			continue ;
+
+		if( nr == cap ){
+			cap = cap ? 2 * cap : 64 ;
+			if( ( t = ( BENCH_ROW * )realloc( r, cap * sizeof( BENCH_ROW ) ) ) == NULL ){
+				free( r ) ;
+				fclose( fh ) ;
+				return -1 ;
+			}
+			r = t ;
+		}
+		t = r + nr++ ;
+		memset( ( void * )t, 0, sizeof( *t ) ) ;
+		snprintf( t->label, sizeof( t->label ), "%s", f[ col[ C_LABEL ] ] ) ;
+		snprintf( t->fp, sizeof( t->fp ), "%s", f[ col[ C_FP ] ] ) ;
+		t->n		= atoi( f[ col[ C_N ] ] ) ;
+		t->z		= atoi( f[ col[ C_Z ] ] ) ;
+		t->nIter	= atoi( f[ col[ C_NITER ] ] ) ;
+		t->early	= atoi( f[ col[ C_EARLY ] ] ) ;
+		t->threads	= atoi( f[ col[ C_THREADS ] ] ) ;
+		t->ebn0		= atof( f[ col[ C_EBN0 ] ] ) ;
+		t->mbps		= atof( f[ col[ C_MBPS ] ] ) ;
+		t->runs		= col[ C_RUNS ] >= 0 && col[ C_RUNS ] < nf ? atoi( f[ col[ C_RUNS ] ] ) : 1 ;
+		t->mbpsSd	= col[ C_MBPS_SD ] >= 0 && col[ C_MBPS_SD ] < nf ? atof( f[ col[ C_MBPS_SD ] ] ) : 0.0 ;
+		t->p99		= col[ C_P99 ] >= 0 && col[ C_P99 ] < nf ? atof( f[ col[ C_P99 ] ] ) : 0.0 ;
+		t->p99Sd	= col[ C_P99_SD ] >= 0 && col[ C_P99_SD ] < nf ? atof( f[ col[ C_P99_SD ] ] ) : 0.0 ;
+		if( col[ C_ISA ] >= 0 && col[ C_ISA ] < nf )
+			snprintf( t->isa, sizeof( t->isa ), "%s", f[ col[ C_ISA ] ] ) ;
+		if( col[ C_SCHED ] >= 0 && col[ C_SCHED ] < nf )
+			snprintf( t->sched, sizeof( t->sched ), "%s", f[ col[ C_SCHED ] ] ) ;
+		if( t->runs < 1 )
+			t->runs = 1 ;
+	}
+
+	fclose( fh ) ;
+	*rows = r ;
+	return nr ;
+}
+
+const BENCH_ROW *BenchFind( const BENCH_ROW *rows, int nr, const BENCH_ROW *key ){
+	int i ;
+
+	for( i = 0 ; i < nr ; i++ ){
+		if( strcmp( rows[ i ].label, key->label ) == 0 && strcmp( rows[ i ].fp, key->fp ) == 0
+			&& ( rows[ i ].isa[ 0 ] == '\0' || strcmp( rows[ i ].isa, key->isa ) == 0 )
+			&& ( rows[ i ].sched[ 0 ] == '\0' || strcmp( rows[ i ].sched, key->sched ) == 0 )
+			&& rows[ i ].n == key->n && rows[ i ].z == key->z && rows[ i ].nIter == key->nIter
+			&& rows[ i ].early == key->early && rows[ i ].threads == key->threads
+			&& fabs( rows[ i ].ebn0 - key->ebn0 ) < 0.005 )
+			return rows + i ;
+	}
+	return NULL ;
+}
+
+int BenchRegressed( const BENCH_ROW *base, const BENCH_ROW *cur, double thr, double *dMbps, double *dP99 ){
+	int flags = 0 ;
+
+	*dMbps	= base->mbps > 0.0 ? cur->mbps / base->mbps - 1.0 : 0.0 ;
+	*dP99	= base->p99 > 0.0 ? cur->p99 / base->p99 - 1.0 : 0.0 ;
+
+	if( *dMbps < -thr && significant( base->mbps, base->mbpsSd, base->runs, cur->mbps, cur->mbpsSd, cur->runs ) )
+		flags |= BCMP_THROUGHPUT ;
+
+	if( base->p99 > 0.0 && cur->p99 > 0.0 && *dP99 > thr
+		&& significant( cur->p99, cur->p99Sd, cur->runs, base->p99, base->p99Sd, base->runs ) )
+		flags |= BCMP_LATENCY ;
+
+	return flags ;
+}
+
+
+//local functions definitions---------------------------------------------------
+
+/*
+ * split a CSV line in place, no quoting: labels and names never contain commas
+ * */
+static int split( char *line, char **f ){
+	int n = 0 ;
+
+	line[ strcspn( line, "\r\n" ) ] = '\0' ;
+	if( line[ 0 ] == '\0' )
+		return 0 ;
+
+	f[ n++ ] = line ;
+	for( ; *line != '\0' && n < BC_COLS ; line++ ){
+		if( *line == ',' ){
+			*line = '\0' ;
+			f[ n++ ] = line + 1 ;
+		}
+	}
+	return n ;
+}
+
+/*
+ * one-sided Welch t-test at 95 %: mean mb is significantly larger than mc
+ * with a single run on both sides there is no variance estimate, the difference counts
+ * */
+static int significant( double mb, double sb, int nb, double mc, double sc, int nc ){
+	double vb, vc, se, df ;
+
+	vb = nb > 1 ? sb * sb / nb : 0.0 ;
+	vc = nc > 1 ? sc * sc / nc : 0.0 ;
+	se = sqrt( vb + vc ) ;
+	if( se <= 0.0 )
+		return mb > mc ;
+
+	//Welch-Satterthwaite degrees of freedom, a single-run side adds none
+	df = ( vb + vc ) * ( vb + vc ) / ( ( nb > 1 ? vb * vb / ( nb - 1 ) : 0.0 ) + ( nc > 1 ? vc * vc / ( nc - 1 ) : 0.0 ) ) ;
+
+	return mb - mc > tQuantile95( df ) * se ;
+}
+
+/*
+ * 95 % one-sided quantile of Student's t, table up to 30 degrees of freedom
+ * */
+static double tQuantile95( double df ){
+	static const double t[ 31 ] = { 6.314, 6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+		1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+		1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697 } ;
+	int d = ( int )floor( df ) ;
+
+	if( d > 30 )
+		return df > 120.0 ? 1.645 : 1.671 ;
+
+	return t[ d < 1 ? 1 : d ] ;
+}
@@ -0,0 +1,87 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Benchmark regression check: results of main ( -o csv, usually with -R runs )
+	are stored as a baseline, a later run is compared row by row.
+
+	A row is identified by label, FP type, kernel ISA, layer schedule, N, Z,
+	nIter, early termination, threads and Eb/N0; baselines without the isa
+	or sched column match any ISA or schedule. It regressed if its mean throughput dropped, or its
+	mean p99 latency grew, by more than the threshold AND the change is
+	significant: one-sided Welch t-test at 95 % over the runs of both sides.
+	With a single run on both sides only the threshold applies.
+*/
+
+#ifndef QCLDPCBENCHCMP
+#define QCLDPCBENCHCMP
+
+#define BCMP_THROUGHPUT	1	// BenchRegressed() flags
+#define BCMP_LATENCY	2
+
+typedef struct bench_row {
+	char		label[ 64 ] ;
+	char		fp[ 8 ] ;
+	char		isa[ 8 ] ;		// kernels, see kernel.h, "" > any
+	char		sched[ 8 ] ;	// layer schedule, see KernelSchedule(), "" > any
+	int			n, z, nIter, early, threads ;
+	double		ebn0 ;
+	int			runs ;
+	double		mbps, mbpsSd ;	// throughput, mean and std. deviation over runs
+	double		p99, p99Sd ;	// p99 latency of all frames in us, mean and std. deviation over runs
+} BENCH_ROW ;
+
+/*
+	read a baseline CSV written by main -o csv, columns are found by the header,
+	runs, mbps_sd, p99_us, p99_sd, isa and sched are optional ( older reports: 1 run,
+	any ISA and schedule )
+	returns the nr. of rows in *rows ( free() it ), -1 on error
+*/
+extern int BenchLoadBaseline( const char *name, BENCH_ROW **rows ) ;
+
+//	baseline row of the same code, variant and Eb/N0 as key, NULL if there is none
+extern const BENCH_ROW *BenchFind( const BENCH_ROW *rows, int nr, const BENCH_ROW *key ) ;
+
+/*
+	compare cur to base, thr is the relative threshold e.g. 0.05,
+	dMbps and dP99 get the relative changes ( negative dMbps, positive dP99 > worse )
+	returns BCMP_THROUGHPUT | BCMP_LATENCY of the regressions, 0 > none
+*/
+extern int BenchRegressed( const BENCH_ROW *base, const BENCH_ROW *cur, double thr, double *dMbps, double *dP99 ) ;
+
+#endif
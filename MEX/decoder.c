@@ -53,98 +53,56 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <float.h>
 #include "decoder.h"
+#include "kernel.h"
 #include "debug.h"
 
 #define sign( x ) ( ( x ) < 0 ? 1U : 0U )
-#define mag( x )  ( ( x ) >= 0 ? ( x ) : -( x ) )
-#define max( x, y ) ( ( x ) > ( y ) ? ( x ) : ( y ) )
+
+const int MSThreads = 1 ;		// single decoder state, t is ignored
 
 //run-time global parameters supplied by MATLAB
 static int 	NIter 		= 0 ;		//number of iterations
 static FP 	Lambda		= 1.0 ;		//normalization factor
 static FP 	Beta  		= 0.0 ;		//offset
 static int 	Termination = 1 ;		// 1 > terminate when converged, 0 > allways do all iterations
+static int 	Converged	= 0 ;		// 1 > the last decoded codeword satisfies all checks
+static int 	ConvergedB[ F_B ] ;		// Converged of the columns of the last batch
 
 
-//indices to H matrix for easy access:
-static int8_t 	CH_S[ M ] ;				//actual N(m) sizes for each check
-static int16_t 	CH_IND[ M ][ G_MAX ] ;	//absolute indices of variables for each check
-
 static FP ZNold[ N ] ;				// aka Zn(k-1)
 
 static FP ZT[ MB ][ N ] ;			//temporary sums Znew for each tier
 
-static FP ZNnew[ N ] ;				// aka Zn(k)
+static FP ZR[ 2 * N ] ;				// Zn(k-1) in the rotation layout of layerMinSum
 static WORD HD[ N ] ;
-
-static FP *Zold = NULL ;
-static FP *Znew = NULL ;
+static FP LLin[ N ] ;				//channel LLRs converted by MSDecodeT()
 
 //storing Lmn(k) values:
-static FP LM[ M ][ 2 ] ;			//2 minimal magnitude values for all checks
+static FP LM[ 2 ][ M ] ;			//2 minimal magnitude values for all checks
 static uint32_t LS[ M ] ; 			//signs of all N(m) elements for all checks stored as a bitmap
 static uint8_t LI[ M ] ;			//relative index of minimal magnitude variable for all checks
 
-//local functions
-static int orthogonal( void ) ;
-static void checkMinSum( int m, int mb, int iter ) ;
-static void initCheckIndices( void ) ;
-
-static void sumTiers( void ) ;
+#ifdef BITMAP
+	#define HD_WORDS NW		//hard decision of a frame in WORDs
+#else
+	#define HD_WORDS N
+#endif
 
-static unsigned getSign( uint32_t signBuf, int index ) ;
-static unsigned setSign( uint32_t signBuf, unsigned bit, int index ) ;
+//local functions
+static int iterate( const FP *LLch ) ;
 
 
 //global functions definitions-------------------------------------------------
 
-/*
- * retrieve an unsigned signum value from a bitmap
- * */
-static unsigned getSign( uint32_t signBuf, int index){
-	unsigned sign ;
-
-	assert( index < G_MAX ) ;
-
-	sign = ( signBuf >> index ) & 1U  ;
-
-	assert( sign == 1U || sign == 0U ) ;
-
-	return sign ;
-}
-
-/*
- * store a sign bit to bitmap storage
- * returns updated bitmap
- * */
-static unsigned setSign( uint32_t signBuf, unsigned bit, int index ){
-
-	assert( bit == 0U || bit == 1U ) ;
-
-	if( bit == 0U ){
-		//clear bit
-		signBuf &= ~( 1U << index ) ;
-	} else {
-		//set bit
-		signBuf |= ( 1U << index ) ;
-	}
-
-	return signBuf ;
-}
-
-
 void MSInitDecoder( int niter, FP norm, FP offset, int termination ){
 	NIter 		= niter ;
 	Lambda 		= norm ;
 	Beta 		= offset ;
 	Termination = termination ;
 
-	Zold 	= ZNold ;
-	Znew 	= ZNnew ;
-	
 	dbg( 1, "NITer: %d, Lambda: %f, Beta: %f \n", NIter, Lambda, Beta ) ;
 
-	initCheckIndices() ;
+	KernelInit() ;
 }
 
 /*
@@ -155,85 +113,111 @@ void MSInitDecoder( int niter, FP norm, FP offset, int termination ){
 * returns: number of iterations if decode converged, 0 otherwise, -1 on error
 */
 int MSDecode( FP *LLch, FP *ApLLR, int t ){
-	int iter, m, n, mb ;
-	FP *tmp ;
+	int iter ;
 
-	memset( ( void * )LM, 0U, sizeof( LM ) ) ;
-	memset( ( void * )LS, 0U, sizeof( LS ) ) ;
-	memset( ( void * )LI, 0U, sizeof( LI ) ) ;
-	
 	memcpy( ( void * )ZNold, ( void * )LLch, sizeof( ZNold ) ) ;
+	iter = iterate( LLch ) ;
+	memcpy( ( void * )ApLLR, ( const void * )ZNold, N * sizeof( FP ) ) ;
 
-	assert( sizeof( ZNold ) == N * sizeof( FP ) ) ;
-	assert( sizeof( ZNnew ) == sizeof( ZNold ) ) ;
-
-	Zold = ZNold ;
-	Znew = ZNnew ;
+	return iter ;
+}
 
-	memset( ( void * )ZT, 0U, sizeof( ZT ) ) ;
+/*
+ * MSDecode() of LLch of type tin, converted while loading ZNold, posteriors stored as tout
+ * */
+int MSDecodeT( const void *LLch, int tin, void *ApLLR, int tout, WORD *hd, int t ){
+	int iter ;
 
-	for( iter = 0 ; iter < NIter ; iter++ ){
+	Kern.loadLLR( LLch, tin, 1.0f, LLin, ZNold ) ;
+	iter = iterate( LLin ) ;
+	Kern.storeLLR( ZNold, ApLLR, tout, N ) ;
 
-		memcpy( ( void * )Znew, ( void * )LLch, sizeof( ZNnew ) ) ;
+	if( hd != NULL ){
+		HardDecision( ZNold, hd, N ) ;
+	}
+	return iter ;
+}
 
-		for( mb = 0 ; mb < MB ; mb++ ){
-			memcpy( ( void * )Znew, ( void * )LLch, sizeof( ZNnew ) ) ;
-			memset( ( void * )ZT[ mb ], 0U, sizeof( ZT[ mb ] ) ) ;
+/*
+ * MSDecodeT() for the data only: K systematic hard decisions packed straight from the
+ * final posteriors, their ApLLR only if sys is not NULL
+ * */
+int MSDecodeBits( const void *LLch, int tin, uint8_t *bits, void *sys, int tout, int t ){
+	int iter ;
 
-			for( m = 0 ; m < Z ; m++ ){
-				checkMinSum( Z * mb + m, mb, iter ) ; //updates ZT for current tier
-			}
+	Kern.loadLLR( LLch, tin, 1.0f, LLin, ZNold ) ;
+	if( ( iter = iterate( LLin ) ) < 0 ){
+		return iter ;
+	}
+	Kern.packBits( ZNold, bits, K ) ;
 
-			sumTiers( ) ;	//carefull - tiers from previous iteration are also used
+	if( sys != NULL ){
+		Kern.storeLLR( ZNold, sys, tout, K ) ;
+	}
+	return iter ;
+}
 
-			memcpy( ( void * )Zold, ( void * )Znew, sizeof( ZNnew ) ) ;
-		}
-		
-		if( iter == 0 ) {
-			assert( Znew == ZNnew ) ;
-		}
+/*
+ * MSDecodeT() of f consecutive columns, one after another
+ * */
+int MSDecodeBatchT( const void *LLch, int tin, void *ApLLR, int tout, WORD *hd, int f, int *iter, int t ){
+	int j ;
 
-		for( n = 0 ; n < N ; n++ ){
-			HD[ n ] = sign( Znew[ n ] ) ;  
-		}
+	if( f < 1 || f > F_B ){
+		return -3 ;
+	}
+	for( j = 0 ; j < f ; j++ ){
+		iter[ j ] = MSDecodeT( ( const char * )LLch + ( size_t )j * N * LLR_SIZE( tin ), tin, ( char * )ApLLR + ( size_t )j * N * LLR_SIZE( tout ), tout,
+			( hd == NULL ) ? NULL : hd + ( size_t )j * HD_WORDS, t ) ;
+		ConvergedB[ j ] = Converged ;
+	}
+	return 0 ;
+}
 
-		if( orthogonal( ) ){
-			memcpy( ( void * )ApLLR, ( const void * )Znew, N * sizeof( FP ) ) ;
-			if( Termination ){
-				return iter + 1 ;
-			}
-		}
+/*
+ * MSDecodeBits() of f consecutive columns, one after another
+ * */
+int MSDecodeBatchBits( const void *LLch, int tin, uint8_t *bits, void *sys, int tout, int f, int *iter, int t ){
+	int j ;
 
-		tmp = Zold ;
-		Zold = Znew ;
-		Znew = tmp ;
+	if( f < 1 || f > F_B ){
+		return -3 ;
+	}
+	for( j = 0 ; j < f ; j++ ){
+		iter[ j ] = MSDecodeBits( ( const char * )LLch + ( size_t )j * N * LLR_SIZE( tin ), tin, bits + ( size_t )j * ( ( K + 7 ) / 8 ),
+			( sys == NULL ) ? NULL : ( char * )sys + ( size_t )j * K * LLR_SIZE( tout ), tout, t ) ;
+		ConvergedB[ j ] = Converged ;
 	}
+	return 0 ;
+}
 
-	memcpy( ( void * )ApLLR, ( const void * )Zold, N * sizeof( FP ) ) ;
-	return iter ;
+/*
+ * 1 if the hard decision of the last MSDecode() satisfies all checks, 0 otherwise
+ * */
+int MSConverged( int t ){
+	return Converged ;
 }
 
 /*
- * convert LLR values to bits
- *
- * TODO: this will not work if WORD is wider than unsigned eg. 64 bit wide WORD
+ * MSConverged() of column j of the last batch
  * */
-void HardDecision( FP *LLr, WORD *CW, int el ) {
-	int i, wi, ii ;
+int MSConvergedBatch( int t, int j ){
+	return ConvergedB[ j ] ;
+}
 
-	assert( sizeof( WORD ) <= sizeof( unsigned ) ) ;
+/*
+ * convert LLR values to bits, a bitmap of whole WORDs packed by the sign kernel
+ * */
+void HardDecision( FP *LLr, WORD *CW, int el ) {
+	#ifndef BITMAP
+		int i ;
 
-	for( i = 0 ; i < el ; i++ ){
-		#ifndef BITMAP
+		for( i = 0 ; i < el ; i++ )
 			CW[ i ] = sign( LLr[ i ] ) ;
-		#else
-			assert( el % WB == 0 ) ;
-			wi = i / WB ;
-			ii = i % WB ;
-			CW[ wi ] = setSign( CW[ wi ], sign( LLr[ i ] ), WB - ii - 1 ) ;
-		#endif
-
-	}
+	#else
+		assert( el % WB == 0 ) ;
+		Kern.signBitmap( LLr, CW, el ) ;
+	#endif
 }
 
 /*
@@ -266,159 +250,51 @@ int Orthogonal( WORD *CW, int t ) {
 	if( CW != HD )
 		memcpy( ( void * )HD, (void *)CW, N * sizeof( WORD ) ) ;
 
-	return orthogonal() ;
+	return Kern.orthogonal( HD ) ;
 }
 
 //local functions definitions---------------------------------------------------
 
 /*
- * sum the tiers for layered decoding
- * carefull: ZT values from previous iteration are also used
+ * the iterations of MSDecode(), ZNold already holds LLch, the posteriors end there,
+ * the layers read them from their copy in the rotation layout ZR
  * */
-static void sumTiers( void ){
-	int n, mb ;
-
-	for( mb = 0 ; mb < MB ; mb++ ){
-		for( n = 0 ;  n < N ; n++ ){
-			Znew[ n ] += ZT[ mb ][ n ] ;
-		}
-	}
-}
-
-
-static void checkMinSum( int m, int mb, int iter ){
-	FP min1 = FP_MAX ;
-	FP min2 = FP_MAX ;
-	FP zmn, lmn, a, tmp ;
+static int iterate( const FP *LLch ){
+	int iter, l, mb ;
 
-	int i, n, midx ;
-	unsigned s, sgnPrd = 0U ;
-
-	//finds the updated minimums
+	memset( ( void * )LM, 0U, sizeof( LM ) ) ;
+	memset( ( void * )LS, 0U, sizeof( LS ) ) ;
+	memset( ( void * )LI, 0U, sizeof( LI ) ) ;
 
-	for( i = 0 ; i < CH_S[ m ] ; i++ ){
-		n = CH_IND[ m ][ i ] ;
+	assert( sizeof( ZNold ) == N * sizeof( FP ) ) ;
+	assert( sizeof( ZR ) == 2 * sizeof( ZNold ) ) ;
 
-		if( iter == 0 ){
-			//in first iteration just read the channel values, and no subtraction
-			zmn = Zold[ n ] ;
-		}else{
-			//reconstruct old values from compressed form
-			a = ( ( i == LI[ m ] ) ? LM[ m ][ 1 ] : LM[ m ][ 0 ] ) ;
+	memset( ( void * )ZT, 0U, sizeof( ZT ) ) ;
+	Converged = 0 ;
+	Kern.rotateLayout( ZNold, ZR ) ;
 
-			s 	= getSign( LS[ m ], i ) ;
+	for( iter = 0 ; iter < NIter ; iter++ ){
 
-			#ifndef FIXED
-				tmp = ( s ? -1.0f : 1.0f ) * a ;
-			#else
-				tmp = ( s ? -a : a ) ;
-			#endif
+		for( l = 0 ; l < MB ; l++ ){
+			mb = KOrder[ l ] ;
+			memcpy( ( void * )ZNold, ( const void * )LLch, sizeof( ZNold ) ) ;
+			memset( ( void * )ZT[ mb ], 0U, sizeof( ZT[ mb ] ) ) ;
 
-			zmn = Zold[ n ] - tmp  ; 			// Eq. (3) subtraction
+			//updates ZT for current tier
+			Kern.layerMinSum( mb, iter, ZR, ZT[ mb ], LM[ 0 ] + Z * mb, LM[ 1 ] + Z * mb, LS + Z * mb, LI + Z * mb, Lambda, Beta ) ;
 
-		}
+			Kern.sumTiers( ZNold, ZT[ 0 ] ) ;	//carefull - tiers from previous iteration are also used
 
-		//compute two minimal values in array Lmn
-		s = sign( zmn ) ;
-		a = mag( zmn ) ;
-
-		LS[ m ] = setSign( LS[ m ], s, i ) ;
-		sgnPrd  ^= s ;
-
-		if( a <= min1 ){
-			min2 = min1 ;
-			min1 = a ;
-			midx = i ;
-		}else{
-			if( a < min2 ){
-				min2 = a ;
-			}
+			Kern.rotateLayout( ZNold, ZR ) ;
 		}
-	}
-
-	LM[ m ][ 0 ] = min1 ;
-	LM[ m ][ 1 ] = min2 ;
-	LI[ m ] = midx ;
-
-	//calculate extrinsic messages
-	for( i = 0 ; i < CH_S[ m ] ; i++ ){
-			n = CH_IND[ m ][ i ] ;
-			a = ( ( i == midx ) ? min2 : min1 ) ;
-
-			s = getSign( LS[ m ], i ) ^ sgnPrd ;
-
-			#ifndef FIXED
-				lmn = Lambda * ( s ? -1.0f : 1.0f ) * max( a - Beta, 0.0f ) ;
-			#else
-				lmn = s ? -a : a ;
-			#endif
 
-			LS[ m ] = setSign( LS[ m ], sign( lmn ), i ) ;
-			ZT[ mb ][ n ] = lmn ; // assuming max column weight == 1 foir each tier
-	}
-
-}
-
-static int orthogonal( void ){
-	int m, i ;
-	unsigned sum, b ;
+		Kern.hardDecision( ZNold, HD ) ;
 
-	for( m = 0 ; m < M ; m++ ){
-		sum = 0U ;
-		for( i = 0 ; i < CH_S[ m ] ; i++ ){
-			b = HD[ CH_IND[ m ][ i ] ] ; 
-			sum ^= b ;
-		}
-		if( sum != 0 ){
-			dbg( 2, "ORT: CH %d FAILED, sum(m): %d \n", m, sum ) ;
-			return 0 ;
+		Converged = Kern.orthogonal( HD ) ;
+		if( Converged && Termination ){
+			return iter + 1 ;
 		}
 	}
 
-	dbg( 2, "WORD ORTHOGONAL\n") ;
-
-	return 1 ;
-}
-
-/*
-initialize CH_S and CH_IND based on the HBM matrix
-	assuming HB is already scaled
-*/
-
-static void initCheckIndices( void ) {
-		int r, c ; 		//indices to the block model matrix
-		int shift, offx, offy ;
-		int k ; 		//relative index inside the submatrix
-		int row, col ; 	//absolute indices to the binary H matrix
-
-		memset( ( void * )CH_S, 0, M * sizeof( int8_t ) ) ;
-
-		for( r = 0 ; r < MB ; r++ ){
-			offy = r * Z ;
-			for( c = 0 ; c < NB ; c++ ){
-				offx = c * Z ;
-				shift = HBM[ r ][ c ] ;
-				if( shift == -1 ){
-					continue ;
-				}
-				assert( shift >= 0 && shift < Z ) ;
-
-				for( k = 0 ; k < Z ; k++ ){
-
-					col = offx + k ;
-					row = ( ( k + Z - shift ) % Z ) + offy ;
-	
-					CH_IND[ row ][ CH_S[ row ] ] = col ;
-					CH_S[ row ] += 1 ;
-
-					assert( row >= 0 && row < M ) ;
-					assert( col >= 0 && col < N ) ;
-					assert( col < INT16_MAX ) ;
-					assert( CH_S[ row ] <= NB ) ;
-				}
-			}
-		}
-
+	return iter ;
 }
-
-
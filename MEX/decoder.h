@@ -45,15 +45,55 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef QCLDPCDEC
 #define QCLDPCDEC
 
+#ifndef F_B
+	#define F_B 1	// frames per thread decoded together, see saveLDPCheader(), for older ldpc.h
+#endif
+
 // initialize decoder parameters and index arrays
 extern void MSInitDecoder( int niter, FP norm, FP offset, int termination ) ;
 
+// 	 threads t = 0 .. MSThreads - 1 with decoder state of their own: 1 in decoder.c, N_TH in decoderMT.c
+extern const int MSThreads ;
+
 /*
- 	 actuall layered single-scan min-sum
+ 	 actuall layered single-scan min-sum, layers in the order of KOrder ( kernel.h )
  	 t is only used in multithreaded implementation
  */
 extern int MSDecode( FP *LLch, FP *ApLLR, int t ) ;
 
+/*
+	MSDecode() of channel LLRs of type tin ( LLR_SINGLE .. LLR_INT8 of kernel.h ) converted while
+	they are loaded, no FP copy of the block, posteriors stored as tout ( LLR_SINGLE, LLR_DOUBLE,
+	LLR_INT16 for the fixed point decoder ), hard decision to hd if not NULL
+	fixed point: floats are quantized like float2int( LLch, QB, FP_MAX ), integers taken as they are
+*/
+extern int MSDecodeT( const void *LLch, int tin, void *ApLLR, int tout, WORD *hd, int t ) ;
+
+/*
+	bits-only MSDecodeT(): the K systematic hard decisions packed MSB first to bits
+	( ( K + 7 ) / 8 bytes ) straight from the final posteriors, no N posteriors are copied,
+	the K systematic ApLLR to sys as tout only if sys is not NULL
+*/
+extern int MSDecodeBits( const void *LLch, int tin, uint8_t *bits, void *sys, int tout, int t ) ;
+
+/*
+	MSDecodeT() and MSDecodeBits() of 1 .. F_B consecutive columns ( N LLRs, N posteriors or
+	( K + 7 ) / 8 bytes and K sys, hd of N or NW ( BITMAP ) WORDs ) by thread t: decoderMT.c decodes
+	a layer of all f frames before the next one, a frame leaves the batch when it converges,
+	decoder.c one frame after another; iterations of column j to iter[ j ], returns 0, < 0 on error
+*/
+extern int MSDecodeBatchT( const void *LLch, int tin, void *ApLLR, int tout, WORD *hd, int f, int *iter, int t ) ;
+extern int MSDecodeBatchBits( const void *LLch, int tin, uint8_t *bits, void *sys, int tout, int f, int *iter, int t ) ;
+
+/*
+	1 if the last MSDecode() converged to a codeword, also without early termination
+	t is only used in multithreaded implementation
+*/
+extern int MSConverged( int t ) ;
+
+// 	 MSConverged() of column j of the last batch of thread t
+extern int MSConvergedBatch( int t, int j ) ;
+
 // 	 el is the number of codewords in block
 extern void HardDecision( FP *LLr, WORD *CW, int el ) ;
 
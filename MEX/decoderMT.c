@@ -53,11 +53,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <float.h>
 #include "decoder.h"
+#include "kernel.h"
 #include "debug.h"
 
 #define sign( x ) ( ( x ) < 0 ? 1U : 0U )
-#define mag( x )  ( ( x ) >= 0 ? ( x ) : -( x ) )
-#define max( x, y ) ( ( x ) > ( y ) ? ( x ) : ( y ) )
+
+const int MSThreads = N_TH ;		// decoder state of every thread
 
 //run-time global parameters supplied by MATLAB
 static int 	NIter 		= 0 ;		//number of iterations
@@ -65,72 +66,37 @@ static FP 	Lambda		= 1.0 ;		//normalization factor
 static FP 	Beta  		= 0.0 ;		//offset
 static int 	Termination = 1 ;		// 1 > terminate when converged, 0 > allways do all iterations
 
+//decoder state of one frame per slot, the F_B frames of thread t decoded together use slots t F_B ..
+#define SLOTS ( N_TH * F_B )
 
-//indices to H matrix for easy access:
-static int8_t  	CH_S[ M ] ;				//actual N(m) sizes for each check
-static int16_t  CH_IND[ M ][ G_MAX ] ;	//absolute indices of variables for each check
+static int 	Converged[ SLOTS ] ;	// 1 > the last codeword decoded in a slot satisfies all checks
 
-static FP ZNold[ N_TH ][ N ] ;		// aka Zn(k-1)
 
-static FP ZT[ N_TH ][ MB ][ N ] ;	//temporary sums Znew for each tier
+static FP ZNold[ SLOTS ][ N ] ;		// aka Zn(k-1)
 
-static FP ZNnew[ N_TH ][ N ] ;		// aka Zn(k)
-static WORD HD[ N_TH ][ N ] ;
+static FP ZT[ SLOTS ][ MB ][ N ] ;	//temporary sums Znew for each tier
 
-//storing Lmn(k) values:
-static FP LM[ N_TH ][ M ][ 2 ] ;				//2 minimal magnitude values for all checks
-static uint32_t LS[ N_TH ][ M ] ; 			//signs of all N(m) elements for all checks stored as a bitmap
-static uint8_t LI[ N_TH ][ M ] ;					//relative index of minimal magnitude variable for all checks
+static FP ZR[ SLOTS ][ 2 * N ] ;	// Zn(k-1) in the rotation layout of layerMinSum
+static WORD HD[ SLOTS ][ N ] ;
+static FP LLin[ SLOTS ][ N ] ;		//channel LLRs of the frame
 
-//local functions
-static int orthogonal( int t ) ;
-static void checkMinSum( int m, int mb, int iter, int t, FP *zold ) ;
-static void initCheckIndices( void ) ;
+//storing Lmn(k) values:
+static FP LM[ SLOTS ][ 2 ][ M ] ;				//2 minimal magnitude values for all checks
+static uint32_t LS[ SLOTS ][ M ] ; 			//signs of all N(m) elements for all checks stored as a bitmap
+static uint8_t LI[ SLOTS ][ M ] ;					//relative index of minimal magnitude variable for all checks
 
-static void sumTiers( int t, FP *znew ) ;
+#ifdef BITMAP
+	#define HD_WORDS NW		//hard decision of a frame in WORDs
+#else
+	#define HD_WORDS N
+#endif
 
-static unsigned getSign( uint32_t signBuf, int index ) ;
-static unsigned setSign( uint32_t signBuf, unsigned bit, int index ) ;
+//local functions
+static int iterate( int s, int f, int *iter ) ;
 
 
 //global functions definitions-------------------------------------------------
 
-/*
- * retrieve an unsigned signum value from a bitmap
- * */
-static unsigned getSign( uint32_t signBuf, int index){
-	unsigned sign ;
-
-	assert( index < G_MAX ) ;
-
-	sign = ( signBuf >> index ) & 1U  ;
-
-	assert( sign == 1U || sign == 0U ) ;
-
-	return sign ;
-}
-
-/*
- * store a sign bit to bitmap storage
- * returns updated bitmap
- * */
-static unsigned setSign( uint32_t signBuf, unsigned bit, int index ){
-
-	assert( index < G_MAX ) ;
-	assert( bit == 0U || bit == 1U ) ;
-
-	if( bit == 0U ){
-		//clear bit
-		signBuf &= ~( 1U << index ) ;
-	} else {
-		//set bit
-		signBuf |= ( 1U << index ) ;
-	}
-
-	return signBuf ;
-}
-
-
 void MSInitDecoder( int niter, FP norm, FP offset, int termination ){
 	NIter 		= niter ;
 	Lambda 		= norm ;
@@ -139,7 +105,7 @@ void MSInitDecoder( int niter, FP norm, FP offset, int termination ){
 
 	dbg( 1, "NITer: %d, Lambda: %f, Beta: %f \n", NIter, Lambda, Beta ) ;
 
-	initCheckIndices() ;
+	KernelInit() ;
 }
 
 
@@ -151,89 +117,121 @@ void MSInitDecoder( int niter, FP norm, FP offset, int termination ){
 * returns: number of iterations if decode converged, 0 otherwise, -1 on error
 */
 int  MSDecode( FP *LLch, FP *ApLLR, int t ){
-	int iter, m, n, mb ;
-	FP *tmp, *Zold, *Znew ;
-
-	memset( ( void * )LM[ t ], 0U, sizeof( LM[ t ] ) ) ;
-	memset( ( void * )LS[ t ], 0U, sizeof( LS[ t ] ) ) ;
-	memset( ( void * )LI[ t ], 0U, sizeof( LI[ t ] ) ) ;
-	
-	memcpy( ( void * )ZNold[ t ], ( void * )LLch, sizeof( ZNold[ t ] ) ) ;
+	const int s = t * F_B ;
+	int iter, r ;
 
-	if( sizeof( ZNold[ t ] ) != N * sizeof( FP ) ){
-		return -1 ;
-	}
-	if( sizeof( ZNnew[ t ] ) != sizeof( ZNold[ t ] ) ) {
-		return -2 ;
+	memcpy( ( void * )LLin[ s ], ( void * )LLch, sizeof( LLin[ s ] ) ) ;
+	memcpy( ( void * )ZNold[ s ], ( void * )LLch, sizeof( ZNold[ s ] ) ) ;
+	if( ( r = iterate( s, 1, &iter ) ) < 0 ){
+		return r ;
 	}
+	memcpy( ( void * )ApLLR, ( const void * )ZNold[ s ], N * sizeof( FP ) ) ;
 
-	Zold = ZNold[ t ] ;
-	Znew = ZNnew[ t ] ;
-
-	memset( ( void * )ZT[ t ], 0U, sizeof( ZT[ t ] ) ) ;
+	return iter ;
+}
 
-	for( iter = 0 ; iter < NIter ; iter++ ){
+/*
+ * MSDecode() of LLch of type tin, converted while loading ZNold, posteriors stored as tout
+ * */
+int MSDecodeT( const void *LLch, int tin, void *ApLLR, int tout, WORD *hd, int t ){
+	int iter, r ;
 
-		memcpy( ( void * )Znew, ( void * )LLch, sizeof( ZNnew[ t ] ) ) ;
+	if( ( r = MSDecodeBatchT( LLch, tin, ApLLR, tout, hd, 1, &iter, t ) ) < 0 ){
+		return r ;
+	}
+	return iter ;
+}
 
-		for( mb = 0 ; mb < MB ; mb++ ){
-			memcpy( ( void * )Znew, ( void * )LLch, sizeof( ZNnew[ t ] ) ) ;
-			memset( ( void * )ZT[ t ][ mb ], 0U, sizeof( ZT[ t ][ mb ] ) ) ;
+/*
+ * MSDecodeT() for the data only: K systematic hard decisions packed straight from the
+ * final posteriors, their ApLLR only if sys is not NULL
+ * */
+int MSDecodeBits( const void *LLch, int tin, uint8_t *bits, void *sys, int tout, int t ){
+	int iter, r ;
 
-			for( m = 0 ; m < Z ; m++ ){
-				checkMinSum( Z * mb + m, mb, iter, t, Zold ) ; //updates ZT for each tier
-			}
+	if( ( r = MSDecodeBatchBits( LLch, tin, bits, sys, tout, 1, &iter, t ) ) < 0 ){
+		return r ;
+	}
+	return iter ;
+}
 
-			sumTiers( t, Znew ) ;
+/*
+ * MSDecodeT() of f consecutive columns by thread t, interleaved layer by layer, see iterate()
+ * */
+int MSDecodeBatchT( const void *LLch, int tin, void *ApLLR, int tout, WORD *hd, int f, int *iter, int t ){
+	const int s = t * F_B ;
+	int j, r ;
 
-			memcpy( ( void * )Zold, ( void * )Znew, sizeof( ZNnew[ t ] ) ) ;
-		}
-		
-		if( iter == 0 ) {
-			assert( Znew == ZNnew[ t ] ) ;
+	if( f < 1 || f > F_B ){
+		return -3 ;
+	}
+	for( j = 0 ; j < f ; j++ ){
+		Kern.loadLLR( ( const char * )LLch + ( size_t )j * N * LLR_SIZE( tin ), tin, 1.0f, LLin[ s + j ], ZNold[ s + j ] ) ;
+	}
+	if( ( r = iterate( s, f, iter ) ) < 0 ){
+		return r ;
+	}
+	for( j = 0 ; j < f ; j++ ){
+		Kern.storeLLR( ZNold[ s + j ], ( char * )ApLLR + ( size_t )j * N * LLR_SIZE( tout ), tout, N ) ;
+		if( hd != NULL ){
+			HardDecision( ZNold[ s + j ], hd + ( size_t )j * HD_WORDS, N ) ;
 		}
+	}
+	return 0 ;
+}
 
-		for( n = 0 ; n < N ; n++ ){
-			HD[ t ][ n ] = sign( Znew[ n ] ) ;
-		}
+/*
+ * MSDecodeBits() of f consecutive columns by thread t, interleaved layer by layer, see iterate()
+ * */
+int MSDecodeBatchBits( const void *LLch, int tin, uint8_t *bits, void *sys, int tout, int f, int *iter, int t ){
+	const int s = t * F_B ;
+	int j, r ;
 
-		if( orthogonal( t ) ){
-			memcpy( ( void * )ApLLR, ( const void * )Znew, N * sizeof( FP ) ) ;
-			if( Termination ){
-				return iter + 1 ;
-			}
+	if( f < 1 || f > F_B ){
+		return -3 ;
+	}
+	for( j = 0 ; j < f ; j++ ){
+		Kern.loadLLR( ( const char * )LLch + ( size_t )j * N * LLR_SIZE( tin ), tin, 1.0f, LLin[ s + j ], ZNold[ s + j ] ) ;
+	}
+	if( ( r = iterate( s, f, iter ) ) < 0 ){
+		return r ;
+	}
+	for( j = 0 ; j < f ; j++ ){
+		Kern.packBits( ZNold[ s + j ], bits + ( size_t )j * ( ( K + 7 ) / 8 ), K ) ;
+		if( sys != NULL ){
+			Kern.storeLLR( ZNold[ s + j ], ( char * )sys + ( size_t )j * K * LLR_SIZE( tout ), tout, K ) ;
 		}
-
-		tmp = Zold;
-		Zold= Znew ;
-		Znew = tmp ;
 	}
+	return 0 ;
+}
 
-	memcpy( ( void * )ApLLR, ( const void * )Zold, N * sizeof( FP ) ) ;
-	return iter ;
+/*
+ * 1 if the hard decision of the last MSDecode() of thread t satisfies all checks, 0 otherwise
+ * */
+int MSConverged( int t ){
+	return Converged[ t * F_B ] ;
 }
 
 /*
- * convert LLR values to bits
- *
- * TODO: this will not work if WORD is wider than unsigned
+ * MSConverged() of column j of the last batch of thread t
  * */
-void HardDecision( FP *LLr, WORD *CW, int el ) {
-	int i, wi, ii ;
+int MSConvergedBatch( int t, int j ){
+	return Converged[ t * F_B + j ] ;
+}
 
-	assert( sizeof( WORD ) <= sizeof( unsigned ) ) ;
+/*
+ * convert LLR values to bits, a bitmap of whole WORDs packed by the sign kernel
+ * */
+void HardDecision( FP *LLr, WORD *CW, int el ) {
+	#ifndef BITMAP
+		int i ;
 
-	for( i = 0 ; i < el ; i++ ){
-		#ifndef BITMAP
+		for( i = 0 ; i < el ; i++ )
 			CW[ i ] = sign( LLr[ i ] ) ;
-		#else
-			assert( el % WB == 0 ) ;
-			wi = i / WB ;
-			ii = i % WB ;
-			CW[ wi ] = setSign( CW[ wi ], sign( LLr[ i ] ), WB - ii - 1 ) ;
-		#endif
-
-	}
+	#else
+		assert( el % WB == 0 ) ;
+		Kern.signBitmap( LLr, CW, el ) ;
+	#endif
 }
 
 /*
@@ -263,164 +261,78 @@ int Orthogonal( WORD *CW, int t ) {
 	if( CW == NULL )
 		return 0 ;
 
-	if( CW != HD[ t ] )
-		memcpy( ( void * )HD[ t ], (void *)CW, N * sizeof( WORD ) ) ;
+	if( CW != HD[ t * F_B ] )
+		memcpy( ( void * )HD[ t * F_B ], (void *)CW, N * sizeof( WORD ) ) ;
 
-	return orthogonal( t ) ;
+	return Kern.orthogonal( HD[ t * F_B ] ) ;
 }
 
-
 //local functions definitions---------------------------------------------------
 
 /*
- * sum the tiers for layered decoding
- * carefull: ZT values from previous iteration are also used
+ * the iterations of the f frames in slots s .. s + f - 1, their ZNold already holds LLch,
+ * the posteriors end there, the layers read them from their copy in the rotation layout ZR;
+ * layer mb of every frame still decoding comes before layer mb + 1, so the index tables and
+ * the code of a layer serve all of them, iterations of frame j to iter[ j ]
  * */
-static void sumTiers( int t, FP *znew ){
-	int n, mb ;
+static int iterate( int s, int f, int *iter ){
+	int it, l, mb, j, left = f ;
 
-	for( mb = 0 ; mb < MB ; mb++ ){
-		for( n = 0 ;  n < N ; n++ ){
-			znew[ n ] += ZT[ t ][ mb ][ n ] ;
-		}
+	if( sizeof( ZNold[ s ] ) != N * sizeof( FP ) ){
+		return -1 ;
+	}
+	if( sizeof( ZR[ s ] ) != 2 * sizeof( ZNold[ s ] ) ) {
+		return -2 ;
 	}
-}
-
-
-static void checkMinSum( int m, int mb, int iter, int t, FP *zold ){
-	FP min1 = FP_MAX ;
-	FP min2 = FP_MAX ;
-	FP zmn, lmn, a, tmp ;
 
-	int i, n, midx ;
-	unsigned s, sgnPrd = 0U ;
+	for( j = s ; j < s + f ; j++ ){
+		memset( ( void * )LM[ j ], 0U, sizeof( LM[ j ] ) ) ;
+		memset( ( void * )LS[ j ], 0U, sizeof( LS[ j ] ) ) ;
+		memset( ( void * )LI[ j ], 0U, sizeof( LI[ j ] ) ) ;
+		memset( ( void * )ZT[ j ], 0U, sizeof( ZT[ j ] ) ) ;
+		Converged[ j ] = 0 ;
+		iter[ j - s ] = 0 ;		//0 > still decoding
+		Kern.rotateLayout( ZNold[ j ], ZR[ j ] ) ;
+	}
 
-	//finds the updated minimums
+	for( it = 0 ; it < NIter && left > 0 ; it++ ){
 
-	for( i = 0 ; i < CH_S[ m ] ; i++ ){
-		n = CH_IND[ m ][ i ] ;
+		for( l = 0 ; l < MB ; l++ ){
+			mb = KOrder[ l ] ;
 
-		if( iter == 0 ){
-			//in first iteration just read the channel values, and no subtraction
-			zmn = zold[ n ] ;
-		}else{
-			//reconstruct old values from compressed form
-			a = ( ( i == LI[ t ][ m ] ) ? LM[ t ][ m ][ 1 ] : LM[ t ][ m ][ 0 ] ) ;
+			for( j = s ; j < s + f ; j++ ){
+				if( iter[ j - s ] > 0 )
+					continue ;
 
-			s 	= getSign( LS[ t ][ m ], i ) ;
+				memcpy( ( void * )ZNold[ j ], ( const void * )LLin[ j ], sizeof( ZNold[ j ] ) ) ;
+				memset( ( void * )ZT[ j ][ mb ], 0U, sizeof( ZT[ j ][ mb ] ) ) ;
 
-			#ifndef FIXED
-				tmp = ( s ? -1.0f : 1.0f ) * a ;
-			#else
-				tmp = ( s ? -a : a ) ;
-			#endif
+				//updates ZT for each tier
+				Kern.layerMinSum( mb, it, ZR[ j ], ZT[ j ][ mb ], LM[ j ][ 0 ] + Z * mb, LM[ j ][ 1 ] + Z * mb, LS[ j ] + Z * mb, LI[ j ] + Z * mb, Lambda, Beta ) ;
 
-			zmn = zold[ n ] - tmp  ; 			// Eq. (3) subtraction
+				Kern.sumTiers( ZNold[ j ], ZT[ j ][ 0 ] ) ;
 
+				Kern.rotateLayout( ZNold[ j ], ZR[ j ] ) ;
+			}
 		}
 
-		//compute two minimal values in array Lmn
-		s = sign( zmn ) ;
-		a = mag( zmn ) ;
+		for( j = s ; j < s + f ; j++ ){
+			if( iter[ j - s ] > 0 )
+				continue ;
 
-		LS[ t ][ m ] = setSign( LS[ t ][ m ], s, i ) ;
-		sgnPrd  ^= s ;
+			Kern.hardDecision( ZNold[ j ], HD[ j ] ) ;
 
-		if( a <= min1 ){
-			min2 = min1 ;
-			min1 = a ;
-			midx = i ;
-		}else{
-			if( a < min2 ){
-				min2 = a ;
+			Converged[ j ] = Kern.orthogonal( HD[ j ] ) ;
+			if( Converged[ j ] && Termination ){
+				iter[ j - s ] = it + 1 ;
+				left-- ;
 			}
 		}
 	}
 
-	LM[ t ][ m ][ 0 ] = min1 ;
-	LM[ t ][ m ][ 1 ] = min2 ;
-	LI[ t ][ m ] = midx ;
-
-	//calculate extrinsic messages
-	for( i = 0 ; i < CH_S[ m ] ; i++ ){
-			n = CH_IND[ m ][ i ] ;
-			a = ( ( i == midx ) ? min2 : min1 ) ;
-
-			s = getSign( LS[ t ][ m ], i ) ^ sgnPrd ;
-
-			#ifndef FIXED
-				lmn = Lambda * ( s ? -1.0f : 1.0f ) * max( a - Beta, 0.0f ) ;
-			#else
-				lmn = s ? -a : a ;
-			#endif
-
-			LS[ t ][ m ] = setSign( LS[ t ][ m ], sign( lmn ), i ) ;
-			ZT[ t ][ mb ][ n ] = lmn ; // assuming max column weight == 1 foir each tier
-	}
-
-}
-
-static int orthogonal( int t ){
-	int m, i ;
-	unsigned sum, b ;
-
-	for( m = 0 ; m < M ; m++ ){
-		sum = 0U ;
-		for( i = 0 ; i < CH_S[ m ] ; i++ ){
-			b = HD[ t ][ CH_IND[ m ][ i ] ] ;
-			sum ^= b ;
-		}
-		if( sum != 0 ){
-			return 0 ;
-		}
+	for( j = 0 ; j < f ; j++ ){
+		if( iter[ j ] == 0 )
+			iter[ j ] = it ;
 	}
-	return 1 ;
-}
-
-/*
-initialize CH_S and CH_IND based on the HBM matrix
-	assuming HB is already scaled
-*/
-
-static void initCheckIndices( void ) {
-		int r, c ; 		//indices to the block model matrix
-		int shift, offx, offy ;
-		int k ; 		//relative index inside the submatrix
-		int row, col ; 	//absolute indices to the binary H matrix
-
-		memset( ( void * )CH_S, 0, M * sizeof( int8_t) ) ;
-
-		for( r = 0 ; r < MB ; r++ ){
-			offy = r * Z ;
-			for( c = 0 ; c < NB ; c++ ){
-				offx = c * Z ;
-				shift = HBM[ r ][ c ] ;
-				if( shift == -1 ){
-					continue ;
-				}
-				assert( shift >= 0 && shift < Z ) ;
-
-				for( k = 0 ; k < Z ; k++ ){
-
-					col = offx + k ;
-					row = ( ( k + Z - shift ) % Z ) + offy ;
-	
-					CH_IND[ row ][ CH_S[ row ] ] = col ;
-					CH_S[ row ] += 1 ;
-
-					assert( row >= 0 && row < M ) ;
-					assert( col >= 0 && col < N ) ;
-					assert( col < INT16_MAX ) ;
-					assert( CH_S[ row ] <= NB ) ;
-				}
-			}
-		}
-
+	return 0 ;
 }
-
-
-
-
-
-
-
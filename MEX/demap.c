@@ -0,0 +1,291 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+#include <math.h>
+#include <float.h>
+#include <stdint.h>
+
+#if defined( __AVX2__ ) && !defined( DEMAP_SCALAR )
+	#define DEMAP_AVX2
+	#include <immintrin.h>
+#endif
+
+#include "ldpc.h"
+#include "demap.h"
+
+#define DM_BLK	16	// real samples per block, loops over a block vectorize
+
+static void nearest( const float *y, int nr, int m, float s, float *u, float *d ) ;
+static void pamMaxLog( const float *y, int nr, int m, float s, float c, float *llr ) ;
+#ifdef DEMAP_AVX2
+static void pamMaxLog8( const float *y, int m, float inv, float hi, float c, float *llr ) ;
+#endif
+static void pamExact( const float *y, int nr, int m, float s, float c, float *llr ) ;
+static float qamScale( int bits ) ;
+
+
+//global functions definitions-------------------------------------------------
+
+int QamValid( int bits ){
+	return bits >= 2 && bits <= QAM_MAX_BITS && ( bits & 1 ) == 0 ;
+}
+
+int QamSymbols( int bits, int el ){
+	return ( el + bits - 1 ) / bits ;
+}
+
+/*
+ * binary reflected Gray code: label of level j is j ^ ( j >> 1 ), levels ascending
+ * */
+float QamLevel( int bits, unsigned label ){
+	unsigned j, g ;
+	int l = 1 << ( bits / 2 ) ;
+
+	for( j = label, g = label >> 1 ; g != 0 ; g >>= 1 ){
+		j ^= g ;
+	}
+
+	return ( float )( 2 * ( int )j - l + 1 ) * qamScale( bits ) ;
+}
+
+void QamDemap( const float *y, int ns, int bits, float sigma, int method, float *llr ){
+	float s, c ;
+	int i, m, nr ;
+
+	m	= bits / 2 ;
+	nr	= 2 * ns ;
+	s	= qamScale( bits ) ;
+	c	= s * s / ( 2.0f * sigma * sigma ) ;	// squared distances are on the unit grid
+
+	if( method != DEMAP_EXACT ){
+		pamMaxLog( y, nr, m, s, c, llr ) ;
+		return ;
+	}
+
+	for( i = 0 ; i < nr ; i += DM_BLK ){
+		pamExact( y + i, nr - i < DM_BLK ? nr - i : DM_BLK, m, s, c, llr + i * m ) ;
+	}
+}
+
+void QamDemapFP( const float *y, int ns, int bits, float sigma, int method, FP *llr, int el ){
+	float tmp[ DM_BLK * QAM_MAX_BITS / 2 ] ;
+	int i, t, m, nr, nb ;
+
+	m	= bits / 2 ;
+	nr	= 2 * ns ;
+
+	for( i = 0 ; i < nr && i * m < el ; i += DM_BLK ){
+		nb = nr - i < DM_BLK ? nr - i : DM_BLK ;
+		QamDemap( y + i, nb / 2, bits, sigma, method, tmp ) ;
+		for( t = 0 ; t < nb * m && i * m + t < el ; t++ ){
+			llr[ i * m + t ] = QuantizeLLR( tmp[ t ] ) ;
+		}
+	}
+}
+
+FP QuantizeLLR( float llr ){
+	#ifndef FIXED
+		return llr ;
+	#else
+		float a = ( float )( ( 1 << QB ) - 1 ) / ( float )FP_MAX ;
+
+		//saturate, scale, round half away from zero: K_FROMF of kernel.inc and float2int.m
+		if( llr > FP_MAX )
+			llr = FP_MAX ;
+		if( llr < -FP_MAX )
+			llr = -FP_MAX ;
+
+		return ( FP )roundf( a * llr ) ;
+	#endif
+}
+
+//local functions definitions---------------------------------------------------
+
+/*
+ * unit grid: levels at 2 j - hi, u = y / s, squared distance d to the nearest level
+ * */
+static void nearest( const float *y, int nr, int m, float s, float *u, float *d ){
+	float e, f, inv = 1.0f / s, hi = ( float )( ( 1 << m ) - 1 ) ;
+	int i ;
+
+	for( i = 0 ; i < nr ; i++ ){
+		u[ i ] = y[ i ] * inv ;
+		f = 0.5f * ( u[ i ] + hi ) + 0.5f ;
+		f = f < 0.0f ? 0.0f : ( f > hi ? hi : f ) ;
+		e = u[ i ] - ( 2.0f * ( float )( int )f - hi ) ;
+		d[ i ] = e * e ;
+	}
+}
+
+/*
+ * max-log: LLR of bit k is c * ( d( nearest level with bit k flipped ) - d( nearest level ) ),
+ * negated if bit k of the nearest level is 1.
+ * Bit k ( MSB first ) of the Gray label changes between levels b - 1 and b for b = h mod p,
+ * p = 2^( m - k ), h = p / 2, all levels between two such boundaries share bit k,
+ * so the nearest flipped level is next to the boundary left or right of the nearest level.
+ * unit grid: levels at 2 j - hi, hi = 2^m - 1, u = y / s
+ * */
+static void pamMaxLog( const float *y, int nr, int m, float s, float c, float *llr ){
+	float u, f, d, el, er, jf, bf, inv, hi ;
+	int i, k, p, j, g ;
+
+	inv	= 1.0f / s ;
+	hi	= ( float )( ( 1 << m ) - 1 ) ;
+	i	= 0 ;
+
+	#ifdef DEMAP_AVX2
+		for( ; i + 8 <= nr ; i += 8 ){
+			pamMaxLog8( y + i, m, inv, hi, c, llr + i * m ) ;
+		}
+	#endif
+
+	for( ; i < nr ; i++ ){
+		u	= y[ i ] * inv ;
+		f	= 0.5f * ( u + hi ) + 0.5f ;		// nearest level index + 0.5
+		f	= f < 0.0f ? 0.0f : ( f > hi ? hi : f ) ;
+		j	= ( int )f ;
+		jf	= ( float )j ;
+		el	= u - ( 2.0f * jf - hi ) ;
+		d	= el * el ;
+		g	= j ^ ( j >> 1 ) ;
+
+		for( k = 0 ; k < m ; k++ ){
+			p	= 1 << ( m - k ) ;
+			bf	= ( float )( j - ( ( j + p / 2 ) & ( p - 1 ) ) ) ;	// boundary at or left of j, < 1 > none
+			el	= u - ( 2.0f * bf - hi - 2.0f ) ;				// level bf - 1
+			er	= u - ( 2.0f * ( bf + ( float )p ) - hi ) ;		// level of the boundary right of j
+			el	= bf >= 1.0f ? el * el : FLT_MAX ;
+			er	= bf + ( float )p <= hi ? er * er : FLT_MAX ;
+			el	= el < er ? el : er ;
+			el	= c * ( el - d ) ;
+			llr[ i * m + k ] = ( ( g >> ( m - 1 - k ) ) & 1 ) ? -el : el ;
+		}
+	}
+}
+
+#ifdef DEMAP_AVX2
+/*
+ * pamMaxLog() for 8 samples, same operations in the same order
+ * */
+static void pamMaxLog8( const float *y, int m, float inv, float hi, float c, float *llr ){
+	__m256 u, f, d, el, er, bf, brf, vhi, one, two, big ;
+	__m256i j, g, bi ;
+	float lk[ QAM_MAX_BITS / 2 ][ 8 ] ;
+	int i, k, p ;
+
+	vhi	= _mm256_set1_ps( hi ) ;
+	one	= _mm256_set1_ps( 1.0f ) ;
+	two	= _mm256_set1_ps( 2.0f ) ;
+	big	= _mm256_set1_ps( FLT_MAX ) ;
+
+	u	= _mm256_mul_ps( _mm256_loadu_ps( y ), _mm256_set1_ps( inv ) ) ;
+	f	= _mm256_add_ps( _mm256_mul_ps( _mm256_set1_ps( 0.5f ), _mm256_add_ps( u, vhi ) ), _mm256_set1_ps( 0.5f ) ) ;
+	f	= _mm256_min_ps( _mm256_max_ps( f, _mm256_setzero_ps() ), vhi ) ;
+	j	= _mm256_cvttps_epi32( f ) ;
+	el	= _mm256_sub_ps( u, _mm256_sub_ps( _mm256_mul_ps( two, _mm256_cvtepi32_ps( j ) ), vhi ) ) ;
+	d	= _mm256_mul_ps( el, el ) ;
+	g	= _mm256_xor_si256( j, _mm256_srli_epi32( j, 1 ) ) ;
+
+	for( k = 0 ; k < m ; k++ ){
+		p	= 1 << ( m - k ) ;
+		bi	= _mm256_and_si256( _mm256_add_epi32( j, _mm256_set1_epi32( p / 2 ) ), _mm256_set1_epi32( p - 1 ) ) ;
+		bf	= _mm256_cvtepi32_ps( _mm256_sub_epi32( j, bi ) ) ;
+		brf	= _mm256_add_ps( bf, _mm256_set1_ps( ( float )p ) ) ;
+		el	= _mm256_sub_ps( u, _mm256_sub_ps( _mm256_sub_ps( _mm256_mul_ps( two, bf ), vhi ), two ) ) ;
+		er	= _mm256_sub_ps( u, _mm256_sub_ps( _mm256_mul_ps( two, brf ), vhi ) ) ;
+		el	= _mm256_blendv_ps( big, _mm256_mul_ps( el, el ), _mm256_cmp_ps( bf, one, _CMP_GE_OQ ) ) ;
+		er	= _mm256_blendv_ps( big, _mm256_mul_ps( er, er ), _mm256_cmp_ps( brf, vhi, _CMP_LE_OQ ) ) ;
+		el	= _mm256_min_ps( el, er ) ;
+		el	= _mm256_mul_ps( _mm256_set1_ps( c ), _mm256_sub_ps( el, d ) ) ;
+		bi	= _mm256_slli_epi32( _mm256_srli_epi32( g, m - 1 - k ), 31 ) ;	// bit k of the label to the sign bit
+		_mm256_storeu_ps( lk[ k ], _mm256_xor_ps( el, _mm256_castsi256_ps( bi ) ) ) ;
+	}
+
+	for( i = 0 ; i < 8 ; i++ ){
+		for( k = 0 ; k < m ; k++ ){
+			llr[ i * m + k ] = lk[ k ][ i ] ;
+		}
+	}
+}
+#endif
+
+/*
+ * exact: log of the ratio of sums of Gaussian likelihoods over all levels with bit k = 0 and = 1,
+ * in double relative to the nearest level, so neither sum underflows for practical SNRs
+ * */
+static void pamExact( const float *y, int nr, int m, float s, float c, float *llr ){
+	double s0[ QAM_MAX_BITS / 2 ][ DM_BLK ], s1[ QAM_MAX_BITS / 2 ][ DM_BLK ] ;
+	double w[ DM_BLK ], *acc ;
+	float u[ DM_BLK ], d[ DM_BLK ], e ;
+	int i, k, a, g, l = 1 << m ;
+
+	nearest( y, nr, m, s, u, d ) ;
+
+	for( k = 0 ; k < m ; k++ ){
+		for( i = 0 ; i < nr ; i++ ){
+			s0[ k ][ i ] = s1[ k ][ i ] = DBL_MIN ;
+		}
+	}
+
+	for( a = 0 ; a < l ; a++ ){
+		for( i = 0 ; i < nr ; i++ ){
+			e = u[ i ] - ( float )( 2 * a - l + 1 ) ;
+			w[ i ] = exp( -( double )c * ( double )( e * e - d[ i ] ) ) ;
+		}
+		g = a ^ ( a >> 1 ) ;
+		for( k = 0 ; k < m ; k++ ){
+			acc = ( ( g >> ( m - 1 - k ) ) & 1 ) ? s1[ k ] : s0[ k ] ;
+			for( i = 0 ; i < nr ; i++ ){
+				acc[ i ] += w[ i ] ;
+			}
+		}
+	}
+
+	for( k = 0 ; k < m ; k++ ){
+		for( i = 0 ; i < nr ; i++ ){
+			llr[ i * m + k ] = ( float )( log( s0[ k ][ i ] ) - log( s1[ k ][ i ] ) ) ;
+		}
+	}
+}
+
+/*
+ * levels +-1, +-3, .. scaled to unit average symbol energy: 2 ( M - 1 ) / 3 per symbol
+ * */
+static float qamScale( int bits ){
+	return ( float )( 1.0 / sqrt( 2.0 * ( double )( ( 1 << bits ) - 1 ) / 3.0 ) ) ;
+}
@@ -0,0 +1,82 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Soft demapper for Gray-mapped square QAM, the IEEE 802.11 constellations 4 .. 1024-QAM.
+
+	A 2^bits-QAM symbol is two independent Gray-mapped PAMs of bits / 2 bits each,
+	I carries the first half of the bits of a symbol, Q the second half, MSB first,
+	average symbol energy is 1. Symbols are stored as interleaved I, Q floats,
+	so the demapper works on a stream of real PAM samples and the bits / 2 LLRs
+	of sample i land at llr[ i * bits / 2 ] .
+
+	LLR = log( P( b = 0 ) / P( b = 1 ) ), positive > 0, same sign as the decoders expect.
+	Max-log needs only the nearest level and, per bit, the nearest level with that bit
+	flipped, which are found in closed form, so the cost per LLR does not grow with the order.
+*/
+
+#ifndef QCLDPCDEMAP
+#define QCLDPCDEMAP
+
+#define QAM_MAX_BITS	10	// 1024-QAM
+
+#define DEMAP_MAXLOG	0
+#define DEMAP_EXACT		1	// log-sum-exp over all levels, reference for max-log
+
+//	1 if bits is a supported nr. of bits per QAM symbol: 2, 4, .. QAM_MAX_BITS
+extern int QamValid( int bits ) ;
+
+//	nr. of symbols carrying el bits, the last one padded with zeros
+extern int QamSymbols( int bits, int el ) ;
+
+//	amplitude of the PAM level with axis label label of bits / 2 bits
+extern float QamLevel( int bits, unsigned label ) ;
+
+/*
+	ns symbols y ( 2 * ns floats ) received over AWGN with standard deviation
+	sigma per real dimension > ns * bits float LLRs
+*/
+extern void QamDemap( const float *y, int ns, int bits, float sigma, int method, float *llr ) ;
+
+//	same, decoder-ready: first el LLRs quantized to FP of ldpc.h, padding bits dropped
+extern void QamDemapFP( const float *y, int ns, int bits, float sigma, int method, FP *llr, int el ) ;
+
+//	float LLR to FP of ldpc.h, fixed point: saturated to +-FP_MAX, scaled and rounded like float2int.m and the decoder's loadLLR
+extern FP QuantizeLLR( float llr ) ;
+
+#endif
@@ -40,30 +40,41 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <math.h>
 #include <memory.h>
 #include <stdint.h>
+#include <stdlib.h>
 
 #ifdef MATLAB_MEX_FILE
 	#include "mex.h"
 	#include "matrix.h"
 #else
 	#include <stdio.h>
-	#include <stdlib.h>
 #endif
 
 #include "ldpc.h"
 #include "debug.h"
 #include "encoder.h"
+#include "kernel.h"
 
-static BLOCK Si[ MB ] ;
+static int Method = ENC_ANNEXG ;	//selected by QCLDPCInitEncoder()
+
+//generic encoder plan: Hp^-1 is block-circulant, each circulant stored as a list of shifts
+static int PlanReady = 0 ;
+static int16_t PI_S[ MB ][ MB ] ;			//nr. of shifts of each circulant of Hp^-1
+static int16_t PI_SH[ MB ][ MB ][ Z ] ;	//shifts of each circulant of Hp^-1
 
 //local functions prototypes--------------------------------------------
 
+static void sumSystematic( BLOCK_P u, BLOCK *si ) ;
+static void encodeAnnexG( WORD *in, WORD *out ) ;
+static void encodeGeneric( WORD *in, WORD *out ) ;
+static int checkAnnexG( void ) ;
+static int initGenericPlan( void ) ;
+
 WORD XOR( WORD x, WORD y ) ;
 void vXOR( WORD *v1, WORD *v2, WORD *dst ) ;
 void vNUL( WORD *v, int num ) ;
 void vCPY( WORD *dst, WORD *src, int len ) ;
 int checkShift( int shift ) ;
 void aROR( WORD *v, WORD *res, int shift, int z ) ;
-int modWB( int i ) ;
 void baROR( WORD *v, WORD *res, int shift ) ;
 void vROR( WORD *v, WORD *res, int shift, int z ) ;
 
@@ -88,18 +99,104 @@ int CheckEncoderInput( WORD *in, int r, int c ){
  	return 1 ;
 }
 
+/*
+	select the encoding method and prepare its plan, the plan is computed only once
+	returns 1 on success, 0 if HBM does not have the structure the method requires
+*/
+int QCLDPCInitEncoder( int method ){
+
+	KernelInit() ;
+
+	if( method == ENC_GENERIC ){
+		if( !PlanReady ){
+			PlanReady = initGenericPlan() ;
+		}
+		if( !PlanReady ){
+			return 0 ;
+		}
+	}else{
+		if( !checkAnnexG() ){
+			return 0 ;
+		}
+		method = ENC_ANNEXG ;
+	}
+
+	Method = method ;
+	return 1 ;
+}
+
 /*
 	based on the data vector in (of length K or KW (bitmap))
 	produces the parity part out ( of length M or MW (bitmap) )
 	encodes one word
 */
 void QCLDPCEncode( WORD *in, WORD *out ){
-	int i, j, p0, shift ;
+	if( Method == ENC_GENERIC ){
+		encodeGeneric( in, out ) ;
+	}else{
+		encodeAnnexG( in, out ) ;
+	}
+}
+
+/*
+	based on the data vector in (of length K or KW (bitmap))
+	produces the whole codeword cw ( of length N or NW (bitmap) )
+	data are copied only if not already in place
+	encodes one word
+*/
+void QCLDPCEncodeCW( WORD *in, WORD *cw ){
+	int k ;
+
+	#ifdef BITMAP
+		assert( K % WB == 0 ) ;
+		k = KW ;
+	#else
+		k = K ;
+	#endif
+
+	if( in != cw ){
+		assert( in + k <= cw || cw + k <= in ) ;
+		vCPY( cw, in, K ) ;		// K in bits for bitmap, in elements for array
+	}
+
+	QCLDPCEncode( cw, cw + k ) ;
+}
+
+//local functions definitions
+
+/*
+	si = Hs * u : the sums of rotated data blocks for each tier
+	si is supplied by the caller so that encoding is thread safe
+*/
+static void sumSystematic( BLOCK_P u, BLOCK *si ){
+	int i, j, shift ;
+	BLOCK t ;
+
+	vNUL( (WORD *)si, MB ) ;
+
+	for( i = 0 ; i < MB ; i++ ){
+		for( j = 0 ; j < KB ; j++ ){
+			shift = HBM[ i ][ j ] ;
+			if( shift != -1 ){
+				vROR( u[ j ], t, shift, Z ) ;
+			 	vXOR( si[ i ], t, si[ i ] ) ;
+			}
+		}
+	}
+}
+
+/*
+	802.16 / 802.11 Annex G procedure
+	assumes dual-diagonal parity part and one non-paired entry in column KB
+*/
+static void encodeAnnexG( WORD *in, WORD *out ){
+	int i, p0, shift ;
 	BLOCK_P u ;
 	BLOCK_P v ;
 
 	BLOCK t ;	
 	BLOCK sum ;
+	BLOCK Si[ MB ] ;
 
 	dbg( 2, "encode: sizeof( WORD ): %dB, sizeof( BLOCK): %dB, Z x WB : %dB,  sizeof( Si ): %dB, MB x Z: %dB \n",
 		sizeof( WORD ), sizeof( BLOCK ), Z * WB/8,  sizeof( Si ), MB * Z ) ;
@@ -122,20 +219,12 @@ void QCLDPCEncode( WORD *in, WORD *out ){
 	u = ( BLOCK_P ) in ;
 	v = ( BLOCK_P ) out ;
 	
-	vNUL( (WORD *)Si, MB ) ;
+	sumSystematic( u, Si ) ;
 
 	//calculate the double sum in eq. G.1
 	vNUL( sum, 1 ) ;
 	
 	for( i = 0 ; i < MB ; i++ ){
-		vNUL( t, 1 ) ;
-		for( j = 0 ; j < KB ; j++ ){
-			shift = HBM[ i ][ j ] ;
-			if( shift != -1 ){
-				vROR( u[ j ], t, shift, Z ) ;
-			 	vXOR( Si[ i ], t, Si[ i ] ) ;
-			}
-		}
 		vXOR( Si[ i ], sum, sum ) ;
 	}
 
@@ -169,8 +258,156 @@ void QCLDPCEncode( WORD *in, WORD *out ){
 
 }
 
+/*
+	generic procedure for any invertible parity part Hp:
+	v = Hp^-1 * Hs * u, where Hp^-1 is applied as a sum of rotations
+	plan must be ready, see QCLDPCInitEncoder()
+*/
+static void encodeGeneric( WORD *in, WORD *out ){
+	int i, j, l ;
+	BLOCK_P u ;
+	BLOCK_P v ;
 
-//local functions definitions
+	BLOCK t ;
+	BLOCK Si[ MB ] ;
+
+	assert( PlanReady ) ;
+
+	u = ( BLOCK_P ) in ;
+	v = ( BLOCK_P ) out ;
+
+	sumSystematic( u, Si ) ;
+
+	vNUL( (WORD *)v, MB ) ;
+
+	for( i = 0 ; i < MB ; i++ ){
+		for( j = 0 ; j < MB ; j++ ){
+			for( l = 0 ; l < PI_S[ i ][ j ] ; l++ ){
+				vROR( Si[ j ], t, PI_SH[ i ][ j ][ l ], Z ) ;
+				vXOR( v[ i ], t, v[ i ] ) ;
+			}
+		}
+	}
+}
+
+/*
+	check the parity part has the structure assumed by encodeAnnexG()
+	returns 1 if OK, 0 otherwise
+*/
+static int checkAnnexG( void ){
+	int i, j, np ;
+
+	if( HBM[ 0 ][ KB ] < 0 || HBM[ 0 ][ KB ] != HBM[ MB - 1 ][ KB ] ){
+		return 0 ;
+	}
+
+	np = 0 ;
+	for( i = 1 ; i < MB - 1 ; i++ ){
+		if( HBM[ i ][ KB ] > -1 ){
+			np++ ;
+		}
+	}
+	if( np != 1 ){
+		return 0 ;
+	}
+
+	//dual diagonal with zero shifts
+	for( i = 0 ; i < MB ; i++ ){
+		for( j = 1 ; j < MB ; j++ ){
+			if( i == j - 1 || i == j ){
+				if( HBM[ i ][ KB + j ] != 0 )
+					return 0 ;
+			}else{
+				if( HBM[ i ][ KB + j ] != -1 )
+					return 0 ;
+			}
+		}
+	}
+
+	return 1 ;
+}
+
+/*
+	invert the binary parity part Hp by Gauss-Jordan elimination on bit rows
+	Hp^-1 is block-circulant, so only the first row of each block is kept
+	as a list of rotations
+	returns 1 on success, 0 if Hp is singular
+*/
+static int initGenericPlan( void ){
+	const int w = ( M + 63 ) / 64 ;	//64-bit words per half row
+	uint64_t *A, *r, *p, tmp ;
+	int i, j, l, c, s, col, row, piv ;
+
+	if( ( A = ( uint64_t * )calloc( ( size_t )M * 2 * w, sizeof( uint64_t ) ) ) == NULL ){
+		return 0 ;
+	}
+
+	//build [ Hp | I ], H( r * Z + k, c * Z + ( k + s ) % Z ) = 1 for block shift s
+	for( i = 0 ; i < MB ; i++ ){
+		for( j = 0 ; j < MB ; j++ ){
+			s = HBM[ i ][ KB + j ] ;
+			if( s == -1 ){
+				continue ;
+			}
+			for( l = 0 ; l < Z ; l++ ){
+				row = i * Z + l ;
+				col = j * Z + ( l + s ) % Z ;
+				A[ row * 2 * w + col / 64 ] ^= 1ULL << ( col % 64 ) ;
+			}
+		}
+	}
+	for( row = 0 ; row < M ; row++ ){
+		col = w * 64 + row ;
+		A[ row * 2 * w + col / 64 ] |= 1ULL << ( col % 64 ) ;
+	}
+
+	for( col = 0 ; col < M ; col++ ){
+		for( piv = col ; piv < M ; piv++ ){
+			if( ( A[ piv * 2 * w + col / 64 ] >> ( col % 64 ) ) & 1ULL )
+				break ;
+		}
+		if( piv == M ){
+			dbg( 1, "Generic encoder: parity part singular at column %d.\n", col ) ;
+			free( A ) ;
+			return 0 ;
+		}
+
+		p = A + piv * 2 * w ;
+		if( piv != col ){
+			r = A + col * 2 * w ;
+			for( c = 0 ; c < 2 * w ; c++ ){
+				tmp = r[ c ] ; r[ c ] = p[ c ] ; p[ c ] = tmp ;
+			}
+			p = r ;
+		}
+
+		for( row = 0 ; row < M ; row++ ){
+			r = A + row * 2 * w ;
+			if( row != col && ( ( r[ col / 64 ] >> ( col % 64 ) ) & 1ULL ) ){
+				for( c = col / 64 ; c < 2 * w ; c++ ){
+					r[ c ] ^= p[ c ] ;
+				}
+			}
+		}
+	}
+
+	//first row of block ( i, j ) of Hp^-1: ones at shifts of the circulant
+	for( i = 0 ; i < MB ; i++ ){
+		r = A + i * Z * 2 * w ;
+		for( j = 0 ; j < MB ; j++ ){
+			PI_S[ i ][ j ] = 0 ;
+			for( l = 0 ; l < Z ; l++ ){
+				col = w * 64 + j * Z + l ;
+				if( ( r[ col / 64 ] >> ( col % 64 ) ) & 1ULL ){
+					PI_SH[ i ][ j ][ PI_S[ i ][ j ]++ ] = l ;
+				}
+			}
+		}
+	}
+
+	free( A ) ;
+	return 1 ;
+}
 
 
 // also do some checking
@@ -219,9 +456,7 @@ void vCPY( WORD *dst, WORD *src, int len ){
 
 int checkShift( int shift ){
 
-	#ifdef MATLAB_MEX_FILE
-		shift = -shift ;	//MATLAB ROR/ROL confusion fix
-	#endif
+	shift = -shift ;	//MATLAB ROR/ROL confusion fix, also needed in CLI to match decoder H
 
 	shift = shift % Z ;
 
@@ -254,13 +489,6 @@ void aROR( WORD *v, WORD *res, int shift, int z ){
 	vCPY( res + shift, v, z - shift ) ;
 }
 
-/*
- * modulo power of two
- * */
-int modWB( int i ){
-	return i & ( ( 1 << WBE ) - 1 ) ;
-}
-
 /*
  * rotate array of bits stored in a bitmap - each array element stores WB bits
  * shift is the number of bits
@@ -270,11 +498,6 @@ int modWB( int i ){
  * 		memory accesses must be aligned to word boundary
  */
 void baROR( WORD *v, WORD *res, int shift ){
-	int sW ; // shift in WORDs
-	int sb ; // shift in bits within a WORD
-
-	int i, j ;
-	WORD curSW, preSW, hi, lo ;
 
 	shift = checkShift( shift ) ;
 
@@ -282,31 +505,9 @@ void baROR( WORD *v, WORD *res, int shift ){
 		vCPY( res, v, Z ) ; // Z gets divided by WB inside
 		return ;
 	}
+	dbg( 2, "s: %d, sW: %d, sb: %d\n", shift, shift >> WBE, shift & ( WB - 1 ) ) ;
 
-	sW = shift >> WBE ; 	// shift / WB, WB power of 2
-	sb = modWB( shift ); 	// shift % WB
-	dbg( 2, "s: %d, sW: %d, sb: %d\n", shift, sW, sb ) ;
-
-	if( sb == 0 ){
-		//aROR cannot be used here
-		for( i = 0 ; i < ZW ; i++ ){
-			j = ( i + sW ) % ZW ;
-			res[ j ] = v[ i ] ;
-		}
-		return ;
-	}
-
-	preSW = v[ ZW - 1 ] ;
-
-	for( i = 0 ; i < ZW ; i++ ){
-		j 		= ( i + sW ) % ZW ;	//not a power of 2
-		curSW 	= v[ i ] ;
-		hi 		= preSW << ( WB - sb ) ;
-		lo 		= curSW >> sb ;
-		res[j] 	= hi | lo ;
-		preSW 	= v[ i ] ;
-	}
-
+	Kern.rotateBits( v, res, shift ) ;	//word and bit shift, see kernel.inc
 }
 
 void vROR( WORD *v, WORD *res, int shift, int z ){
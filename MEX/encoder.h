@@ -42,6 +42,18 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef QCLDPCENC
 #define QCLDPCENC
 
+//encoding methods, see QCLDPCInitEncoder()
+#define ENC_ANNEXG 	0	//802.16/802.11 Annex G: dual-diagonal parity part, default
+#define ENC_GENERIC	1	//any invertible parity part: precomputed block-circulant inverse
+
+/*
+	select the encoding method used by QCLDPCEncode() and QCLDPCEncodeCW()
+	ENC_GENERIC inverts the parity part of H once, the plan is cached
+
+	returns 1 on success, 0 if HBM is unsupported by the method
+*/
+extern int QCLDPCInitEncoder( int method ) ;
+
 /*
 	non-bitmap encoder: check the data is binary:
 	contains only zeros and ones stored as WORD 
@@ -59,4 +71,14 @@ extern int CheckEncoderInput( WORD *in, int r, int c ) ;
 */
 extern void QCLDPCEncode( WORD *in, WORD *out ) ;
 
+/*
+	based on the data vector in (of length K or KW (bitmap))
+	produces the whole codeword cw ( of length N or NW (bitmap) )
+	systematic part is copied to cw only if in != cw,
+	otherwise the data are assumed to be already in place
+	in and cw must not partially overlap
+	encodes one word
+*/
+extern void QCLDPCEncodeCW( WORD *in, WORD *cw ) ;
+
 #endif
@@ -0,0 +1,1034 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Golden-vector regression harness for the decoders.
+
+	Frames come from the counter-based RNG ( rng.c ): random data, encoder,
+	BPSK over AWGN, so every build decodes exactly the same channel LLRs.
+	Per frame the harness records the nr. of iterations, convergence, data
+	bit errors and a FNV-1a hash of the posterior LLRs into a text file:
+
+		golden -g file		write golden vectors of this build
+		golden file			check this build against them
+
+	Builds with the same FP type, QB, FP_MAX and decoder parameters must be
+	bit-exact: decoder.c, decoderMT.c with any nr. of threads and every
+	optimized kernel that promises it. Otherwise ( -b, or a golden file of
+	another FP type ) only BER-equivalence is checked: per Eb/N0 point the
+	95 % BER and FER intervals must overlap, or the build must be better.
+
+	-d writes channel and posterior LLRs and iterations as a binary file,
+	testGolden.m decodes the same LLRs with the MEX wrappers and compares.
+
+	-B decodes the frames of a thread in batches of F_B ( ldpc.h ) with
+	MSDecodeBatchT(), layer by layer, must be bit-exact as well.
+
+	-y encodes and decodes with libyaldpc ( yaldpc.h ) instead, the code is
+	made at run-time from HBM of ldpc.c, float builds only. Then the API is
+	checked against the same frames: code files with and without tables and
+	plan, used in place and made from hbm ( YALDPC_INPLACE=0 ), a file with a
+	wrong checksum, yaldpc_decode_typed() and yaldpc_decode_bits() of every
+	LLR type, the order of yaldpc_stream_wait(), and every code of
+	yaldpc_code_get() against its base matrix from loadQCLDPC in std_hbm.txt
+	next to the golden file.
+
+	The layers are decoded in the order of SCHED ( ldpc.h ) or YALDPC_SCHED,
+	the golden vectors are of the natural order, check another one with -b
+	or against vectors written with it.
+
+	CLI build, use decoderMT.c instead of decoder.c for -t > 1:
+	c99 -O3 -DNDEBUG -pthread -o golden golden.c decoder.c encoder.c ldpc.c debug.c sim.c rng.c demap.c latency.c kernel.c yaldpc.c ykernel.c ystd.c -lm
+*/
+
+#define _POSIX_C_SOURCE 200809L	//getopt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "ldpc.h"
+#include "debug.h"
+#include "encoder.h"
+#include "decoder.h"
+#include "rng.h"
+#include "sim.h"
+#include "kernel.h"
+#include "yaldpc.h"
+#include "yaldpc_int.h"
+
+#define GD_VERSION	1
+#define GD_MAXP		16		// max. nr. of Eb/N0 points
+#define GD_SHOW		5		// mismatching frames printed
+#define GD_LIBF		24		// -y: frames of the API checks
+#define GD_DEPTH	8		// -y: frames in flight of the stream check
+#define GD_STD		"std_hbm.txt"	// -y: base matrices of the standard codes
+#define GD_NSTD		126		// 3 x 4 Wi-Fi and 19 x 6 WiMAX codes
+
+#ifdef BITMAP
+	#define GD_K KW
+	#define GD_N NW
+#else
+	#define GD_K K
+	#define GD_N N
+#endif
+
+#ifdef FIXED
+	#define GD_FP		"fixed"
+	#define GD_QB		QB
+	#define GD_FPMAX	FP_MAX
+	#define GD_LLR		LLR_INT16
+#else
+	#define GD_FP		"float"
+	#define GD_QB		0
+	#define GD_FPMAX	0
+	#define GD_LLR		LLR_SINGLE
+#endif
+
+#define sign( x ) ( ( x ) < 0 ? 1U : 0U )
+
+//configuration of a golden file, everything that changes the results
+typedef struct gd_head {
+	int			n, k, z ;
+	uint32_t	hbm ;		// hash of the base matrix
+	char		fp[ 8 ] ;	// "float" or "fixed"
+	int			qb, fpMax ;	// fixed point quantization, 0 for float
+	int			nIter ;
+	double		norm, offset ;
+	int			term ;		// 1 > early termination
+	uint64_t	seed ;
+	int			np ;		// nr. of Eb/N0 points
+	int			frames ;	// frames per point
+	double		ebn0[ GD_MAXP ] ;
+} GD_HEAD ;
+
+//result of one frame
+typedef struct gd_frame {
+	int			iter ;
+	int			conv ;
+	int			err ;		// data bit errors
+	uint64_t	hash ;		// FNV-1a of the posterior LLRs
+} GD_FRAME ;
+
+typedef struct gd_thread {
+	pthread_t	id ;
+	int			t ;
+	int			nth ;
+	int			nf ;		// frames in total
+	FP			*llch ;		// N x nf
+	FP			*apll ;		// N x nf
+	GD_FRAME	*f ;
+	int			err ;		// libyaldpc error
+} GD_THREAD ;
+
+static GD_HEAD Head = { .nIter = 10, .norm = 1.0, .offset = 0.0, .term = 1, .seed = 1,
+						.np = 3, .frames = 100, .ebn0 = { 1.0, 2.5, 4.0 } } ;
+static yaldpc_code *Lib = NULL ;	// -y: code of libyaldpc
+static int LibSched = YALDPC_SCHED_NATURAL ;
+
+static void usage( const char *name ) ;
+static void initHead( GD_HEAD *h ) ;
+static int readGolden( const char *name, GD_HEAD *h, GD_FRAME **f ) ;
+static int writeGolden( const char *name, const GD_HEAD *h, const GD_FRAME *f ) ;
+static int writeDump( const char *name, const GD_HEAD *h, const FP *llch, const FP *apll, const GD_FRAME *f ) ;
+static int checkExact( const GD_HEAD *h, const GD_FRAME *g, const GD_FRAME *f ) ;
+static int checkBER( const GD_HEAD *h, const GD_FRAME *g, const GD_FRAME *f ) ;
+static void counters( const GD_HEAD *h, const GD_FRAME *f, int x, SIM_COUNTERS *c ) ;
+static void *decodeThread( void *arg ) ;
+static void *decodeThreadBatch( void *arg ) ;
+static void *decodeThreadLib( void *arg ) ;
+static int initLib( void ) ;
+static void libParams( yaldpc_dec_params *p ) ;
+static int checkLib( const char *golden, const FP *llch, const FP *apll, const GD_FRAME *f, int nf ) ;
+static int libDecode( const yaldpc_code *c, const float *in, const GD_FRAME *g ) ;
+static int libFiles( const float *in, const GD_FRAME *g ) ;
+static int libTyped( const float *in, const float *ap, const GD_FRAME *g ) ;
+static int libStream( const FP *llch, const GD_FRAME *f, int nf ) ;
+static int libStd( const char *golden ) ;
+static uint32_t hbmHash( const int8_t *h, int len ) ;
+static uint64_t fnv1a64( const uint8_t *b, size_t len ) ;
+static unsigned getBit( WORD *v, int i ) ;
+
+
+int main( int argc, char *argv[] ){
+	GD_HEAD g ;
+	GD_FRAME *gf = NULL, *f ;
+	GD_THREAD th[ N_TH ] ;
+	WORD data[ GD_K ], cw[ GD_N ] ;
+	float noise[ N ] ;
+	FP *llch, *apll ;
+	RNG rng ;
+	const char *dump = NULL ;
+	double from, step, to, var ;
+	yaldpc_encoder *enc = NULL ;
+	int o, x, j, i, nf, nth = 1, gen = 0, ber = 0, lib = 0, batch = 0, r ;
+
+	while( ( o = getopt( argc, argv, "gbByt:e:f:i:d:h" ) ) != -1 ){
+		switch( o ){
+			case 'g': gen = 1 ; break ;
+			case 'b': ber = 1 ; break ;
+			case 'B': batch = 1 ; break ;
+			case 'y': lib = 1 ; break ;
+			case 't': nth = atoi( optarg ) ; break ;
+			case 'e':
+				if( sscanf( optarg, "%lf:%lf:%lf", &from, &step, &to ) != 3 || step <= 0.0 ){
+					usage( argv[ 0 ] ) ;
+					return 2 ;
+				}
+				for( Head.np = 0 ; Head.np < GD_MAXP && from + Head.np * step <= to + 1e-9 ; Head.np++ )
+					Head.ebn0[ Head.np ] = from + Head.np * step ;
+				break ;
+			case 'f': Head.frames = atoi( optarg ) ; break ;
+			case 'i': Head.nIter = atoi( optarg ) ; break ;
+			case 'd': dump = optarg ; break ;
+			default:
+				usage( argv[ 0 ] ) ;
+				return o == 'h' ? 0 : 2 ;
+		}
+	}
+	if( optind != argc - 1 || nth < 1 || nth > N_TH || Head.frames < 1 ){
+		usage( argv[ 0 ] ) ;
+		return 2 ;
+	}
+	initHead( &Head ) ;
+
+	if( !gen ){
+		//check: the frames and decoder setup come from the golden file
+		if( readGolden( argv[ optind ], &g, &gf ) != 0 )
+			return 2 ;
+		if( g.n != N || g.k != K || g.z != Z || g.hbm != Head.hbm ){
+			printf( "Golden FAIL: %s is of a different code.\n", argv[ optind ] ) ;
+			return 1 ;
+		}
+		if( !ber && ( strcmp( g.fp, Head.fp ) != 0 || g.qb != Head.qb || g.fpMax != Head.fpMax ) ){
+			printf( "Golden: %s is from a %s decoder, checking BER-equivalence only.\n", argv[ optind ], g.fp ) ;
+			ber = 1 ;
+		}
+		memcpy( ( void * )g.fp, ( void * )Head.fp, sizeof( g.fp ) ) ;
+		g.qb	= Head.qb ;
+		g.fpMax	= Head.fpMax ;
+		Head	= g ;
+	}
+
+	nf		= Head.np * Head.frames ;
+	llch	= ( FP * )calloc( ( size_t )nf * N, sizeof( FP ) ) ;
+	apll	= ( FP * )calloc( ( size_t )nf * N, sizeof( FP ) ) ;
+	f		= ( GD_FRAME * )calloc( ( size_t )nf, sizeof( GD_FRAME ) ) ;
+	if( llch == NULL || apll == NULL || f == NULL ){
+		printf( "Golden FAIL: out of memory.\n" ) ;
+		return 2 ;
+	}
+
+	if( lib ){
+		if( initLib() != 0 ){
+			printf( "Golden FAIL: libyaldpc: float builds only.\n" ) ;
+			return 2 ;
+		}
+		if( ( r = yaldpc_encoder_create( Lib, &enc ) ) != YALDPC_OK ){
+			printf( "Golden FAIL: libyaldpc: %s.\n", yaldpc_strerror( r ) ) ;
+			return 2 ;
+		}
+	}else if( !QCLDPCInitEncoder( ENC_ANNEXG ) && !QCLDPCInitEncoder( ENC_GENERIC ) ){
+		printf( "Golden FAIL: no encoder for this code.\n" ) ;
+		return 2 ;
+	}
+	MSInitDecoder( Head.nIter, ( FP )Head.norm, ( FP )Head.offset, Head.term ) ;
+
+	//frame j of point x: data and noise from RNG stream ( seed, x, j ), as in sim.c
+	for( x = 0 ; x < Head.np ; x++ ){
+		var = 1.0 / ( 2.0 * pow( 10.0, Head.ebn0[ x ] / 10.0 ) * ( double )K / ( double )N ) ;
+		for( j = 0 ; j < Head.frames ; j++ ){
+			RngFrame( &rng, Head.seed, ( uint32_t )x, ( uint64_t )j ) ;
+			SimData( &rng, data ) ;
+			if( enc != NULL )
+				yaldpc_encode( enc, ( const uint8_t * )data, ( uint8_t * )cw, 1 ) ;
+			else
+				QCLDPCEncodeCW( data, cw ) ;
+			SimChannel( &rng, cw, noise, llch + ( size_t )( x * Head.frames + j ) * N, ( float )sqrt( var ) ) ;
+		}
+	}
+
+	for( i = 0 ; i < nth ; i++ ){
+		th[ i ].t		= i ;
+		th[ i ].nth		= nth ;
+		th[ i ].nf		= nf ;
+		th[ i ].llch	= llch ;
+		th[ i ].apll	= apll ;
+		th[ i ].f		= f ;
+		th[ i ].err		= YALDPC_OK ;
+		if( pthread_create( &th[ i ].id, NULL, lib ? decodeThreadLib : batch ? decodeThreadBatch : decodeThread, ( void * )( th + i ) ) != 0 ){
+			printf( "Golden FAIL: decoder thread.\n" ) ;
+			return 2 ;
+		}
+	}
+	for( i = 0 ; i < nth ; i++ ){
+		pthread_join( th[ i ].id, NULL ) ;
+		if( th[ i ].err != YALDPC_OK ){
+			printf( "Golden FAIL: decoder: %s.\n", yaldpc_strerror( th[ i ].err ) ) ;
+			return 2 ;
+		}
+	}
+
+	//data bit errors, the data of a frame are generated again from its RNG stream
+	for( x = 0 ; x < Head.np ; x++ ){
+		for( j = 0 ; j < Head.frames ; j++ ){
+			RngFrame( &rng, Head.seed, ( uint32_t )x, ( uint64_t )j ) ;
+			SimData( &rng, data ) ;
+			for( i = 0 ; i < K ; i++ )
+				f[ x * Head.frames + j ].err += sign( apll[ ( size_t )( x * Head.frames + j ) * N + i ] ) != getBit( data, i ) ;
+		}
+	}
+
+	if( dump != NULL && writeDump( dump, &Head, llch, apll, f ) != 0 )
+		return 2 ;
+
+	if( gen ){
+		r = writeGolden( argv[ optind ], &Head, f ) != 0 ? 2 : 0 ;
+		if( r == 0 )
+			printf( "Golden: %d frames of a %s decoder written to %s.\n", nf, Head.fp, argv[ optind ] ) ;
+	}else{
+		r = ber ? checkBER( &Head, gf, f ) : checkExact( &Head, gf, f ) ;
+		printf( "Golden %s: %s, %d frames, %s, %d threads, %s%s kernels.\n", r ? "FAIL" : "OK", argv[ optind ], nf,
+			ber ? "BER-equivalence" : "bit-exact", nth, lib ? "libyaldpc, " : "", lib ? yaldpc_isa() : KernelISA() ) ;
+		if( lib && checkLib( argv[ optind ], llch, apll, f, nf ) != 0 )
+			r = 1 ;
+	}
+
+	yaldpc_encoder_free( enc ) ;
+	yaldpc_code_free( Lib ) ;
+	free( llch ) ;
+	free( apll ) ;
+	free( f ) ;
+	free( gf ) ;
+
+	return r ;
+}
+
+
+//local functions definitions---------------------------------------------------
+
+static void usage( const char *name ){
+	printf( "Usage: %s [ -g [ -e from:step:to ] [ -f frames ] [ -i nIter ] ] [ -b ] [ -B ] [ -y ] [ -t threads ] [ -d dumpFile ] goldenFile\n", name ) ;
+	printf( "  -g  write golden vectors of this build, otherwise check this build against goldenFile\n" ) ;
+	printf( "  -e  Eb/N0 points in dB, default: 1.0:1.5:4.0\n" ) ;
+	printf( "  -f  frames per point, default: %d\n", Head.frames ) ;
+	printf( "  -i  decoder iterations, early termination, default: %d\n", Head.nIter ) ;
+	printf( "  -b  check BER-equivalence only, default: bit-exact if goldenFile is of the same FP type\n" ) ;
+	printf( "  -B  decode the frames of a thread in batches of %d ( F_B ) layer by layer\n", F_B ) ;
+	printf( "  -y  encode and decode with libyaldpc, float builds only\n" ) ;
+	printf( "  -t  decoder threads 1 .. %d, > 1 needs decoderMT.c or -y\n", N_TH ) ;
+	printf( "  -d  also write channel LLRs, posterior LLRs and iterations to a binary file, see testGolden.m\n" ) ;
+}
+
+/*
+ * compiled-in code and FP type
+ * */
+static void initHead( GD_HEAD *h ){
+	h->n = N ;
+	h->k = K ;
+	h->z = Z ;
+
+	h->hbm = hbmHash( ( const int8_t * )HBM, MB * NB ) ;
+
+	snprintf( h->fp, sizeof( h->fp ), "%s", GD_FP ) ;
+	h->qb		= GD_QB ;
+	h->fpMax	= GD_FPMAX ;
+}
+
+/*
+ * frames t, t + nth, .. are decoded by thread t with its own decoder state
+ * */
+static void *decodeThread( void *arg ){
+	GD_THREAD *a = ( GD_THREAD * )arg ;
+	FP *ap ;
+	int j ;
+
+	for( j = a->t ; j < a->nf ; j += a->nth ){
+		ap = a->apll + ( size_t )j * N ;
+		a->f[ j ].iter	= MSDecode( a->llch + ( size_t )j * N, ap, a->t ) ;
+		a->f[ j ].conv	= MSConverged( a->t ) ;
+		a->f[ j ].hash	= fnv1a64( ( const uint8_t * )ap, N * sizeof( FP ) ) ;
+	}
+
+	return NULL ;
+}
+
+/*
+ * -B: frames t, t + nth, .. gathered into batches of F_B consecutive columns
+ * */
+static void *decodeThreadBatch( void *arg ){
+	GD_THREAD *a = ( GD_THREAD * )arg ;
+	FP *in, *out ;
+	int iter[ F_B ], fr[ F_B ] ;
+	int j, b, f ;
+
+	in	= ( FP * )malloc( sizeof( FP ) * N * F_B ) ;
+	out	= ( FP * )malloc( sizeof( FP ) * N * F_B ) ;
+	if( in == NULL || out == NULL ){
+		a->err = YALDPC_ENOMEM ;
+		free( in ) ;
+		free( out ) ;
+		return NULL ;
+	}
+
+	for( j = a->t ; j < a->nf ; ){
+		for( f = 0 ; f < F_B && j < a->nf ; f++, j += a->nth ){
+			fr[ f ] = j ;
+			memcpy( in + ( size_t )f * N, a->llch + ( size_t )j * N, sizeof( FP ) * N ) ;
+		}
+		if( MSDecodeBatchT( in, GD_LLR, out, GD_LLR, NULL, f, iter, a->t ) < 0 ){
+			a->err = YALDPC_EINVAL ;
+			break ;
+		}
+		for( b = 0 ; b < f ; b++ ){
+			memcpy( a->apll + ( size_t )fr[ b ] * N, out + ( size_t )b * N, sizeof( FP ) * N ) ;
+			a->f[ fr[ b ] ].iter	= iter[ b ] ;
+			a->f[ fr[ b ] ].conv	= MSConvergedBatch( a->t, b ) ;
+			a->f[ fr[ b ] ].hash	= fnv1a64( ( const uint8_t * )( out + ( size_t )b * N ), N * sizeof( FP ) ) ;
+		}
+	}
+
+	free( in ) ;
+	free( out ) ;
+	return NULL ;
+}
+
+/*
+ * -y: every thread has its own decoder of the shared code
+ * */
+static void *decodeThreadLib( void *arg ){
+	GD_THREAD *a = ( GD_THREAD * )arg ;
+	yaldpc_dec_params p ;
+	yaldpc_decoder *dec ;
+	FP *ap ;
+	int j ;
+
+	libParams( &p ) ;
+	if( ( a->err = yaldpc_decoder_create( Lib, &p, &dec ) ) != YALDPC_OK )
+		return NULL ;
+
+	for( j = a->t ; j < a->nf ; j += a->nth ){
+		ap = a->apll + ( size_t )j * N ;
+		a->f[ j ].conv	= yaldpc_decode( dec, ( const float * )( a->llch + ( size_t )j * N ), ( float * )ap, &a->f[ j ].iter, 1 ) ;
+		a->f[ j ].hash	= fnv1a64( ( const uint8_t * )ap, N * sizeof( FP ) ) ;
+	}
+
+	yaldpc_decoder_free( dec ) ;
+	return NULL ;
+}
+
+/*
+ * -y: the code of this build as a libyaldpc code with the layer schedule of this build
+ * ( SCHED, YALDPC_SCHED ), float unpacked builds only
+ * */
+static int initLib( void ){
+#if defined( FIXED ) || defined( BITMAP )
+	return -1 ;
+#else
+	if( yaldpc_code_create( MB, NB, Z, &HBM[ 0 ][ 0 ], &Lib ) != YALDPC_OK )
+		return -1 ;
+	KernelInit() ;
+	LibSched = strcmp( KernelSchedule(), "overlap" ) == 0 ? YALDPC_SCHED_OVERLAP : YALDPC_SCHED_NATURAL ;
+	if( yaldpc_code_schedule( Lib, LibSched ) != YALDPC_OK )
+		return -1 ;
+	return 0 ;
+#endif
+}
+
+static void libParams( yaldpc_dec_params *p ){
+	p->nIter	= Head.nIter ;
+	p->lambda	= ( float )Head.norm ;
+	p->beta		= ( float )Head.offset ;
+	p->early	= Head.term ;
+}
+
+/*
+ * -y: the API on GD_LIBF frames spread over all Eb/N0 points, gathered into one
+ * block, and the stream on all frames; each must decode like decodeThreadLib()
+ * */
+static int checkLib( const char *golden, const FP *llch, const FP *apll, const GD_FRAME *f, int nf ){
+	GD_FRAME g[ GD_LIBF ] ;
+	float *in, *ap ;
+	int i, j, fails ;
+
+	in	= ( float * )malloc( sizeof( float ) * N * GD_LIBF ) ;
+	ap	= ( float * )malloc( sizeof( float ) * N * GD_LIBF ) ;
+	if( in == NULL || ap == NULL ){
+		printf( "Golden FAIL: out of memory.\n" ) ;
+		free( in ) ;
+		free( ap ) ;
+		return 1 ;
+	}
+	for( i = 0 ; i < GD_LIBF ; i++ ){
+		j = ( int )( ( long )i * nf / GD_LIBF ) ;
+		g[ i ] = f[ j ] ;
+		memcpy( in + ( size_t )i * N, llch + ( size_t )j * N, sizeof( float ) * N ) ;
+		memcpy( ap + ( size_t )i * N, apll + ( size_t )j * N, sizeof( float ) * N ) ;
+	}
+
+	fails	= libFiles( in, g ) ;
+	fails	+= libTyped( in, ap, g ) ;
+	fails	+= libStream( llch, f, nf ) ;
+	fails	+= libStd( golden ) ;
+
+	printf( "Golden %s: libyaldpc code files, typed and bit decoding, stream order, %d standard codes%s.\n",
+		fails ? "FAIL" : "OK", GD_NSTD, fails ? ", see above" : "" ) ;
+	free( in ) ;
+	free( ap ) ;
+	return fails ;
+}
+
+/*
+ * GD_LIBF frames with a new decoder of c, the nr. of frames that differ from g
+ * */
+static int libDecode( const yaldpc_code *c, const float *in, const GD_FRAME *g ){
+	yaldpc_dec_params p ;
+	yaldpc_decoder *dec ;
+	float *ap ;
+	int iter[ GD_LIBF ] ;
+	int i, conv, bad = 0 ;
+
+	libParams( &p ) ;
+	if( ( ap = ( float * )malloc( sizeof( float ) * N * GD_LIBF ) ) == NULL || yaldpc_decoder_create( c, &p, &dec ) != YALDPC_OK ){
+		free( ap ) ;
+		return GD_LIBF ;
+	}
+
+	conv = yaldpc_decode( dec, in, ap, iter, GD_LIBF ) ;
+	for( i = 0 ; i < GD_LIBF ; i++ ){
+		bad += iter[ i ] != g[ i ].iter || fnv1a64( ( const uint8_t * )( ap + ( size_t )i * N ), N * sizeof( float ) ) != g[ i ].hash ;
+		conv -= g[ i ].conv ;
+	}
+
+	yaldpc_decoder_free( dec ) ;
+	free( ap ) ;
+	return bad > 0 ? bad : conv != 0 ;
+}
+
+/*
+ * -y: Lib saved and loaded again must decode and encode the same, a file without tables
+ * gets the schedule of Lib again; one byte changed, the file is rejected
+ * */
+static int libFiles( const float *in, const GD_FRAME *g ){
+	static const struct { int flags, inPlace ; const char *what ; } Files[ 3 ] = {
+		{ 0, 1, "hbm only" },
+		{ YALDPC_FILE_TABLES | YALDPC_FILE_PLAN, 1, "tables and plan in place" },
+		{ YALDPC_FILE_TABLES | YALDPC_FILE_PLAN, 0, "tables and plan made from hbm" } } ;
+	char name[] = "/tmp/goldenXXXXXX" ;
+	yaldpc_encoder *e0 = NULL, *e1 ;
+	yaldpc_code *c ;
+	WORD data[ GD_K ], cw0[ GD_N ], cw1[ GD_N ] ;
+	RNG rng ;
+	uint8_t *b ;
+	FILE *fh ;
+	long len ;
+	int fd, i, j, r, bad, fails = 0 ;
+
+	if( ( fd = mkstemp( name ) ) < 0 ){
+		printf( "Golden FAIL: libyaldpc: no temporary code file.\n" ) ;
+		return 1 ;
+	}
+	close( fd ) ;
+	if( yaldpc_encoder_create( Lib, &e0 ) != YALDPC_OK )
+		fails++ ;
+
+	for( i = 0 ; i < 3 && e0 != NULL ; i++ ){
+		if( !Files[ i ].inPlace )
+			setenv( "YALDPC_INPLACE", "0", 1 ) ;
+		if( ( r = yaldpc_code_save( Lib, name, Files[ i ].flags ) ) == YALDPC_OK )
+			r = yaldpc_code_load( name, &c ) ;
+		unsetenv( "YALDPC_INPLACE" ) ;
+		if( r == YALDPC_OK && Files[ i ].flags == 0 && ( r = yaldpc_code_schedule( c, LibSched ) ) != YALDPC_OK )
+			yaldpc_code_free( c ) ;
+		if( r != YALDPC_OK ){
+			printf( "Golden FAIL: libyaldpc code file, %s: %s.\n", Files[ i ].what, yaldpc_strerror( r ) ) ;
+			fails++ ;
+			continue ;
+		}
+
+		bad = libDecode( c, in, g ) ;
+		if( yaldpc_encoder_create( c, &e1 ) != YALDPC_OK ){
+			bad++ ;
+		}else{
+			for( j = 0 ; j < GD_LIBF ; j++ ){
+				RngFrame( &rng, Head.seed, 0, ( uint64_t )j ) ;
+				SimData( &rng, data ) ;
+				yaldpc_encode( e0, ( const uint8_t * )data, ( uint8_t * )cw0, 1 ) ;
+				yaldpc_encode( e1, ( const uint8_t * )data, ( uint8_t * )cw1, 1 ) ;
+				bad += memcmp( cw0, cw1, sizeof( cw0 ) ) != 0 ;
+			}
+			yaldpc_encoder_free( e1 ) ;
+		}
+		if( bad ){
+			printf( "Golden FAIL: libyaldpc code file, %s: %d frames differ.\n", Files[ i ].what, bad ) ;
+			fails++ ;
+		}
+		yaldpc_code_free( c ) ;
+	}
+
+	//the file with tables and plan is still there
+	b = NULL ;
+	r = YALDPC_EIO ;
+	if( ( fh = fopen( name, "r+b" ) ) != NULL ){
+		fseek( fh, 0, SEEK_END ) ;
+		len = ftell( fh ) ;
+		if( len > 0 && ( b = ( uint8_t * )malloc( ( size_t )len ) ) != NULL ){
+			rewind( fh ) ;
+			if( fread( b, 1, ( size_t )len, fh ) == ( size_t )len ){
+				b[ len / 2 ] ^= 1 ;
+				rewind( fh ) ;
+				r = fwrite( b, 1, ( size_t )len, fh ) == ( size_t )len ? YALDPC_OK : YALDPC_EIO ;
+			}
+		}
+		r = fclose( fh ) == 0 ? r : YALDPC_EIO ;
+	}
+	if( r == YALDPC_OK && ( r = yaldpc_code_load( name, &c ) ) == YALDPC_OK )
+		yaldpc_code_free( c ) ;
+	if( r != YALDPC_EFORMAT ){
+		printf( "Golden FAIL: libyaldpc code file with a wrong checksum: %s.\n", r == YALDPC_OK ? "loaded" : yaldpc_strerror( r ) ) ;
+		fails++ ;
+	}
+
+	free( b ) ;
+	remove( name ) ;
+	yaldpc_encoder_free( e0 ) ;
+	return fails ;
+}
+
+/*
+ * -y: double and integer LLRs in, double posteriors out, packed data bits: the same
+ * results as yaldpc_decode() of the same LLRs as floats; int16 and int8 are the
+ * floats quantized to 1 / 8 and 1 / 2, decoded like their float values
+ * */
+static int libTyped( const float *in, const float *ap, const GD_FRAME *g ){
+	static const struct { int type ; float scale, max ; const char *what ; } Types[ 3 ] = {
+		{ YALDPC_DOUBLE, 1.0f, 0.0f, "double" },
+		{ YALDPC_INT16, 0.125f, 32767.0f, "int16" },
+		{ YALDPC_INT8, 0.5f, 127.0f, "int8" } } ;
+	const size_t nl = ( size_t )N * GD_LIBF ;
+	yaldpc_dec_params p ;
+	yaldpc_decoder *dec ;
+	double *d = NULL ;
+	float *x = NULL, *y = NULL ;
+	int16_t *i16 = NULL ;
+	int8_t *i8 = NULL ;
+	uint8_t *bits = NULL ;
+	int iter[ GD_LIBF ], iter0[ GD_LIBF ] ;
+	size_t i ;
+	int t, j, k, conv, bad, fails = 0 ;
+	float v ;
+
+	libParams( &p ) ;
+	if( yaldpc_decoder_create( Lib, &p, &dec ) != YALDPC_OK ){
+		printf( "Golden FAIL: libyaldpc decoder.\n" ) ;
+		return 1 ;
+	}
+	d		= ( double * )malloc( sizeof( double ) * nl ) ;
+	x		= ( float * )malloc( sizeof( float ) * nl ) ;
+	y		= ( float * )malloc( sizeof( float ) * nl ) ;
+	i16		= ( int16_t * )malloc( sizeof( int16_t ) * nl ) ;
+	i8		= ( int8_t * )malloc( sizeof( int8_t ) * nl ) ;
+	bits	= ( uint8_t * )malloc( ( size_t )( K + 7 ) / 8 * GD_LIBF ) ;
+	if( d == NULL || x == NULL || y == NULL || i16 == NULL || i8 == NULL || bits == NULL ){
+		printf( "Golden FAIL: out of memory.\n" ) ;
+		fails++ ;
+		goto done ;
+	}
+
+	for( t = 0 ; t < 3 ; t++ ){
+		//the input and the floats it stands for, decoded by yaldpc_decode() for reference
+		for( i = 0 ; i < nl ; i++ ){
+			if( Types[ t ].type == YALDPC_DOUBLE ){
+				d[ i ] = ( double )in[ i ] ;
+				x[ i ] = in[ i ] ;
+				continue ;
+			}
+			v = roundf( in[ i ] / Types[ t ].scale ) ;
+			v = v > Types[ t ].max ? Types[ t ].max : v < -Types[ t ].max ? -Types[ t ].max : v ;
+			if( Types[ t ].type == YALDPC_INT16 )
+				i16[ i ] = ( int16_t )v ;
+			else
+				i8[ i ] = ( int8_t )v ;
+			x[ i ] = Types[ t ].scale * v ;
+		}
+		conv = yaldpc_decode( dec, x, y, iter0, GD_LIBF ) ;
+
+		//typed, float posteriors
+		bad = yaldpc_decode_typed( dec, Types[ t ].type == YALDPC_DOUBLE ? ( const void * )d : Types[ t ].type == YALDPC_INT16 ? ( const void * )i16 : ( const void * )i8,
+			Types[ t ].type, Types[ t ].scale, x, YALDPC_FLOAT, iter, GD_LIBF ) != conv ;
+		bad += memcmp( x, y, sizeof( float ) * nl ) != 0 ;
+		for( j = 0 ; j < GD_LIBF ; j++ )
+			bad += iter[ j ] != iter0[ j ] ;
+		if( bad ){
+			printf( "Golden FAIL: libyaldpc yaldpc_decode_typed( %s ) differs from yaldpc_decode().\n", Types[ t ].what ) ;
+			fails++ ;
+		}
+	}
+
+	//float in, double posteriors and the packed data bits of the golden frames
+	bad = yaldpc_decode_typed( dec, in, YALDPC_FLOAT, 1.0f, d, YALDPC_DOUBLE, iter, GD_LIBF ) < 0 ;
+	for( i = 0 ; i < nl ; i++ )
+		bad += d[ i ] != ( double )ap[ i ] ;
+	for( j = 0 ; j < GD_LIBF ; j++ )
+		bad += iter[ j ] != g[ j ].iter ;
+	if( bad ){
+		printf( "Golden FAIL: libyaldpc yaldpc_decode_typed() to double differs from the golden frames.\n" ) ;
+		fails++ ;
+	}
+
+	for( conv = 0, j = 0 ; j < GD_LIBF ; j++ )
+		conv += g[ j ].conv ;
+	bad = yaldpc_decode_bits( dec, in, YALDPC_FLOAT, 1.0f, bits, y, YALDPC_FLOAT, iter, GD_LIBF ) != conv ;
+	for( j = 0 ; j < GD_LIBF ; j++ ){
+		bad += iter[ j ] != g[ j ].iter ;
+		bad += memcmp( y + ( size_t )j * K, ap + ( size_t )j * N, sizeof( float ) * K ) != 0 ;
+		for( k = 0 ; k < K ; k++ )
+			bad += ( ( bits[ ( size_t )j * ( ( K + 7 ) / 8 ) + k / 8 ] >> ( 7 - k % 8 ) ) & 1U ) != sign( ap[ ( size_t )j * N + k ] ) ;
+	}
+	if( bad ){
+		printf( "Golden FAIL: libyaldpc yaldpc_decode_bits() differs from the golden frames.\n" ) ;
+		fails++ ;
+	}
+
+done:
+	yaldpc_decoder_free( dec ) ;
+	free( d ) ;
+	free( x ) ;
+	free( y ) ;
+	free( i16 ) ;
+	free( i8 ) ;
+	free( bits ) ;
+	return fails ;
+}
+
+/*
+ * -y: all frames through a stream of N_TH threads, up to GD_DEPTH in flight;
+ * early termination finishes them out of order, wait must return them in order
+ * */
+static int libStream( const FP *llch, const GD_FRAME *f, int nf ){
+	yaldpc_dec_params p ;
+	yaldpc_stream *s ;
+	float *ap ;
+	void *tag ;
+	int i, w, iter, conv, r = YALDPC_OK, bad = 0 ;
+
+	libParams( &p ) ;
+	if( ( ap = ( float * )malloc( sizeof( float ) * N * ( size_t )nf ) ) == NULL
+			|| ( r = yaldpc_stream_create( Lib, &p, N_TH, GD_DEPTH, &s ) ) != YALDPC_OK ){
+		printf( "Golden FAIL: libyaldpc stream: %s.\n", yaldpc_strerror( ap == NULL ? YALDPC_ENOMEM : r ) ) ;
+		free( ap ) ;
+		return 1 ;
+	}
+
+	for( i = 0, w = 0 ; w < nf ; ){
+		if( i < nf && i - w < GD_DEPTH && r == YALDPC_OK ){
+			r = yaldpc_stream_submit( s, ( const float * )( llch + ( size_t )i * N ), ap + ( size_t )i * N, ( void * )( intptr_t )i ) ;
+			i += r == YALDPC_OK ;
+			continue ;
+		}
+		if( w == i )
+			break ;
+		conv = yaldpc_stream_wait( s, &tag, &iter ) ;
+		bad += conv != f[ w ].conv || ( intptr_t )tag != w || iter != f[ w ].iter
+			|| fnv1a64( ( const uint8_t * )( ap + ( size_t )w * N ), N * sizeof( float ) ) != f[ w ].hash ;
+		w++ ;
+	}
+
+	yaldpc_stream_free( s ) ;
+	free( ap ) ;
+	if( r != YALDPC_OK )
+		printf( "Golden FAIL: libyaldpc stream: %s.\n", yaldpc_strerror( r ) ) ;
+	else if( bad )
+		printf( "Golden FAIL: libyaldpc stream: %d of %d frames out of order or different.\n", bad, nf ) ;
+	return r != YALDPC_OK || bad ;
+}
+
+/*
+ * -y: every code of yaldpc_code_get() against its line in GD_STD: mb, z and hbmHash()
+ * of the scaled base matrix as loadQCLDPC makes it, written by testGolden.m
+ * */
+static int libStd( const char *golden ){
+	const char *s = strrchr( golden, '/' ) ;
+	const yaldpc_code *c = NULL, *c2 = NULL ;
+	char name[ 4096 ], line[ 256 ], std[ 8 ], var ;
+	unsigned hash ;
+	FILE *fh ;
+	int sd, n, rnum, rden, mb, z, r, codes = 0, fails = 0 ;
+
+	snprintf( name, sizeof( name ), "%.*s%s", s != NULL ? ( int )( s - golden + 1 ) : 0, golden, GD_STD ) ;
+	if( ( fh = fopen( name, "r" ) ) == NULL ){
+		printf( "Golden FAIL: cannot read %s.\n", name ) ;
+		return 1 ;
+	}
+
+	while( fgets( line, sizeof( line ), fh ) != NULL ){
+		if( line[ 0 ] == '#' )
+			continue ;
+		if( sscanf( line, "%7s %d %d %d %c %d %d %x", std, &n, &rnum, &rden, &var, &mb, &z, &hash ) != 8 ){
+			printf( "Golden FAIL: %s is corrupt at code %d.\n", name, codes + 1 ) ;
+			fails++ ;
+			break ;
+		}
+		codes++ ;
+		sd = strcmp( std, "wifi" ) == 0 ? YALDPC_WIFI : strcmp( std, "wimax" ) == 0 ? YALDPC_WIMAX : 0 ;
+		var = var == '-' ? 0 : var ;
+		if( ( r = yaldpc_code_get( sd, rnum, rden, n, var, &c ) ) == YALDPC_OK )
+			r = yaldpc_code_get( sd, rnum, rden, n, var, &c2 ) ;
+		if( r != YALDPC_OK || c2 != c || c->mb != mb || c->z != z || hbmHash( c->hbm, c->mb * c->nb ) != ( uint32_t )hash ){
+			if( fails++ < GD_SHOW )
+				printf( "Golden FAIL: libyaldpc yaldpc_code_get( %s %d %d/%d %c ): %s.\n", std, n, rnum, rden, var ? var : '-',
+					r != YALDPC_OK ? yaldpc_strerror( r ) : c2 != c ? "not shared" : "differs from loadQCLDPC" ) ;
+		}
+	}
+	fclose( fh ) ;
+
+	if( codes != GD_NSTD ){
+		printf( "Golden FAIL: %s has %d codes, not %d.\n", name, codes, GD_NSTD ) ;
+		fails++ ;
+	}
+	return fails ;
+}
+
+/*
+ * text file: one header line, one line of Eb/N0 points, one line per frame:
+ * point frame iterations converged bitErrors hash
+ * */
+static int writeGolden( const char *name, const GD_HEAD *h, const GD_FRAME *f ){
+	FILE *fh ;
+	int x, j ;
+
+	if( ( fh = fopen( name, "w" ) ) == NULL ){
+		printf( "Golden FAIL: cannot write %s.\n", name ) ;
+		return -1 ;
+	}
+
+	fprintf( fh, "YALDPC-golden %d N %d K %d Z %d hbm %08x fp %s qb %d fpmax %d nIter %d norm %.17g offset %.17g term %d seed %llu frames %d\n",
+		GD_VERSION, h->n, h->k, h->z, h->hbm, h->fp, h->qb, h->fpMax, h->nIter, h->norm, h->offset, h->term,
+		( unsigned long long )h->seed, h->frames ) ;
+	fprintf( fh, "ebn0 %d", h->np ) ;
+	for( x = 0 ; x < h->np ; x++ )
+		fprintf( fh, " %.17g", h->ebn0[ x ] ) ;
+	fprintf( fh, "\n" ) ;
+
+	for( x = 0 ; x < h->np ; x++ ){
+		for( j = 0 ; j < h->frames ; j++, f++ ){
+			fprintf( fh, "%d %d %d %d %d %016llx\n", x, j, f->iter, f->conv, f->err, ( unsigned long long )f->hash ) ;
+		}
+	}
+
+	if( fclose( fh ) != 0 ){
+		printf( "Golden FAIL: cannot write %s.\n", name ) ;
+		return -1 ;
+	}
+	return 0 ;
+}
+
+static int readGolden( const char *name, GD_HEAD *h, GD_FRAME **f ){
+	unsigned long long seed, hash ;
+	FILE *fh ;
+	int v, x, j, i, nf ;
+
+	if( ( fh = fopen( name, "r" ) ) == NULL ){
+		printf( "Golden FAIL: cannot read %s.\n", name ) ;
+		return -1 ;
+	}
+
+	memset( ( void * )h, 0, sizeof( *h ) ) ;
+	if( fscanf( fh, "YALDPC-golden %d N %d K %d Z %d hbm %x fp %7s qb %d fpmax %d nIter %d norm %lf offset %lf term %d seed %llu frames %d",
+			&v, &h->n, &h->k, &h->z, &h->hbm, h->fp, &h->qb, &h->fpMax, &h->nIter, &h->norm, &h->offset, &h->term, &seed, &h->frames ) != 14
+		|| v != GD_VERSION || fscanf( fh, " ebn0 %d", &h->np ) != 1 || h->np < 1 || h->np > GD_MAXP || h->frames < 1 ){
+		printf( "Golden FAIL: %s is not a version %d golden file.\n", name, GD_VERSION ) ;
+		fclose( fh ) ;
+		return -1 ;
+	}
+	h->seed = ( uint64_t )seed ;
+	for( x = 0 ; x < h->np ; x++ ){
+		if( fscanf( fh, "%lf", h->ebn0 + x ) != 1 ){
+			printf( "Golden FAIL: %s is truncated.\n", name ) ;
+			fclose( fh ) ;
+			return -1 ;
+		}
+	}
+
+	nf = h->np * h->frames ;
+	if( ( *f = ( GD_FRAME * )calloc( ( size_t )nf, sizeof( GD_FRAME ) ) ) == NULL ){
+		fclose( fh ) ;
+		return -1 ;
+	}
+	for( i = 0 ; i < nf ; i++ ){
+		if( fscanf( fh, "%d %d %d %d %d %llx", &x, &j, &( *f )[ i ].iter, &( *f )[ i ].conv, &( *f )[ i ].err, &hash ) != 6
+			|| x * h->frames + j != i ){
+			printf( "Golden FAIL: %s is truncated or corrupt at frame %d.\n", name, i ) ;
+			fclose( fh ) ;
+			return -1 ;
+		}
+		( *f )[ i ].hash = ( uint64_t )hash ;
+	}
+
+	fclose( fh ) ;
+	return 0 ;
+}
+
+/*
+ * binary, native byte order: int32 N, frames, sizeof( FP ), channel LLRs N x frames,
+ * posterior LLRs N x frames, int32 iterations[ frames ]
+ * */
+static int writeDump( const char *name, const GD_HEAD *h, const FP *llch, const FP *apll, const GD_FRAME *f ){
+	int32_t v[ 3 ] ;
+	FILE *fh ;
+	int i, nf = h->np * h->frames, ok ;
+
+	if( ( fh = fopen( name, "wb" ) ) == NULL ){
+		printf( "Golden FAIL: cannot write %s.\n", name ) ;
+		return -1 ;
+	}
+
+	v[ 0 ] = N ;
+	v[ 1 ] = nf ;
+	v[ 2 ] = ( int32_t )sizeof( FP ) ;
+	ok = fwrite( v, sizeof( v ), 1, fh ) == 1 ;
+	ok = ok && fwrite( llch, sizeof( FP ) * N, ( size_t )nf, fh ) == ( size_t )nf ;
+	ok = ok && fwrite( apll, sizeof( FP ) * N, ( size_t )nf, fh ) == ( size_t )nf ;
+	for( i = 0 ; ok && i < nf ; i++ ){
+		v[ 0 ] = f[ i ].iter ;
+		ok = fwrite( v, sizeof( int32_t ), 1, fh ) == 1 ;
+	}
+
+	if( fclose( fh ) != 0 || !ok ){
+		printf( "Golden FAIL: cannot write %s.\n", name ) ;
+		return -1 ;
+	}
+	return 0 ;
+}
+
+/*
+ * same iterations, convergence, bit errors and posterior LLRs for every frame
+ * */
+static int checkExact( const GD_HEAD *h, const GD_FRAME *g, const GD_FRAME *f ){
+	int i, bad = 0, nf = h->np * h->frames ;
+
+	for( i = 0 ; i < nf ; i++ ){
+		if( f[ i ].iter == g[ i ].iter && f[ i ].conv == g[ i ].conv && f[ i ].err == g[ i ].err && f[ i ].hash == g[ i ].hash )
+			continue ;
+		if( bad++ < GD_SHOW ){
+			printf( "  Eb/N0 %.2f frame %d: iterations %d / %d, converged %d / %d, bit errors %d / %d, posteriors %s\n",
+				h->ebn0[ i / h->frames ], i % h->frames, f[ i ].iter, g[ i ].iter, f[ i ].conv, g[ i ].conv,
+				f[ i ].err, g[ i ].err, f[ i ].hash == g[ i ].hash ? "equal" : "differ" ) ;
+		}
+	}
+	if( bad > 0 )
+		printf( "  %d of %d frames differ from the golden vectors ( this build / golden ).\n", bad, nf ) ;
+
+	return bad > 0 ;
+}
+
+/*
+ * per point: this build is BER-equivalent if its BER and FER 95 % intervals
+ * overlap those of the golden vectors or lie below them
+ * */
+static int checkBER( const GD_HEAD *h, const GD_FRAME *g, const GD_FRAME *f ){
+	SIM_COUNTERS cg, cf ;
+	SIM_CI ig, in ;
+	int x, bad = 0 ;
+
+	for( x = 0 ; x < h->np ; x++ ){
+		counters( h, g, x, &cg ) ;
+		counters( h, f, x, &cf ) ;
+		SimInterval( &cg, &ig ) ;
+		SimInterval( &cf, &in ) ;
+
+		printf( "  Eb/N0 %.2f: BER %e [ %e %e ] golden %e [ %e %e ], FER %e golden %e, iterations %.2f golden %.2f\n",
+			h->ebn0[ x ], in.ber, in.berLo, in.berHi, ig.ber, ig.berLo, ig.berHi, in.fer, ig.fer,
+			( double )cf.iter / ( double )cf.frames, ( double )cg.iter / ( double )cg.frames ) ;
+
+		if( in.berLo > ig.berHi || in.ferLo > ig.ferHi ){
+			printf( "  Eb/N0 %.2f: worse than the golden vectors.\n", h->ebn0[ x ] ) ;
+			bad++ ;
+		}
+	}
+
+	return bad > 0 ;
+}
+
+static void counters( const GD_HEAD *h, const GD_FRAME *f, int x, SIM_COUNTERS *c ){
+	int j ;
+
+	memset( ( void * )c, 0, sizeof( *c ) ) ;
+	c->ebn0		= h->ebn0[ x ] ;
+	c->point	= ( uint32_t )x ;
+	for( j = 0, f += x * h->frames ; j < h->frames ; j++, f++ ){
+		c->bitErr	+= ( uint64_t )f->err ;
+		c->bitErr2	+= ( uint64_t )f->err * ( uint64_t )f->err ;
+		c->frameErr	+= f->err > 0 ;
+		c->iter		+= ( uint64_t )f->iter ;
+		c->frames++ ;
+	}
+}
+
+//hash of the base matrix, int8 shifts row by row, as in the golden file header and GD_STD
+static uint32_t hbmHash( const int8_t *h, int len ){
+	uint32_t v = 0 ;
+	int j ;
+
+	for( j = 0 ; j < len ; j++ ){
+		v = v * 31U + ( uint32_t )h[ j ] ;
+	}
+	return v ;
+}
+
+static uint64_t fnv1a64( const uint8_t *b, size_t len ){
+	uint64_t h = 14695981039346656037ULL ;
+	size_t i ;
+
+	for( i = 0 ; i < len ; i++ ){
+		h = ( h ^ b[ i ] ) * 1099511628211ULL ;
+	}
+	return h ;
+}
+
+static unsigned getBit( WORD *v, int i ){
+	#ifdef BITMAP
+		return ( unsigned )( v[ i >> WBE ] >> ( WB - 1 - ( i & ( WB - 1 ) ) ) ) & 1U ;
+	#else
+		return ( unsigned )v[ i ] ;
+	#endif
+}
@@ -0,0 +1,246 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+#include "ldpc.h"
+#include "kernel.h"
+
+#define K_SIGN( x ) ( ( x ) < 0 ? 1U : 0U )
+#define K_MAG( x )  ( ( x ) >= 0 ? ( x ) : -( x ) )
+#define K_MAX( x, y ) ( ( x ) > ( y ) ? ( x ) : ( y ) )
+#if defined( __GNUC__ )
+	#define K_POPCOUNT64( x ) ( ( uint64_t )__builtin_popcountll( x ) )
+#else
+	//SWAR bit count for compilers without __builtin_popcountll
+	static uint64_t popcount64( uint64_t x ){
+		x = x - ( ( x >> 1 ) & 0x5555555555555555ULL ) ;
+		x = ( x & 0x3333333333333333ULL ) + ( ( x >> 2 ) & 0x3333333333333333ULL ) ;
+		x = ( x + ( x >> 4 ) ) & 0x0F0F0F0F0F0F0F0FULL ;
+		return ( x * 0x0101010101010101ULL ) >> 56 ;
+	}
+	#define K_POPCOUNT64( x ) popcount64( x )
+#endif
+
+//index tables of HBM: nonzero blocks of every layer, filled by KernelInit()
+static int KDeg[ MB ] ;
+static int16_t KCol[ MB ][ NB ] ;
+static int16_t KShift[ MB ][ NB ] ;
+
+int16_t KOrder[ MB ] ;
+
+#include "schedule.inc"
+
+//the compiled-in code of ldpc.h, see kernel.inc
+#define KZ Z
+#define KN N
+#define KMB MB
+#define KDEG( mb ) KDeg[ mb ]
+#define KCOL( mb, i ) KCol[ mb ][ i ]
+#define KSHIFT( mb, i ) KShift[ mb ][ i ]
+#define KPARAM
+#define KROTATE
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+	#define KERNEL_X86		//GCC and clang: target attributes and __builtin_cpu_supports()
+#endif
+
+//scalar: the reference, not vectorized where the SIMD variants exist
+#define KFN( f ) f##_scalar
+#if defined( KERNEL_X86 ) && !defined( __clang__ )
+	#define KATTR __attribute__(( optimize( "no-tree-vectorize" ) ))
+#else
+	#define KATTR
+#endif
+#include "kernel.inc"
+#undef KFN
+#undef KATTR
+
+/*
+ * SIMD variants: the loops vectorize at -O2 too ( the MEX -O build ), where GCC
+ * otherwise only vectorizes the cheapest of them; clang does at -O2 anyway
+ * */
+#if defined( KERNEL_X86 ) && !defined( __clang__ )
+	#define KSIMD( isa ) __attribute__(( target( isa ), optimize( "tree-vectorize" ) ))
+#elif defined( KERNEL_X86 )
+	#define KSIMD( isa ) __attribute__(( target( isa ) ))
+#endif
+
+#ifdef KERNEL_X86
+	#define KFN( f ) f##_sse42
+	#define KATTR KSIMD( "sse4.2,popcnt" )
+	#include "kernel.inc"
+	#undef KFN
+	#undef KATTR
+
+	#define KFN( f ) f##_avx2
+	#define KATTR KSIMD( "avx2,popcnt" )
+	#include "kernel.inc"
+	#undef KFN
+	#undef KATTR
+
+	#define KFN( f ) f##_avx512
+	#define KATTR KSIMD( "avx512f,avx512bw,avx512vl,popcnt" )
+	#include "kernel.inc"
+	#undef KFN
+	#undef KATTR
+#endif
+
+#define KERNEL_SET( isa, sfx ) { isa, layerMinSum##sfx, rotateLayout##sfx, sumTiers##sfx, hardDecision##sfx, orthogonal##sfx, loadLLR##sfx, storeLLR##sfx, packBits##sfx, packBytes##sfx, unpackBits##sfx, bitErrors##sfx, rotateBits##sfx, signBitmap##sfx }
+
+static const KERNELS Variants[ ISA_COUNT ] = {
+	KERNEL_SET( ISA_SCALAR, _scalar ),
+	#ifdef KERNEL_X86
+		KERNEL_SET( ISA_SSE42, _sse42 ),
+		KERNEL_SET( ISA_AVX2, _avx2 ),
+		KERNEL_SET( ISA_AVX512, _avx512 )
+	#endif
+} ;
+
+static const char *ISAName[ ISA_COUNT ] = { "scalar", "sse4.2", "avx2", "avx512" } ;
+static const char *SchedName[ 2 ] = { "natural", "overlap" } ;
+static int Sched = -1 ;		// schedule in KOrder, -1 > none yet
+
+KERNELS Kern = KERNEL_SET( ISA_SCALAR, _scalar ) ;
+
+static int cpuISA( void ) ;
+static int envISA( void ) ;
+static int envSched( void ) ;
+static void initIndex( void ) ;
+
+
+//global functions definitions-------------------------------------------------
+
+void KernelInit( void ){
+	int isa, env ;
+
+	isa = cpuISA() ;
+	env = envISA() ;
+	if( env >= 0 && env < isa )
+		isa = env ;		//never above what the CPU runs
+
+	Kern = Variants[ isa ] ;
+	initIndex() ;
+}
+
+const char *KernelISA( void ){
+	return ISAName[ Kern.isa ] ;
+}
+
+const char *KernelSchedule( void ){
+	return SchedName[ Sched < 0 ? LS_NATURAL : Sched ] ;
+}
+
+//local functions definitions---------------------------------------------------
+
+/*
+ * best instruction set of this CPU
+ * */
+static int cpuISA( void ){
+	#ifdef KERNEL_X86
+		__builtin_cpu_init() ;
+
+		if( !__builtin_cpu_supports( "popcnt" ) )
+			return ISA_SCALAR ;
+		if( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ) && __builtin_cpu_supports( "avx512vl" ) )
+			return ISA_AVX512 ;
+		if( __builtin_cpu_supports( "avx2" ) )
+			return ISA_AVX2 ;
+		if( __builtin_cpu_supports( "sse4.2" ) )
+			return ISA_SSE42 ;
+	#endif
+	return ISA_SCALAR ;
+}
+
+/*
+ * instruction set requested by YALDPC_ISA, -1 if not set or unknown
+ * */
+static int envISA( void ){
+	const char *e = getenv( "YALDPC_ISA" ) ;
+	int i ;
+
+	if( e == NULL )
+		return -1 ;
+
+	if( strcmp( e, "sse42" ) == 0 )
+		return ISA_SSE42 ;
+	for( i = 0 ; i < ISA_COUNT ; i++ ){
+		if( strcmp( e, ISAName[ i ] ) == 0 )
+			return i ;
+	}
+	return -1 ;
+}
+
+/*
+ * layer schedule requested by YALDPC_SCHED, SCHED of ldpc.h if not set or unknown
+ * */
+static int envSched( void ){
+	const char *e = getenv( "YALDPC_SCHED" ) ;
+
+	if( e != NULL && strcmp( e, SchedName[ LS_NATURAL ] ) == 0 )
+		return LS_NATURAL ;
+	if( e != NULL && strcmp( e, SchedName[ LS_OVERLAP ] ) == 0 )
+		return LS_OVERLAP ;
+	return SCHED == LS_OVERLAP ? LS_OVERLAP : LS_NATURAL ;
+}
+
+/*
+ * index tables and layer schedule, the schedule only when it changed
+ * */
+static void initIndex( void ){
+	int mb, c, s ;
+
+	for( mb = 0 ; mb < MB ; mb++ ){
+		for( KDeg[ mb ] = 0, c = 0 ; c < NB ; c++ ){
+			if( HBM[ mb ][ c ] < 0 )
+				continue ;
+			KCol[ mb ][ KDeg[ mb ] ]	= ( int16_t )c ;
+			KShift[ mb ][ KDeg[ mb ] ]	= HBM[ mb ][ c ] ;
+			KDeg[ mb ]++ ;
+		}
+	}
+
+	if( ( s = envSched() ) != Sched ){
+		layerSchedule( s, MB, NB, &HBM[ 0 ][ 0 ], KOrder ) ;
+		Sched = s ;
+	}
+}
@@ -0,0 +1,142 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Hot loops of the decoder and the bitmap encoder, built for several
+	instruction sets in one binary: scalar, SSE4.2, AVX2 and AVX-512, the
+	last three with popcnt.
+	KernelInit() picks the best one the CPU supports ( cpuid ), environment
+	variable YALDPC_ISA = scalar | sse4.2 | avx2 | avx512 selects a lower one
+	for testing. Non-x86 builds and compilers without target attributes have
+	only the scalar kernels. All variants give identical results.
+
+	The layers are decoded in the order of KOrder: SCHED of ldpc.h, environment
+	variable YALDPC_SCHED = natural | overlap overrides it, see schedule.inc.
+
+	Needs ldpc.h included before.
+*/
+
+#ifndef QCLDPCKERNEL
+#define QCLDPCKERNEL
+
+#ifndef SCHED
+	#define SCHED 0		// natural layer schedule, for older ldpc.h
+#endif
+
+enum {
+	ISA_SCALAR = 0,
+	ISA_SSE42,
+	ISA_AVX2,
+	ISA_AVX512,
+	ISA_COUNT
+} ;
+
+//element types of channel LLRs and posteriors, see loadLLR and storeLLR
+enum {
+	LLR_SINGLE = 0,
+	LLR_DOUBLE,
+	LLR_INT16,
+	LLR_INT8
+} ;
+
+#define LLR_SIZE( type ) ( ( type ) == LLR_DOUBLE ? sizeof( double ) : ( type ) == LLR_SINGLE ? sizeof( float ) : \
+	( type ) == LLR_INT16 ? sizeof( int16_t ) : sizeof( int8_t ) )
+
+typedef struct kernels {
+	int isa ;
+
+	/*
+		min-sum update of all Z checks of layer mb, see MSDecode()
+		zold - posteriors in the rotation layout, zt - tier of layer mb, written where HBM[ mb ][ . ] >= 0
+		lm0, lm1, ls, li - min1, min2, sign bitmaps and min1 index of the Z checks
+	*/
+	void ( *layerMinSum )( int mb, int iter, const FP *zold, FP *zt, FP *lm0, FP *lm1, uint32_t *ls, uint8_t *li, FP lambda, FP beta ) ;
+
+	// posteriors z to the rotation layout of layerMinSum, every block twice, zr is 2 N
+	void ( *rotateLayout )( const FP *z, FP *zr ) ;
+
+	// znew += zt[ mb ][ . ] for all MB tiers, zt is MB x N
+	void ( *sumTiers )( FP *znew, const FP *zt ) ;
+
+	// hd[ n ] = 1 if z[ n ] < 0, N values, array ( not bitmap ) WORDs
+	void ( *hardDecision )( const FP *z, WORD *hd ) ;
+
+	// 1 if hard decision hd satisfies all checks of HBM
+	int ( *orthogonal )( const WORD *hd ) ;
+
+	// channel LLRs of type LLR_* to FP, N values to llr and z in one pass, integers times scale ( float only )
+	void ( *loadLLR )( const void *in, int type, float scale, FP *llr, FP *z ) ;
+
+	// first n posteriors z to LLR_SINGLE, LLR_DOUBLE or LLR_INT16 ( fixed point only )
+	void ( *storeLLR )( const FP *z, void *out, int type, int n ) ;
+
+	// hard decisions of the first n values of z packed MSB first, ( n + 7 ) / 8 bytes
+	void ( *packBits )( const FP *z, uint8_t *bits, int n ) ;
+
+	// nonzero bytes of v packed like packBits, ( n + 7 ) / 8 bytes
+	void ( *packBytes )( const uint8_t *v, uint8_t *bits, int n ) ;
+
+	// the first n bits of a packBits bitmap to bytes 0 / 1
+	void ( *unpackBits )( const uint8_t *bits, uint8_t *v, int n ) ;
+
+	// nr. of different bits of two bitmaps of nb bytes, popcount
+	uint64_t ( *bitErrors )( const uint8_t *a, const uint8_t *b, int nb ) ;
+
+	// bitmap block rotation, 0 < shift < Z already checked, see baROR()
+	void ( *rotateBits )( const WORD *v, WORD *res, int shift ) ;
+
+	// hard decisions of n values of z to a bitmap, WB per WORD MSB first, n a multiple of WB
+	void ( *signBitmap )( const FP *z, WORD *w, int n ) ;
+} KERNELS ;
+
+// 	kernels in use, scalar until KernelInit()
+extern KERNELS Kern ;
+
+// 	select kernels for this CPU and YALDPC_ISA, index tables and layer schedule of HBM, can be called repeatedly
+extern void KernelInit( void ) ;
+
+// 	name of the selected instruction set
+extern const char *KernelISA( void ) ;
+
+// 	layer schedule of the decoders, layer l of an iteration is KOrder[ l ], set by KernelInit()
+extern int16_t KOrder[ MB ] ;
+
+// 	name of the layer schedule, natural or overlap
+extern const char *KernelSchedule( void ) ;
+
+#endif
@@ -0,0 +1,145 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+#define _POSIX_C_SOURCE 200809L	//clock_gettime
+
+#include <time.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "latency.h"
+
+static int bucketOf( uint64_t v ) ;
+static uint64_t bucketHigh( int i ) ;
+
+
+//global functions definitions-------------------------------------------------
+
+uint64_t LatNow( void ){
+	struct timespec ts ;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts ) ;
+
+	return ( uint64_t )ts.tv_sec * 1000000000ULL + ( uint64_t )ts.tv_nsec ;
+}
+
+void LatReset( LAT_HIST *h ){
+	memset( ( void * )h, 0, sizeof( *h ) ) ;
+	h->min = UINT64_MAX ;
+}
+
+void LatRecord( LAT_HIST *h, uint64_t ns ){
+	h->bucket[ bucketOf( ns ) ]++ ;
+	h->count++ ;
+	h->sum += ns ;
+	if( ns < h->min )
+		h->min = ns ;
+	if( ns > h->max )
+		h->max = ns ;
+}
+
+void LatMerge( LAT_HIST *dst, const LAT_HIST *src ){
+	int i ;
+
+	for( i = 0 ; i < LAT_BUCKETS ; i++ )
+		dst->bucket[ i ] += src->bucket[ i ] ;
+	dst->count	+= src->count ;
+	dst->sum	+= src->sum ;
+	if( src->min < dst->min )
+		dst->min = src->min ;
+	if( src->max > dst->max )
+		dst->max = src->max ;
+}
+
+uint64_t LatQuantile( const LAT_HIST *h, double q ){
+	uint64_t rank, c ;
+	int i ;
+
+	if( h->count == 0 )
+		return 0 ;
+
+	//nr. of frames at or below the quantile, nearest rank
+	rank = ( uint64_t )( q * ( double )h->count + 0.999999 ) ;
+	if( rank < 1 )
+		return h->min ;
+	if( rank >= h->count )
+		return h->max ;
+
+	for( c = 0, i = 0 ; i < LAT_BUCKETS ; i++ ){
+		c += h->bucket[ i ] ;
+		if( c >= rank )
+			break ;
+	}
+	c = bucketHigh( i ) ;
+
+	return c < h->min ? h->min : ( c > h->max ? h->max : c ) ;
+}
+
+
+//local functions definitions---------------------------------------------------
+
+/*
+ * values below 2 * LAT_SUB have their own bucket, above that a power of 2
+ * [ 2^e, 2^(e+1) ) is split into LAT_SUB buckets of width 2^( e - LAT_SUB_BITS )
+ * */
+static int bucketOf( uint64_t v ){
+	int e, s ;
+
+	if( v >= ( 1ULL << LAT_MAX_BITS ) )
+		v = ( 1ULL << LAT_MAX_BITS ) - 1 ;
+	if( v < LAT_SUB )
+		return ( int )v ;
+
+	for( e = LAT_SUB_BITS ; ( v >> ( e + 1 ) ) != 0 ; e++ )
+		;
+	s = e - LAT_SUB_BITS ;
+
+	return ( ( s + 1 ) << LAT_SUB_BITS ) | ( int )( ( v >> s ) & ( LAT_SUB - 1 ) ) ;
+}
+
+// 	largest value in bucket i
+static uint64_t bucketHigh( int i ){
+	int s ;
+
+	if( i < 2 * LAT_SUB )
+		return ( uint64_t )i ;
+
+	s = ( i >> LAT_SUB_BITS ) - 1 ;
+
+	return ( ( ( uint64_t )( ( i & ( LAT_SUB - 1 ) ) | LAT_SUB ) << s ) + ( 1ULL << s ) ) - 1 ;
+}
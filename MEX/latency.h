@@ -0,0 +1,81 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Per-frame decoder latency: CLOCK_MONOTONIC time stamps in ns and
+	log-linear histograms, LAT_SUB sub-buckets per power of 2, so every
+	bucket is at most 1 / LAT_SUB ( ~3 % ) wide relative to its value.
+
+	A histogram is owned by one thread, LatRecord() takes no locks.
+	Histograms of all threads are merged by LatMerge() after they joined.
+*/
+
+#ifndef QCLDPCLAT
+#define QCLDPCLAT
+
+#define LAT_SUB_BITS	5
+#define LAT_SUB			( 1 << LAT_SUB_BITS )		// linear sub-buckets per power of 2
+#define LAT_MAX_BITS	40							// longer latencies ( ~18 minutes ) are clamped
+#define LAT_BUCKETS		( ( LAT_MAX_BITS - LAT_SUB_BITS + 1 ) << LAT_SUB_BITS )
+
+typedef struct lat_hist {
+	uint64_t	count ;					// nr. of recorded frames
+	uint64_t	sum ;					// ns
+	uint64_t	min ;					// ns
+	uint64_t	max ;					// ns
+	uint64_t	bucket[ LAT_BUCKETS ] ;
+} LAT_HIST ;
+
+// 	monotonic time stamp in ns
+extern uint64_t LatNow( void ) ;
+
+extern void LatReset( LAT_HIST *h ) ;
+
+//	add one frame latency in ns
+extern void LatRecord( LAT_HIST *h, uint64_t ns ) ;
+
+//	dst += src
+extern void LatMerge( LAT_HIST *dst, const LAT_HIST *src ) ;
+
+/*
+	latency in ns below which fraction q of the frames are, e.g. q = 0.999 > p99.9
+	upper bound of the bucket, exact for min and max, 0 if h is empty
+*/
+extern uint64_t LatQuantile( const LAT_HIST *h, double q ) ;
+
+#endif
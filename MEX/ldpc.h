@@ -47,6 +47,8 @@ typedef BLOCK *BLOCK_P ;
 typedef float FP ; 
 #define FP_MAX FLT_MAX
 #define N_TH 32 //nr. of decoder threads
+#define F_B 1 //frames per thread decoded layer by layer together
+#define SCHED 0 //layer schedule: 0 > natural, 1 > fewest columns shared by consecutive layers, see schedule.inc
 
 //Definitions for MEX:
 
@@ -36,21 +36,36 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 ========================================================================== */
 
+#define _POSIX_C_SOURCE 200809L	//getopt
+
 #include <stdio.h>
 #include <time.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 #include "ldpc.h"
 #include "debug.h"
 #include "encoder.h"
 #include "decoder.h"
+#include "rng.h"
+#include "demap.h"
+#include "sim.h"
+#include "latency.h"
+#include "perf.h"
+#include "benchcmp.h"
+#include "kernel.h"
 
 int n, k, m, z ;
 int b = 1000 ;	//block size
-int r = 1000 ; //rounds to run
-WORD *data, *code, *acc ;
+int r = 1000 ; //encoder rounds to run
+int rd = 100 ;	//decoder rounds to run
+WORD *data, *code, *acc, *hard ;
 FP *llch, *apll ;
 
 int benchE = 0 ;	//benchmark encoder
@@ -60,43 +75,534 @@ int NIter 	= 10 ;
 FP Norm 	= 1.0f ;
 FP Offs 	= 0.0f ;
 int Term 	= 0	;	// 0 > max, 1 > early
+double BenchEbN0 = 3.0 ;	// Eb/N0 of the benchmark channel in dB, without -e
+int BenchPoints	= 0 ;		// 1 > benchmark the decoder at every -e point
+const char *Format	= NULL ;	// benchmark report: NULL > text, "csv" or "json"
+const char *Label	= "" ;		// benchmark report: name of the code, e.g. wifi_1944_3/4
+int Perf			= 0 ;		// 1 > hardware performance counters around the decoder threads
+int Runs			= 1 ;		// benchmark runs per Eb/N0 point, mean and std. deviation are reported
+const char *Baseline	= NULL ;	// benchmark CSV to compare with, NULL > no comparison
+double Threshold	= 5.0 ;		// regression threshold in %
+
+//native simulation, see sim.h
+int simulate	= 0 ;	//run simulation instead of benchmark
+double EbN0From	= 1.0 ;
+double EbN0Step	= 0.5 ;
+double EbN0To	= 3.0 ;
+SIM_PARAMS Sim	= { .minErr = 100, .blkSize = 10 * N_TH, .threads = 1, .seed = 1, .ckptPeriod = 60.0 } ;
+int Workers		= 0 ;	//sharded sweep: nr. of local worker processes, 0 > off
+
+int benchmark( void ) ;
+
+void usage( const char *name ){
+	printf( "Usage: %s [ -s [ -e from:step:to ] [ -m minErr ] [ -f maxFrames ] [ -b blkSize ] [ -r seed ] [ -t threads ] [ -c relCI [ -l ferFloor ] ] [ -k ckptFile [ -p ckptPeriod ] [ -w workers ] ] [ -q bits [ -x ] ] ] [ -z ]\n", name ) ;
+	printf( "       %s [ -e from:step:to ] [ -t threads ] [ -d rounds ] [ -E ] [ -P ] [ -R runs ] [ -o csv | json [ -L label ] ] [ -C baseline [ -T pct ] ] [ -z ]\n", name ) ;
+	printf( "  no -s: encoder/decoder benchmark, BPSK over AWGN at %.2f dB or every -e point, -t threads\n", BenchEbN0 ) ;
+	printf( "      -d decoder rounds over %d codewords, default: %d, -E early termination, default: all %d iterations\n", b, rd, NIter ) ;
+	printf( "      -o csv or json report, -L label of the code in the report\n" ) ;
+	printf( "      reports throughput and p50/p90/p99/p99.9 per-frame decode latency of converged and not converged frames\n" ) ;
+	printf( "      -P also cycles, instructions, L1D / LLC misses and branch misses per decoded bit ( Linux perf_event_open )\n" ) ;
+	printf( "      -R runs per point, mean and std. deviation of throughput and p99 latency, default: %d\n", Runs ) ;
+	printf( "      -C compare with a baseline written by -o csv, exit status 2 if throughput or p99 latency regressed\n" ) ;
+	printf( "         by more than -T percent, default: %.0f, and significantly over the runs ( Welch t-test, 95 %% )\n", Threshold ) ;
+	printf( "  -s  run native BER/FER simulation for BPSK over AWGN, early termination\n" ) ;
+	printf( "  -e  Eb/N0 points in dB, default: %.2f:%.2f:%.2f\n", EbN0From, EbN0Step, EbN0To ) ;
+	printf( "  -m  min. nr. of bit errors per point, default: %llu\n", ( unsigned long long )Sim.minErr ) ;
+	printf( "  -f  max. nr. of frames per point, 0 > unlimited, default: %llu\n", ( unsigned long long )Sim.maxFrames ) ;
+	printf( "  -b  frames between stopping checks, default: %d\n", Sim.blkSize ) ;
+	printf( "  -r  RNG seed, default: %llu\n", ( unsigned long long )Sim.seed ) ;
+	printf( "  -t  nr. of threads 1 .. %d, > 1 needs decoderMT.c, default: %d\n", N_TH, Sim.threads ) ;
+	printf( "  -c  adaptive sweep: stop points at this relative 95 %% interval half-width, effort goes to the widest\n" ) ;
+	printf( "  -l  adaptive sweep: stop points whose FER upper bound is below this, -c needs -f or -l\n" ) ;
+	printf( "  -k  checkpoint file, an existing checkpoint of the same configuration is resumed\n" ) ;
+	printf( "  -p  seconds between checkpoints, default: %.0f\n", Sim.ckptPeriod ) ;
+	printf( "  -w  sharded sweep over this many worker processes with checkpoints ckptFile.0 .., merged in the end\n" ) ;
+	printf( "  -q  Gray-mapped QAM instead of BPSK, bits per symbol: 2, 4 .. %d ( 4 .. 1024-QAM )\n", QAM_MAX_BITS ) ;
+	printf( "  -x  exact log-MAP QAM demapper instead of max-log\n" ) ;
+	printf( "  -z  all-zero codewords, no data and no encoder, also for the benchmark\n" ) ;
+}
+
+
+unsigned long long sum( WORD *dst, WORD *b, int el ){
+	unsigned long long s = 0 ;
+
+	for( int i = 0 ; i < el ; i++ ){
+		dst[ i ] += b[ i ] ;
+		s += b[ i ] ;
+	}
+	return s ;
+}
+
 
+/*
+ * print counters and 95 % confidence intervals of one Eb/N0 point
+ * */
+void printPoint( const SIM_COUNTERS *c ){
+	SIM_CI ci ;
 
-void randI( WORD *buf, int r, int c ){
-	for( int i = 0 ; i < r * c ; i++ ){
-		buf[ i ] = rand() % 2 ;
-	} 
+	SimInterval( c, &ci ) ;
+
+	printf( "Eb/N0: %4.2f ITER: %4.2f Errors: %10llu Frames: %10llu BER: %e [ %e %e ] FER: %e [ %e %e ] Tel: %.1lf s\n",
+		c->ebn0, ( double )c->iter / ( double )c->frames, ( unsigned long long )c->bitErr, ( unsigned long long )c->frames,
+		ci.ber, ci.berLo, ci.berHi, ci.fer, ci.ferLo, ci.ferHi, c->time ) ;
+	fflush( stdout ) ;
 }
 
-void randN( FP *buf, int r, int c ){
-	for( int i = 0 ; i < r * c ; i++ ){
-		buf[ i ] = 1e-3 * (FP)(rand() % 1000) ;
+/*
+ * counters of the Eb/N0 points -e from:step:to, NULL if there are none
+ * */
+SIM_COUNTERS *simPoints( int *np ){
+	SIM_COUNTERS *c ;
+	int x ;
+
+	*np = EbN0Step > 0.0 ? ( int )floor( ( EbN0To - EbN0From ) / EbN0Step + 1e-9 ) + 1 : 1 ;
+	if( *np < 1 || ( c = ( SIM_COUNTERS * )calloc( *np, sizeof( SIM_COUNTERS ) ) ) == NULL ){
+		return NULL ;
+	}
+
+	for( x = 0 ; x < *np ; x++ ){
+		c[ x ].ebn0		= EbN0From + x * EbN0Step ;
+		c[ x ].point	= ( uint32_t )x ;
 	}
+
+	return c ;
 }
 
-void randF( float *buf, int r, int c ){
-	for( int i = 0 ; i < r * c ; i++ ){
-		buf[ i ] = 1e-3 * ( float )(rand() % 1000) ;
+/*
+ * one worker of a sharded sweep, runs in its own process:
+ * every shard gets a share of the stopping rules, its own RNG streams and checkpoint
+ * */
+int shardWorker( uint32_t s, SIM_COUNTERS *c, int np ){
+	char name[ 4096 ] ;
+
+	snprintf( name, sizeof( name ), "%s.%u", Sim.ckptFile, s ) ;
+	Sim.ckptFile	= name ;
+	Sim.shard		= s ;
+	Sim.minErr		= ( Sim.minErr + Workers - 1 ) / Workers ;
+	Sim.maxFrames	= ( Sim.maxFrames + Workers - 1 ) / Workers ;
+	Sim.relCI		*= sqrt( ( double )Workers ) ;	// interval width goes with 1 / sqrt( frames )
+
+	if( SimLoadCheckpoint( &Sim, c, np ) < 0 ){
+		printf( "Shard %u: checkpoint %s is corrupt or from a different configuration.\n", s, name ) ;
+		return 1 ;
 	}
+	if( SimRunSweep( &Sim, c, np, NULL ) != 0 ){
+		printf( "Shard %u: simulation FAIL.\n", s ) ;
+		return 1 ;
+	}
+
+	return 0 ;
 }
 
-unsigned long long sum( WORD *dst, WORD *b, int el ){
-	unsigned long long s = 0 ;
+/*
+ * sharded sweep: fork -w local workers, wait for all of them,
+ * then merge their checkpoints, wall-clock time of a point is that of its slowest shard
+ * a killed sharded sweep resumes when started again with the same options
+ * */
+int shardedSweep( SIM_COUNTERS *c, int np ){
+	SIM_COUNTERS *sc ;
+	const char *base = Sim.ckptFile ;
+	pid_t pid ;
+	char name[ 4096 ] ;
+	int s, x, st, fail = 0 ;
+
+	printf( "Sharded sweep: %d workers, checkpoints %s.0 .. %s.%d\n", Workers, Sim.ckptFile, Sim.ckptFile, Workers - 1 ) ;
+	fflush( stdout ) ;
+
+	for( s = 0 ; s < Workers ; s++ ){
+		if( ( pid = fork() ) < 0 ){
+			printf( "Starting worker %d FAIL.\n", s ) ;
+			fail = 1 ;
+			break ;
+		}
+		if( pid == 0 ){
+			st = shardWorker( ( uint32_t )s, c, np ) ;
+			fflush( stdout ) ;
+			_exit( st ) ;
+		}
+	}
 
-	for( int i = 0 ; i < el ; i++ ){
-		dst[ i ] += b[ i ] ;
-		s += b[ i ] ;
+	while( wait( &st ) > 0 ){
+		fail |= !WIFEXITED( st ) || WEXITSTATUS( st ) != 0 ;
 	}
-	return s ;
+	if( fail ){
+		printf( "Sharded sweep FAIL, finished work stays in the checkpoints.\n" ) ;
+		return 1 ;
+	}
+
+	if( ( sc = simPoints( &np ) ) == NULL ){
+		return 1 ;
+	}
+
+	//SimLoadCheckpoint() overwrites all counters of a shard
+	for( s = 0 ; s < Workers ; s++ ){
+		snprintf( name, sizeof( name ), "%s.%d", base, s ) ;
+		Sim.ckptFile	= name ;
+		Sim.shard		= ( uint32_t )s ;
+		if( SimLoadCheckpoint( &Sim, sc, np ) != 1 ){
+			printf( "Merging shard %d FAIL.\n", s ) ;
+			free( sc ) ;
+			return 1 ;
+		}
+		for( x = 0 ; x < np ; x++ ){
+			c[ x ].bitErr	+= sc[ x ].bitErr ;
+			c[ x ].bitErr2	+= sc[ x ].bitErr2 ;
+			c[ x ].frameErr	+= sc[ x ].frameErr ;
+			c[ x ].frames	+= sc[ x ].frames ;
+			c[ x ].iter		+= sc[ x ].iter ;
+			if( sc[ x ].time > c[ x ].time ){
+				c[ x ].time = sc[ x ].time ;
+			}
+		}
+	}
+
+	Sim.ckptFile	= base ;
+	Sim.shard		= 0 ;
+
+	printf( "Merged %d shards:\n", Workers ) ;
+	for( x = 0 ; x < np ; x++ ){
+		printPoint( c + x ) ;
+	}
+
+	free( sc ) ;
+
+	return 0 ;
 }
 
+/*
+ * run the waterfall simulation, print counters for every Eb/N0 point
+ * with -c the whole sweep is adaptive, points are printed as they finish and again in the end
+ * with -k the sweep is checkpointed and resumed, with -w it is also sharded
+ * */
+int simulation( void ){
+	SIM_COUNTERS *c ;
+	int x, np ;
+
+	Sim.rate	= ( double )K / ( double )N ;
+	Sim.nIter	= NIter ;
+	Sim.norm	= Norm ;
+	Sim.offset	= Offs ;
+
+	if( Sim.threads > MSThreads ){
+		if( MSThreads == 1 ){
+			printf( "Simulation FAIL: -t %d needs decoderMT.c, this build decodes in one thread.\n", Sim.threads ) ;
+		}else{
+			printf( "Simulation FAIL: -t %d, this build decodes in at most %d threads.\n", Sim.threads, MSThreads ) ;
+		}
+		return 1 ;
+	}
+
+	MSInitDecoder( NIter, Norm, Offs, 1 ) ;
+	if( !QCLDPCInitEncoder( ENC_ANNEXG ) && !QCLDPCInitEncoder( ENC_GENERIC ) ){
+		printf( "Encoder init FAIL.\n" ) ;
+		return 1 ;
+	}
+
+	if( ( c = simPoints( &np ) ) == NULL ){
+		printf( "Simulation FAIL: no Eb/N0 points.\n" ) ;
+		return 1 ;
+	}
+
+	if( Workers > 0 ){
+		if( Sim.ckptFile == NULL ){
+			printf( "Simulation FAIL: sharded sweep -w needs a checkpoint file -k.\n" ) ;
+			free( c ) ;
+			return 1 ;
+		}
+		x = shardedSweep( c, np ) ;
+		free( c ) ;
+		return x ;
+	}
+
+	if( Sim.ckptFile != NULL ){
+		x = SimLoadCheckpoint( &Sim, c, np ) ;
+		if( x < 0 ){
+			printf( "Checkpoint %s %s, remove it or change the file name.\n", Sim.ckptFile, x == -2 ? "is from a different configuration" : "is corrupt" ) ;
+			free( c ) ;
+			return 1 ;
+		}
+		if( x == 1 ){
+			printf( "Resuming from checkpoint %s:\n", Sim.ckptFile ) ;
+			for( x = 0 ; x < np ; x++ ){
+				if( c[ x ].frames > 0 ){
+					printPoint( c + x ) ;
+				}
+			}
+		}
+	}
+
+	if( SimRunSweep( &Sim, c, np, printPoint ) != 0 ){
+		printf( "Simulation FAIL: check -m, -f, -l, -q and the checkpoint file.\n" ) ;
+		free( c ) ;
+		return 1 ;
+	}
+
+	if( Sim.relCI > 0.0 ){
+		printf( "Sweep finished:\n" ) ;
+		for( x = 0 ; x < np ; x++ ){
+			printPoint( c + x ) ;
+		}
+	}
+
+	free( c ) ;
+
+	return 0 ;
+}
 
 int main( int argc, char *argv[] ){
-int i, j ;
+	int o ;
+
+	while( ( o = getopt( argc, argv, "se:m:f:b:r:t:c:l:k:p:w:q:xd:EPR:C:T:o:L:zh" ) ) != -1 ){
+		switch( o ){
+			case 's': simulate = 1 ; break ;
+			case 'e':
+				if( sscanf( optarg, "%lf:%lf:%lf", &EbN0From, &EbN0Step, &EbN0To ) != 3 ){
+					usage( argv[ 0 ] ) ;
+					return 1 ;
+				}
+				BenchPoints = 1 ;
+				break ;
+			case 'm': Sim.minErr 	= strtoull( optarg, NULL, 10 ) ; break ;
+			case 'f': Sim.maxFrames	= strtoull( optarg, NULL, 10 ) ; break ;
+			case 'b': Sim.blkSize 	= atoi( optarg ) ; break ;
+			case 'r': Sim.seed 		= strtoull( optarg, NULL, 10 ) ; break ;
+			case 't': Sim.threads 	= atoi( optarg ) ; break ;
+			case 'z': Sim.allZero 	= 1 ; break ;
+			case 'c': Sim.relCI 	= atof( optarg ) ; break ;
+			case 'l': Sim.ferFloor 	= atof( optarg ) ; break ;
+			case 'k': Sim.ckptFile 	= optarg ; break ;
+			case 'p': Sim.ckptPeriod = atof( optarg ) ; break ;
+			case 'w': Workers 		= atoi( optarg ) ; break ;
+			case 'q': Sim.qam 		= atoi( optarg ) ; break ;
+			case 'x': Sim.demap 	= DEMAP_EXACT ; break ;
+			case 'd': rd 			= atoi( optarg ) ; break ;
+			case 'E': Term 			= 1 ; break ;
+			case 'P': Perf 			= 1 ; break ;
+			case 'R': Runs 			= atoi( optarg ) ; break ;
+			case 'C': Baseline 		= optarg ; break ;
+			case 'T': Threshold 	= atof( optarg ) ; break ;
+			case 'o': Format 		= optarg ; break ;
+			case 'L': Label 		= optarg ; break ;
+			default:
+				usage( argv[ 0 ] ) ;
+				return o == 'h' ? 0 : 1 ;
+		}
+	}
+
+	if( simulate ){
+		return simulation() ;
+	}
+
+	return benchmark() ;
+}
+
+typedef struct bench_thread {
+	pthread_t	id ;
+	int			t ;
+	int			nth ;
+	uint64_t	iter ;
+	LAT_HIST	lat[ 2 ] ;	// per-frame decode latency: [ 0 ] not converged, [ 1 ] converged
+} BENCH_THREAD ;
+
+//one Eb/N0 point over all runs
+typedef struct bench_result {
+	double		ebn0 ;
+	int			nth ;
+	int			runs ;
+	uint64_t	frames ;	// decoded in all runs
+	uint64_t	iter ;
+	double		sec ;		// wall-clock time of all runs
+	double		mbps ;		// throughput, mean over runs
+	double		mbpsSd ;	// standard deviation over runs
+	double		p99 ;		// p99 latency of all frames in us, mean over runs
+	double		p99Sd ;
+	LAT_HIST	lat[ 2 ] ;	// all runs: [ 0 ] not converged, [ 1 ] converged
+} BENCH_RESULT ;
+
+static const double LatQ[ 4 ] = { 0.5, 0.9, 0.99, 0.999 } ;	// reported latency quantiles
+
+/*
+ * decoder thread t of nth: decodes codewords t, t + nth, .. in every round
+ * every frame is timed into the thread's own histograms, no locks
+ * */
+static void *benchThread( void *arg ){
+	BENCH_THREAD *a = ( BENCH_THREAD * )arg ;
+	uint64_t t0 ;
+	int i, j, c ;
+
+	for( i = 0 ; i < ( benchD ? rd : 1 ) ; i++ ){
+		for( j = a->t ; j < b ; j += a->nth ){
+			t0 = LatNow() ;
+			a->iter += ( uint64_t )MSDecode( llch + j * N, apll + j * N, a->t ) ;
+			HardDecision( apll + j * N, hard + j * n, N ) ;
+			c = MSConverged( a->t ) ;
+			LatRecord( a->lat + c, LatNow() - t0 ) ;
+		}
+	}
+
+	return NULL ;
+}
+
+/*
+ * one line of the benchmark report, first == 1 > also the CSV header or JSON opening
+ * */
+static void benchReport( int first, const BENCH_RESULT *br, unsigned long long s, const PERF_SET *pf ){
+	double fps, it, us[ 2 ][ 5 ], pb[ PERF_NR ], bits ;
+	const LAT_HIST *lat = br->lat ;
+	const char *fp ;
+	int c, q ;
+
+	#ifdef FIXED
+		fp = "fixed" ;
+	#else
+		fp = "float" ;
+	#endif
+
+	fps		= ( double )br->frames / br->sec ;
+	it		= ( double )br->iter / ( double )br->frames ;
+
+	//hardware counters per decoded data bit, -1 > not available
+	bits = ( double )K * ( double )br->frames ;
+	for( q = 0 ; q < PERF_NR ; q++ )
+		pb[ q ] = pf != NULL && pf->value[ q ] >= 0.0 ? pf->value[ q ] / bits : -1.0 ;
+
+	//latency quantiles and max. in us, [ 0 ] not converged, [ 1 ] converged frames
+	for( c = 0 ; c < 2 ; c++ ){
+		for( q = 0 ; q < 4 ; q++ )
+			us[ c ][ q ] = 1e-3 * ( double )LatQuantile( lat + c, LatQ[ q ] ) ;
+		us[ c ][ 4 ] = 1e-3 * ( double )( lat[ c ].count ? lat[ c ].max : 0 ) ;
+	}
+
+	if( Format == NULL ){
+		printf( "Decoder: Eb/N0: %4.2f threads: %2d frames: %8llu avg. iterations: %5.2f took: %lf seconds, throughput: %lf Mbps, %.1lf frames/s, checksum: %llu.\n",
+			br->ebn0, br->nth, ( unsigned long long )br->frames, it, br->sec, br->mbps, fps, s ) ;
+		if( br->runs > 1 ){
+			printf( "  %d runs: throughput: %.3f +- %.3f Mbps, p99 latency: %.1f +- %.1f us ( std. deviation )\n",
+				br->runs, br->mbps, br->mbpsSd, br->p99, br->p99Sd ) ;
+		}
+		for( c = 1 ; c >= 0 ; c-- ){
+			printf( "  latency %-13s frames: %8llu p50: %9.1f p90: %9.1f p99: %9.1f p99.9: %9.1f max: %9.1f us\n",
+				c ? "converged:" : "not converged:", ( unsigned long long )lat[ c ].count,
+				us[ c ][ 0 ], us[ c ][ 1 ], us[ c ][ 2 ], us[ c ][ 3 ], us[ c ][ 4 ] ) ;
+		}
+		if( pf != NULL ){
+			printf( "  per bit:" ) ;
+			for( q = 0 ; q < PERF_NR ; q++ ){
+				if( pb[ q ] >= 0.0 )
+					printf( " %s: %.3f", PerfName[ q ], pb[ q ] ) ;
+				else
+					printf( " %s: n/a", PerfName[ q ] ) ;
+			}
+			if( pb[ PERF_CYCLES ] > 0.0 && pb[ PERF_INSTR ] >= 0.0 )
+				printf( " IPC: %.2f", pb[ PERF_INSTR ] / pb[ PERF_CYCLES ] ) ;
+			printf( "\n" ) ;
+		}
+	}else if( strcmp( Format, "json" ) == 0 ){
+		printf( "%s{ \"label\": \"%s\", \"N\": %d, \"K\": %d, \"Z\": %d, \"fp\": \"%s\", \"isa\": \"%s\", \"sched\": \"%s\", \"nIter\": %d, \"early\": %d, \"threads\": %d, \"ebn0\": %.2f, "
+			"\"frames\": %llu, \"iterations\": %.4f, \"seconds\": %.6f, \"mbps\": %.3f, \"fps\": %.1f, "
+			"\"runs\": %d, \"mbps_sd\": %.3f, \"p99_us\": %.1f, \"p99_sd\": %.1f",
+			first ? "[\n" : ",\n", Label, N, K, Z, fp, KernelISA(), KernelSchedule(), NIter, Term, br->nth, br->ebn0, ( unsigned long long )br->frames, it, br->sec, br->mbps, fps,
+			br->runs, br->mbpsSd, br->p99, br->p99Sd ) ;
+		for( c = 1 ; c >= 0 ; c-- ){
+			printf( ", \"%s\": %llu, \"%s_p50_us\": %.1f, \"%s_p90_us\": %.1f, \"%s_p99_us\": %.1f, \"%s_p999_us\": %.1f, \"%s_max_us\": %.1f",
+				c ? "conv" : "fail", ( unsigned long long )lat[ c ].count, c ? "conv" : "fail", us[ c ][ 0 ], c ? "conv" : "fail", us[ c ][ 1 ],
+				c ? "conv" : "fail", us[ c ][ 2 ], c ? "conv" : "fail", us[ c ][ 3 ], c ? "conv" : "fail", us[ c ][ 4 ] ) ;
+		}
+		for( q = 0 ; pf != NULL && q < PERF_NR ; q++ ){
+			if( pb[ q ] >= 0.0 )
+				printf( ", \"%s_per_bit\": %.4f", PerfName[ q ], pb[ q ] ) ;
+			else
+				printf( ", \"%s_per_bit\": null", PerfName[ q ] ) ;
+		}
+		printf( " }" ) ;
+	}else{
+		if( first ){
+			printf( "label,N,K,Z,fp,isa,sched,nIter,early,threads,ebn0,frames,iterations,seconds,mbps,fps,runs,mbps_sd,p99_us,p99_sd,"
+				"conv,conv_p50_us,conv_p90_us,conv_p99_us,conv_p999_us,conv_max_us,fail,fail_p50_us,fail_p90_us,fail_p99_us,fail_p999_us,fail_max_us" ) ;
+			for( q = 0 ; pf != NULL && q < PERF_NR ; q++ )
+				printf( ",%s_per_bit", PerfName[ q ] ) ;
+			printf( "\n" ) ;
+		}
+		printf( "%s,%d,%d,%d,%s,%s,%s,%d,%d,%d,%.2f,%llu,%.4f,%.6f,%.3f,%.1f,%d,%.3f,%.1f,%.1f",
+			Label, N, K, Z, fp, KernelISA(), KernelSchedule(), NIter, Term, br->nth, br->ebn0, ( unsigned long long )br->frames, it, br->sec, br->mbps, fps,
+			br->runs, br->mbpsSd, br->p99, br->p99Sd ) ;
+		for( c = 1 ; c >= 0 ; c-- ){
+			printf( ",%llu,%.1f,%.1f,%.1f,%.1f,%.1f", ( unsigned long long )lat[ c ].count, us[ c ][ 0 ], us[ c ][ 1 ], us[ c ][ 2 ], us[ c ][ 3 ], us[ c ][ 4 ] ) ;
+		}
+		for( q = 0 ; pf != NULL && q < PERF_NR ; q++ ){
+			if( pb[ q ] >= 0.0 )
+				printf( ",%.4f", pb[ q ] ) ;
+			else
+				printf( "," ) ;	//not available, empty field
+		}
+		printf( "\n" ) ;
+	}
+	fflush( stdout ) ;
+}
+
+/*
+ * compare a point with its baseline row, returns 1 if it regressed
+ * the comparison goes to stderr with -o csv or json, so the report stays machine-readable
+ * */
+static int benchCompare( const BENCH_ROW *rows, int nr, const BENCH_RESULT *br ){
+	const BENCH_ROW *base ;
+	BENCH_ROW cur ;
+	double dm, dl ;
+	int f ;
+	FILE *out = Format == NULL ? stdout : stderr ;
+
+	memset( ( void * )&cur, 0, sizeof( cur ) ) ;
+	snprintf( cur.label, sizeof( cur.label ), "%s", Label ) ;
+	#ifdef FIXED
+		snprintf( cur.fp, sizeof( cur.fp ), "fixed" ) ;
+	#else
+		snprintf( cur.fp, sizeof( cur.fp ), "float" ) ;
+	#endif
+	snprintf( cur.isa, sizeof( cur.isa ), "%s", KernelISA() ) ;
+	snprintf( cur.sched, sizeof( cur.sched ), "%s", KernelSchedule() ) ;
+	cur.n		= N ;
+	cur.z		= Z ;
+	cur.nIter	= NIter ;
+	cur.early	= Term ;
+	cur.threads	= br->nth ;
+	cur.ebn0	= br->ebn0 ;
+	cur.runs	= br->runs ;
+	cur.mbps	= br->mbps ;
+	cur.mbpsSd	= br->mbpsSd ;
+	cur.p99		= br->p99 ;
+	cur.p99Sd	= br->p99Sd ;
+
+	if( ( base = BenchFind( rows, nr, &cur ) ) == NULL ){
+		fprintf( out, "Compare: %s %s %s %s threads: %d Eb/N0: %.2f not in the baseline.\n", cur.label, cur.fp, cur.isa, cur.sched, cur.threads, cur.ebn0 ) ;
+		return 0 ;
+	}
+
+	f = BenchRegressed( base, &cur, 0.01 * Threshold, &dm, &dl ) ;
+	fprintf( out, "Compare: %s %s %s %s threads: %d Eb/N0: %.2f throughput: %.3f / %.3f Mbps ( %+.1f %% ) p99: %.1f / %.1f us ( %+.1f %% )%s%s\n",
+		cur.label, cur.fp, cur.isa, cur.sched, cur.threads, cur.ebn0, cur.mbps, base->mbps, 100.0 * dm, cur.p99, base->p99, 100.0 * dl,
+		f & BCMP_THROUGHPUT ? " THROUGHPUT REGRESSION" : "", f & BCMP_LATENCY ? " LATENCY REGRESSION" : "" ) ;
+
+	return f != 0 ;
+}
+
+/*
+ * rudimentary encoder and decoder benchmark
+ * wall-clock time, the decoder runs in -t threads over BPSK / AWGN codewords at each Eb/N0 point
+ * */
+int benchmark( void ){
+int i, j, x, np, nth ;
 unsigned long long s ;
 
-clock_t t ;
-double bits, sec, thr ;
+static BENCH_THREAD th[ N_TH ] ;	//latency histograms are too large for the stack
+static BENCH_RESULT br ;
+LAT_HIST all ;
+PERF_SET pf ;
+BENCH_ROW *rows = NULL ;
+double bits, sec, thr, var, mbps, p99, pv[ PERF_NR ] ;
+uint64_t t ;
+int run, nr = 0, regressed = 0 ;
+float *noise ;
+RNG rng ;
 
 
 #ifdef BITMAP
@@ -110,94 +616,180 @@ double bits, sec, thr ;
 	m = M ;
 	z = Z ;
 #endif
+
+	nth = Sim.threads < 1 ? 1 : ( Sim.threads > N_TH ? N_TH : Sim.threads ) ;
+	if( nth > MSThreads ){
+		printf( "Benchmark FAIL: -t %d needs decoderMT.c, this build decodes in one thread.\n", nth ) ;
+		return 1 ;
+	}
+	if( Format != NULL && strcmp( Format, "csv" ) != 0 && strcmp( Format, "json" ) != 0 ){
+		printf( "Benchmark FAIL: unknown report format %s.\n", Format ) ;
+		return 1 ;
+	}
+	if( Runs < 1 )
+		Runs = 1 ;
+	if( Baseline != NULL && ( nr = BenchLoadBaseline( Baseline, &rows ) ) < 0 )
+		return 1 ;
 	
 	data = (WORD *)calloc( k * b, sizeof( WORD ) ) ;
 	code = (WORD *)calloc( n * b, sizeof( WORD ) ) ;
 	acc  = (WORD *)calloc( n * b, sizeof( WORD ) ) ;
+	hard = (WORD *)calloc( n * b, sizeof( WORD ) ) ;
 	
-	llch = (FP *)calloc( n * b, sizeof( FP ) ) ;
-	apll = (FP *)calloc( n * b, sizeof( FP ) ) ;
+	llch = (FP *)calloc( N * b, sizeof( FP ) ) ;
+	apll = (FP *)calloc( N * b, sizeof( FP ) ) ;
+	noise = (float *)calloc( N, sizeof( float ) ) ;
 
-	//rudimentary transmitter:
+	MSInitDecoder( NIter, Norm, Offs, Term ) ;	//index structures are also needed by Orthogonal()
+	if( Format == NULL )
+		printf( "Kernels: %s, layer schedule: %s.\n", KernelISA(), KernelSchedule() ) ;
 
-	randI( data, b, k ) ;
-	if( !CheckEncoderInput( data, k, b ) ){
-		printf( "Random data generator FAIL.\n" ) ;
-		return 1 ;
-	} 
+	if( Perf && PerfOpen( &pf ) == 0 && Format == NULL ){	//csv, json: empty fields, null
+		printf( "Benchmark: no hardware performance counters available, see /proc/sys/kernel/perf_event_paranoid.\n" ) ;
+	}
+
+	if( Sim.allZero ){	//all-zero codewords, calloc() already did the job
+		if( Format == NULL )
+			printf( "Encoder: skipped, all-zero codewords.\n" ) ;
+	}else{
+		//rudimentary transmitter, data of codeword j come from RNG stream ( seed, 0, j ):
 
-	t = clock() ;
-	if( benchE ){	//benchmark encoder
-		for( i = 0 ; i < r ; i++ ){
+		for( j = 0 ; j < b ; j++ ){
+			RngFrame( &rng, Sim.seed, 0, j ) ;
+			SimData( &rng, data + j * k ) ;
+		}
+		if( !CheckEncoderInput( data, k, b ) ){
+			printf( "Random data generator FAIL.\n" ) ;
+			return 1 ;
+		} 
+
+		t = LatNow() ;
+		if( benchE ){	//benchmark encoder
+			for( i = 0 ; i < r ; i++ ){
+				for( j = 0 ; j < b ; j++ ){
+					QCLDPCEncodeCW( data + j * k , code + j * n ) ;
+					sum( acc + j * n, code + j * n, n ) ;
+				}
+			}
+		}else{	//just run encoder once
 			for( j = 0 ; j < b ; j++ ){
-				QCLDPCEncode( data + j * k , code + j * n ) ;
+				QCLDPCEncodeCW( data + j * k , code + j * n ) ;
+				if( !Orthogonal( code + j * n, 0 ) ){
+					printf( "Encoder FAIL at: %d.\n", j ) ;
+					return 1 ;
+				}
 				sum( acc + j * n, code + j * n, n ) ;
 			}
 		}
-	}else{	//just run encoder once
-		for( j = 0 ; j < b ; j++ ){
-			QCLDPCEncode( data + j * k , code + j * n ) ;
-			if( !Orthogonal( code + j * n, -1 ) ){
-				printf( "Encoder FAIL at: %d.\n", j ) ;
-				return 1 ;
-			}
-			sum( acc + j * n, code + j * n, n ) ;
-		}
-	}
-	t 		= clock() - t ;
-	sec 	= (double)t / CLOCKS_PER_SEC ;
-	bits 	= (double)( k * b ) * (double)r ; 
-	thr  	= 1e-6 * bits / sec ;
-	s 		= sum( acc, acc, n * b ) ;
+		sec 	= 1e-9 * ( double )( LatNow() - t ) ;
+		bits 	= (double)( k * b ) * (double)( benchE ? r : 1 ) ; 
+		thr  	= 1e-6 * bits / sec ;
+		s 		= sum( acc, acc, n * b ) ;
 
-	printf( "Encoder: data bits: %10.0lf, took: %lf seconds, throughput: %lf Mbps, checksum: %llu.\n", bits, sec, thr, s ) ;
-	
-	//even more rudimentary channell model:
-	for( j = 0 ; j < b ; j++ ){
-		randN( llch, b, n ) ;	//now contains "AWGN noise"
-
-		for( i = 0 ; i < n ; i++ ){
-			llch[ j * n + i ] += code[ j * n + i ] ;
-		}
+		if( Format == NULL )
+			printf( "Encoder: data bits: %10.0lf, took: %lf seconds, throughput: %lf Mbps, checksum: %llu.\n", bits, sec, thr, s ) ;
 	}
 
-	//rudimentary receiver:
-
-	s = 0 ;
-	r /= 10 ;
-	memset( (void *)code, 0, n * b * sizeof( WORD ) ) ;
+	//rudimentary receiver, at every Eb/N0 point:
+
+	np = BenchPoints && EbN0Step > 0.0 ? ( int )floor( ( EbN0To - EbN0From ) / EbN0Step + 1e-9 ) + 1 : 1 ;
+	for( x = 0 ; x < np ; x++ ){
+		memset( ( void * )&br, 0, sizeof( br ) ) ;
+		br.ebn0	= BenchPoints ? EbN0From + x * EbN0Step : BenchEbN0 ;
+		br.nth	= nth ;
+		br.runs	= Runs ;
+		LatReset( br.lat ) ;
+		LatReset( br.lat + 1 ) ;
+		for( i = 0 ; i < PERF_NR ; i++ )
+			pv[ i ] = 0.0 ;
+
+		//BPSK over AWGN, noise of codeword j comes from RNG stream ( seed, 1, j ):
+		var = 1.0 / ( 2.0 * pow( 10.0, br.ebn0 / 10.0 ) * ( double )K / ( double )N ) ;
+		for( j = 0 ; j < b ; j++ ){
+			RngFrame( &rng, Sim.seed, 1, j ) ;
+			SimChannel( &rng, Sim.allZero ? NULL : code + j * n, noise, llch + j * N, ( float )sqrt( var ) ) ;
+		}
 
-	MSInitDecoder( NIter, Norm, Offs, Term ) ;
+		//same codewords in every run, throughput and p99 latency of each run give mean and std. deviation
+		for( run = 0 ; run < Runs ; run++ ){
+			memset( (void *)hard, 0, n * b * sizeof( WORD ) ) ;
+
+			if( Perf )
+				PerfStart( &pf ) ;	//counters are inherited by the decoder threads created below
+			t = LatNow() ;
+			for( i = 0 ; i < nth ; i++ ){
+				th[ i ].t		= i ;
+				th[ i ].nth		= nth ;
+				th[ i ].iter	= 0 ;
+				LatReset( th[ i ].lat ) ;
+				LatReset( th[ i ].lat + 1 ) ;
+				if( pthread_create( &th[ i ].id, NULL, benchThread, ( void * )( th + i ) ) != 0 ){
+					printf( "Decoder thread FAIL.\n" ) ;
+					return 1 ;
+				}
+			}
+			for( i = 0 ; i < nth ; i++ ){
+				pthread_join( th[ i ].id, NULL ) ;
+				br.iter += th[ i ].iter ;
+			}
+			sec = 1e-9 * ( double )( LatNow() - t ) ;
+			if( Perf ){
+				PerfStop( &pf ) ;	//joined threads have added their counts
+				for( i = 0 ; i < PERF_NR ; i++ )
+					pv[ i ] = pf.value[ i ] < 0.0 || pv[ i ] < 0.0 ? -1.0 : pv[ i ] + pf.value[ i ] ;
+			}
 
-	t = clock() ;
-	if( benchD ){	//benchmark decoder
-		for( i = 0 ; i < r ; i++ ){
-			for( j = 0 ; j < b ; j++ ){
-				MSDecode( llch + j * n, apll + j * n, 1 ) ;
-				HardDecision( apll + j * n, code + j * n, N ) ;
+			LatReset( &all ) ;
+			for( i = 0 ; i < nth ; i++ ){
+				LatMerge( br.lat, th[ i ].lat ) ;
+				LatMerge( br.lat + 1, th[ i ].lat + 1 ) ;
+				LatMerge( &all, th[ i ].lat ) ;
+				LatMerge( &all, th[ i ].lat + 1 ) ;
 			}
+
+			//running sums of the values and their squares, converted below
+			mbps		= 1e-6 * ( double )K * ( double )b * ( double )( benchD ? rd : 1 ) / sec ;
+			p99			= 1e-3 * ( double )LatQuantile( &all, 0.99 ) ;
+			br.sec		+= sec ;
+			br.frames	+= ( uint64_t )b * ( uint64_t )( benchD ? rd : 1 ) ;
+			br.mbps		+= mbps ;
+			br.mbpsSd	+= mbps * mbps ;
+			br.p99		+= p99 ;
+			br.p99Sd	+= p99 * p99 ;
 		}
-	}else{	//just run decoder once
-		for( j = 0 ; j < b ; j++ ){
-			MSDecode( llch + j * n, apll + j * n, 1 ) ;
-			HardDecision( apll + j * n, code + j * n, N ) ;
-		}
+		br.mbps		/= Runs ;
+		br.p99		/= Runs ;
+		br.mbpsSd	= Runs > 1 ? sqrt( fmax( 0.0, ( br.mbpsSd - Runs * br.mbps * br.mbps ) / ( Runs - 1 ) ) ) : 0.0 ;
+		br.p99Sd	= Runs > 1 ? sqrt( fmax( 0.0, ( br.p99Sd - Runs * br.p99 * br.p99 ) / ( Runs - 1 ) ) ) : 0.0 ;
+		for( i = 0 ; i < PERF_NR ; i++ )
+			pf.value[ i ] = pv[ i ] ;
+
+		for( s = 0, j = 0 ; j < n * b ; j++ )
+			s += hard[ j ] ;	//hard decisions of the last run
+		benchReport( x == 0, &br, s, Perf ? &pf : NULL ) ;
+		if( Baseline != NULL )
+			regressed += benchCompare( rows, nr, &br ) ;
+	}
+	if( Format != NULL && strcmp( Format, "json" ) == 0 ){
+		printf( "\n]\n" ) ;
 	}
-
-	t 		= clock() - t ;
-	sec 	= (double)t / CLOCKS_PER_SEC ;
-	bits 	= (double)( k * b ) * (double)r ;
-	thr  	= 1e-6 * bits / sec ;
-
-	s = sum( acc, acc, n * b ) ;
-	printf( "Decoder: data bits: %10.0lf, took: %lf seconds, throughput: %lf Mbps, checksum: %llu.\n", bits, sec, thr, s ) ;
 
 
 	free( data ) ;
 	free( code ) ;
 	free( acc ) ;
+	free( hard ) ;
 	free( llch ) ;
 	free( apll ) ;
+	free( noise ) ;
+	if( Perf )
+		PerfClose( &pf ) ;
+	free( rows ) ;
+
+	if( regressed > 0 ){
+		fprintf( Format == NULL ? stdout : stderr, "Compare: %d regressions against %s.\n", regressed, Baseline ) ;
+		return 2 ;
+	}
 
 	return 0 ;
 }
@@ -0,0 +1,162 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+#define _GNU_SOURCE	//syscall
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <linux/perf_event.h>
+#endif
+
+#include "perf.h"
+
+const char *PerfName[ PERF_NR ] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" } ;
+
+#ifdef __linux__
+
+static int perfOpen( uint32_t type, uint64_t config ) ;
+
+
+//global functions definitions-------------------------------------------------
+
+int PerfOpen( PERF_SET *p ){
+	int i, c ;
+
+	p->fd[ PERF_CYCLES ]	= perfOpen( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES ) ;
+	p->fd[ PERF_INSTR ]		= perfOpen( PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS ) ;
+	p->fd[ PERF_L1D_MISS ]	= perfOpen( PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+								( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ) ) ;
+	p->fd[ PERF_LLC_MISS ]	= perfOpen( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES ) ;
+	p->fd[ PERF_BR_MISS ]	= perfOpen( PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES ) ;
+
+	for( c = 0, i = 0 ; i < PERF_NR ; i++ ){
+		p->value[ i ] = -1.0 ;
+		c += p->fd[ i ] >= 0 ;
+	}
+	return c ;
+}
+
+void PerfStart( PERF_SET *p ){
+	int i ;
+
+	for( i = 0 ; i < PERF_NR ; i++ ){
+		if( p->fd[ i ] >= 0 ){
+			ioctl( p->fd[ i ], PERF_EVENT_IOC_RESET, 0 ) ;
+			ioctl( p->fd[ i ], PERF_EVENT_IOC_ENABLE, 0 ) ;
+		}
+	}
+}
+
+void PerfStop( PERF_SET *p ){
+	uint64_t v[ 3 ] ;	// value, time enabled, time running
+	int i ;
+
+	for( i = 0 ; i < PERF_NR ; i++ ){
+		if( p->fd[ i ] >= 0 )
+			ioctl( p->fd[ i ], PERF_EVENT_IOC_DISABLE, 0 ) ;
+	}
+	for( i = 0 ; i < PERF_NR ; i++ ){
+		p->value[ i ] = -1.0 ;
+		if( p->fd[ i ] < 0 || read( p->fd[ i ], v, sizeof( v ) ) != sizeof( v ) )
+			continue ;
+		if( v[ 2 ] == 0 )	//never scheduled on the PMU
+			continue ;
+		p->value[ i ] = ( double )v[ 0 ] * ( double )v[ 1 ] / ( double )v[ 2 ] ;
+	}
+}
+
+void PerfClose( PERF_SET *p ){
+	int i ;
+
+	for( i = 0 ; i < PERF_NR ; i++ ){
+		if( p->fd[ i ] >= 0 )
+			close( p->fd[ i ] ) ;
+		p->fd[ i ] = -1 ;
+	}
+}
+
+
+//local functions definitions---------------------------------------------------
+
+/*
+ * one counter of this process, user space only, inherited by threads created later
+ * returns its file descriptor, -1 if not available
+ * */
+static int perfOpen( uint32_t type, uint64_t config ){
+	struct perf_event_attr a ;
+
+	memset( ( void * )&a, 0, sizeof( a ) ) ;
+	a.size				= sizeof( a ) ;
+	a.type				= type ;
+	a.config			= config ;
+	a.disabled			= 1 ;
+	a.inherit			= 1 ;
+	a.exclude_kernel	= 1 ;
+	a.exclude_hv		= 1 ;
+	a.read_format		= PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING ;
+
+	return ( int )syscall( SYS_perf_event_open, &a, 0, -1, -1, 0 ) ;
+}
+
+#else	//no perf_event_open()
+
+int PerfOpen( PERF_SET *p ){
+	int i ;
+
+	for( i = 0 ; i < PERF_NR ; i++ ){
+		p->fd[ i ]		= -1 ;
+		p->value[ i ]	= -1.0 ;
+	}
+	return 0 ;
+}
+
+void PerfStart( PERF_SET *p ){
+}
+
+void PerfStop( PERF_SET *p ){
+}
+
+void PerfClose( PERF_SET *p ){
+}
+
+#endif
@@ -0,0 +1,79 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Hardware performance counters of the benchmark, Linux perf_event_open( 2 ).
+
+	User space only ( works with perf_event_paranoid <= 2 ), counting the
+	calling thread and all threads it creates after PerfOpen(): counts of
+	the decoder threads are added to the totals when they are joined.
+	Counters the kernel or the CPU ( e.g. a VM ) does not provide are left
+	out, their values are -1. Elsewhere than on Linux no counter is available.
+*/
+
+#ifndef QCLDPCPERF
+#define QCLDPCPERF
+
+enum {
+	PERF_CYCLES = 0,
+	PERF_INSTR,
+	PERF_L1D_MISS,		// L1 data cache read misses
+	PERF_LLC_MISS,		// last level cache misses
+	PERF_BR_MISS,		// mispredicted branches
+	PERF_NR
+} ;
+
+typedef struct perf_set {
+	int		fd[ PERF_NR ] ;		// -1 > not available
+	double	value[ PERF_NR ] ;	// counts of the last PerfStart() .. PerfStop(), -1 > not available
+} PERF_SET ;
+
+extern const char *PerfName[ PERF_NR ] ;
+
+// 	open all counters, disabled, returns the nr. of available counters
+extern int PerfOpen( PERF_SET *p ) ;
+
+// 	reset and enable the counters
+extern void PerfStart( PERF_SET *p ) ;
+
+// 	disable the counters and read value[], scaled if the kernel had to multiplex them
+extern void PerfStop( PERF_SET *p ) ;
+
+extern void PerfClose( PERF_SET *p ) ;
+
+#endif
@@ -0,0 +1,343 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined( __AVX2__ ) && !defined( RNG_SCALAR )
+	#define RNG_AVX2
+	#include <immintrin.h>
+#endif
+
+#include "rng.h"
+
+/*
+ * scalar and AVX2 Gaussian paths are only bit-exact if mul + add is never fused
+ * */
+#if defined( __clang__ )
+	#pragma clang fp contract( off )
+#elif defined( __GNUC__ )
+	#pragma GCC optimize ( "fp-contract=off" )
+#endif
+
+//Philox4x32 constants
+#define PH_M0 0xD2511F53U
+#define PH_M1 0xCD9E8D57U
+#define PH_W0 0x9E3779B9U
+#define PH_W1 0xBB67AE85U
+#define PH_R  10
+
+#define U24 		5.9604644775390625e-08f			// 2^-24
+#define SQRTHF		0.707106781186547524f
+#define HALFPI22	3.74507028292392858e-07f		// pi / 2 / 2^22
+
+//log polynomial, Cephes logf
+#define LOG_P0		7.0376836292e-2f
+#define LOG_P1		-1.1514610310e-1f
+#define LOG_P2		1.1676998740e-1f
+#define LOG_P3		-1.2420140846e-1f
+#define LOG_P4		1.4249322787e-1f
+#define LOG_P5		-1.6668057665e-1f
+#define LOG_P6		2.0000714765e-1f
+#define LOG_P7		-2.4999993993e-1f
+#define LOG_P8		3.3333331174e-1f
+#define LOG_Q1		-2.12194440e-4f
+#define LOG_Q2		0.693359375f
+
+//sin and cos polynomials on [ -pi/4, pi/4 ], Cephes sinf, cosf
+#define SIN_P0		-1.9515295891e-4f
+#define SIN_P1		8.3321608736e-3f
+#define SIN_P2		-1.6666654611e-1f
+#define COS_P0		2.443315711809948e-5f
+#define COS_P1		-1.388731625493765e-3f
+#define COS_P2		4.166664568298827e-2f
+
+static void philox( uint32_t *ctr, const uint32_t *key, uint32_t *out ) ;
+static uint32_t nextWord( RNG *r ) ;
+static void gaussBlock( const uint32_t *w, float *out, float sigma ) ;
+#ifndef RNG_AVX2
+	static float logPoly( float x ) ;
+	static void sinCosPoly( uint32_t w, float *s, float *c ) ;
+#endif
+
+//global functions definitions-------------------------------------------------
+
+void RngFrame( RNG *r, uint64_t seed, uint32_t point, uint64_t frame ){
+	r->key[ 0 ] = ( uint32_t )seed ;
+	r->key[ 1 ] = ( uint32_t )( seed >> 32 ) ;
+
+	r->ctr[ 0 ] = 0 ;
+	r->ctr[ 1 ] = ( uint32_t )frame ;
+	r->ctr[ 2 ] = ( uint32_t )( frame >> 32 ) ;
+	r->ctr[ 3 ] = point ;
+
+	r->idx = 4 ;
+}
+
+uint64_t RngNext( RNG *r ){
+	uint64_t lo ;
+
+	lo = nextWord( r ) ;
+
+	return lo | ( ( uint64_t )nextWord( r ) << 32 ) ;
+}
+
+/*
+ * Box-Muller transform in blocks of RNG_GB pairs:
+ * first half of a block are the cos samples, second half the sin samples
+ * */
+void RngGauss( RNG *r, float *out, int el, float sigma ){
+	uint32_t w[ 2 * RNG_GB ] ;
+	float tmp[ 2 * RNG_GB ] ;
+	int i, j ;
+
+	for( i = 0 ; i < el ; i += 2 * RNG_GB ){
+		for( j = 0 ; j < 2 * RNG_GB ; j++ ){
+			w[ j ] = nextWord( r ) ;
+		}
+
+		if( el - i >= 2 * RNG_GB ){
+			gaussBlock( w, out + i, sigma ) ;
+		}else{
+			gaussBlock( w, tmp, sigma ) ;
+			memcpy( ( void * )( out + i ), ( void * )tmp, ( el - i ) * sizeof( float ) ) ;
+		}
+	}
+}
+
+//local functions definitions---------------------------------------------------
+
+/*
+ * Philox4x32-10 block, counter block index is incremented
+ * */
+static void philox( uint32_t *ctr, const uint32_t *key, uint32_t *out ){
+	uint32_t c0 = ctr[ 0 ], c1 = ctr[ 1 ], c2 = ctr[ 2 ], c3 = ctr[ 3 ] ;
+	uint32_t k0 = key[ 0 ], k1 = key[ 1 ] ;
+	uint64_t p0, p1 ;
+	int i ;
+
+	for( i = 0 ; i < PH_R ; i++ ){
+		p0 = ( uint64_t )PH_M0 * c0 ;
+		p1 = ( uint64_t )PH_M1 * c2 ;
+
+		c0 = ( uint32_t )( p1 >> 32 ) ^ c1 ^ k0 ;
+		c1 = ( uint32_t )p1 ;
+		c2 = ( uint32_t )( p0 >> 32 ) ^ c3 ^ k1 ;
+		c3 = ( uint32_t )p0 ;
+
+		k0 += PH_W0 ;
+		k1 += PH_W1 ;
+	}
+
+	out[ 0 ] = c0 ;
+	out[ 1 ] = c1 ;
+	out[ 2 ] = c2 ;
+	out[ 3 ] = c3 ;
+
+	ctr[ 0 ]++ ;
+}
+
+static uint32_t nextWord( RNG *r ){
+	if( r->idx == 4 ){
+		philox( r->ctr, r->key, r->buf ) ;
+		r->idx = 0 ;
+	}
+	return r->buf[ r->idx++ ] ;
+}
+
+/*
+ * 24 bits of w[ i ] make u1 in ( 0, 1 ], 24 bits of w[ RNG_GB + i ] the angle 2 * pi * u2
+ * */
+#ifndef RNG_AVX2
+
+static void gaussBlock( const uint32_t *w, float *out, float sigma ){
+	float u1, a, s, c ;
+	int i ;
+
+	for( i = 0 ; i < RNG_GB ; i++ ){
+		u1 	= ( ( float )( int32_t )( w[ i ] >> 8 ) + 0.5f ) * U24 ;
+		a 	= sqrtf( -2.0f * logPoly( u1 ) ) * sigma ;
+
+		sinCosPoly( w[ RNG_GB + i ] >> 8, &s, &c ) ;
+
+		out[ i ] 			= a * c ;
+		out[ RNG_GB + i ] 	= a * s ;
+	}
+}
+
+#else
+
+static void gaussBlock( const uint32_t *w, float *out, float sigma ){
+	const __m256 one 	= _mm256_set1_ps( 1.0f ) ;
+	const __m256 neg 	= _mm256_set1_ps( -0.0f ) ;
+	__m256i a, b, ui, j, q, r ;
+	__m256 u1, e, m, t, lt, z, y, x, ps, pc, s, c, sw ;
+
+	a	= _mm256_srli_epi32( _mm256_loadu_si256( ( const __m256i * )w ), 8 ) ;
+	b	= _mm256_srli_epi32( _mm256_loadu_si256( ( const __m256i * )( w + RNG_GB ) ), 8 ) ;
+
+	//log( u1 ), same steps as logPoly()
+	u1	= _mm256_mul_ps( _mm256_add_ps( _mm256_cvtepi32_ps( a ), _mm256_set1_ps( 0.5f ) ), _mm256_set1_ps( U24 ) ) ;
+	ui	= _mm256_castps_si256( u1 ) ;
+	e	= _mm256_cvtepi32_ps( _mm256_sub_epi32( _mm256_srli_epi32( ui, 23 ), _mm256_set1_epi32( 126 ) ) ) ;
+	m	= _mm256_castsi256_ps( _mm256_or_si256( _mm256_and_si256( ui, _mm256_set1_epi32( 0x007FFFFF ) ), _mm256_set1_epi32( 0x3F000000 ) ) ) ;
+	lt	= _mm256_cmp_ps( m, _mm256_set1_ps( SQRTHF ), _CMP_LT_OQ ) ;
+	t	= _mm256_and_ps( lt, m ) ;
+	e	= _mm256_sub_ps( e, _mm256_and_ps( lt, one ) ) ;
+	m	= _mm256_add_ps( _mm256_sub_ps( m, one ), t ) ;
+	z	= _mm256_mul_ps( m, m ) ;
+	y	= _mm256_set1_ps( LOG_P0 ) ;
+	y	= _mm256_add_ps( _mm256_mul_ps( y, m ), _mm256_set1_ps( LOG_P1 ) ) ;
+	y	= _mm256_add_ps( _mm256_mul_ps( y, m ), _mm256_set1_ps( LOG_P2 ) ) ;
+	y	= _mm256_add_ps( _mm256_mul_ps( y, m ), _mm256_set1_ps( LOG_P3 ) ) ;
+	y	= _mm256_add_ps( _mm256_mul_ps( y, m ), _mm256_set1_ps( LOG_P4 ) ) ;
+	y	= _mm256_add_ps( _mm256_mul_ps( y, m ), _mm256_set1_ps( LOG_P5 ) ) ;
+	y	= _mm256_add_ps( _mm256_mul_ps( y, m ), _mm256_set1_ps( LOG_P6 ) ) ;
+	y	= _mm256_add_ps( _mm256_mul_ps( y, m ), _mm256_set1_ps( LOG_P7 ) ) ;
+	y	= _mm256_add_ps( _mm256_mul_ps( y, m ), _mm256_set1_ps( LOG_P8 ) ) ;
+	y	= _mm256_mul_ps( _mm256_mul_ps( y, m ), z ) ;
+	y	= _mm256_add_ps( y, _mm256_mul_ps( e, _mm256_set1_ps( LOG_Q1 ) ) ) ;
+	y	= _mm256_sub_ps( y, _mm256_mul_ps( _mm256_set1_ps( 0.5f ), z ) ) ;
+	m	= _mm256_add_ps( m, y ) ;
+	m	= _mm256_add_ps( m, _mm256_mul_ps( e, _mm256_set1_ps( LOG_Q2 ) ) ) ;
+
+	//amplitude
+	m	= _mm256_mul_ps( _mm256_sqrt_ps( _mm256_mul_ps( _mm256_set1_ps( -2.0f ), m ) ), _mm256_set1_ps( sigma ) ) ;
+
+	//sin and cos, same steps as sinCosPoly()
+	j	= _mm256_srli_epi32( _mm256_add_epi32( b, _mm256_set1_epi32( 1 << 21 ) ), 22 ) ;
+	r	= _mm256_sub_epi32( b, _mm256_slli_epi32( j, 22 ) ) ;
+	q	= _mm256_and_si256( j, _mm256_set1_epi32( 3 ) ) ;
+	x	= _mm256_mul_ps( _mm256_cvtepi32_ps( r ), _mm256_set1_ps( HALFPI22 ) ) ;
+	z	= _mm256_mul_ps( x, x ) ;
+
+	ps	= _mm256_set1_ps( SIN_P0 ) ;
+	ps	= _mm256_add_ps( _mm256_mul_ps( ps, z ), _mm256_set1_ps( SIN_P1 ) ) ;
+	ps	= _mm256_add_ps( _mm256_mul_ps( ps, z ), _mm256_set1_ps( SIN_P2 ) ) ;
+	ps	= _mm256_add_ps( _mm256_mul_ps( _mm256_mul_ps( ps, z ), x ), x ) ;
+
+	pc	= _mm256_set1_ps( COS_P0 ) ;
+	pc	= _mm256_add_ps( _mm256_mul_ps( pc, z ), _mm256_set1_ps( COS_P1 ) ) ;
+	pc	= _mm256_add_ps( _mm256_mul_ps( pc, z ), _mm256_set1_ps( COS_P2 ) ) ;
+	pc	= _mm256_mul_ps( _mm256_mul_ps( pc, z ), z ) ;
+	pc	= _mm256_add_ps( _mm256_sub_ps( pc, _mm256_mul_ps( _mm256_set1_ps( 0.5f ), z ) ), one ) ;
+
+	//quadrant: swap for odd, negate cos for 1 and 2, negate sin for 2 and 3
+	sw	= _mm256_castsi256_ps( _mm256_cmpeq_epi32( _mm256_and_si256( q, _mm256_set1_epi32( 1 ) ), _mm256_set1_epi32( 1 ) ) ) ;
+	c	= _mm256_blendv_ps( pc, ps, sw ) ;
+	s	= _mm256_blendv_ps( ps, pc, sw ) ;
+	c	= _mm256_xor_ps( c, _mm256_and_ps( neg, _mm256_castsi256_ps( _mm256_cmpeq_epi32( _mm256_and_si256( _mm256_add_epi32( q, _mm256_set1_epi32( 1 ) ), _mm256_set1_epi32( 2 ) ), _mm256_set1_epi32( 2 ) ) ) ) ) ;
+	s	= _mm256_xor_ps( s, _mm256_and_ps( neg, _mm256_castsi256_ps( _mm256_cmpeq_epi32( _mm256_and_si256( q, _mm256_set1_epi32( 2 ) ), _mm256_set1_epi32( 2 ) ) ) ) ) ;
+
+	_mm256_storeu_ps( out, _mm256_mul_ps( m, c ) ) ;
+	_mm256_storeu_ps( out + RNG_GB, _mm256_mul_ps( m, s ) ) ;
+}
+
+#endif
+
+#ifndef RNG_AVX2
+
+/*
+ * natural logarithm for x in ( 0, 1 ], Cephes logf without special cases
+ * */
+static float logPoly( float x ){
+	union { float f ; uint32_t i ; } u ;
+	float e, m, t, z, y ;
+
+	u.f	= x ;
+	e	= ( float )( ( int32_t )( u.i >> 23 ) - 126 ) ;
+	u.i	= ( u.i & 0x007FFFFFU ) | 0x3F000000U ;	// mantissa in [ 0.5, 1 )
+	m	= u.f ;
+
+	t	= m < SQRTHF ? m : 0.0f ;
+	e	= m < SQRTHF ? e - 1.0f : e ;
+	m	= ( m - 1.0f ) + t ;
+	z	= m * m ;
+
+	y	= LOG_P0 ;
+	y	= y * m + LOG_P1 ;
+	y	= y * m + LOG_P2 ;
+	y	= y * m + LOG_P3 ;
+	y	= y * m + LOG_P4 ;
+	y	= y * m + LOG_P5 ;
+	y	= y * m + LOG_P6 ;
+	y	= y * m + LOG_P7 ;
+	y	= y * m + LOG_P8 ;
+	y	= ( y * m ) * z ;
+	y	= y + e * LOG_Q1 ;
+	y	= y - 0.5f * z ;
+	m	= m + y ;
+
+	return m + e * LOG_Q2 ;
+}
+
+/*
+ * sin and cos of 2 * pi * w / 2^24 for a 24 bit w,
+ * reduced exactly in integers to quadrant j and x in [ -pi/4, pi/4 ]
+ * */
+static void sinCosPoly( uint32_t w, float *s, float *c ){
+	uint32_t j, q ;
+	float x, z, ps, pc ;
+
+	j	= ( w + ( 1U << 21 ) ) >> 22 ;
+	q	= j & 3U ;
+	x	= ( float )( ( int32_t )w - ( int32_t )( j << 22 ) ) * HALFPI22 ;
+	z	= x * x ;
+
+	ps	= SIN_P0 ;
+	ps	= ps * z + SIN_P1 ;
+	ps	= ps * z + SIN_P2 ;
+	ps	= ( ps * z ) * x + x ;
+
+	pc	= COS_P0 ;
+	pc	= pc * z + COS_P1 ;
+	pc	= pc * z + COS_P2 ;
+	pc	= ( pc * z ) * z ;
+	pc	= ( pc - 0.5f * z ) + 1.0f ;
+
+	*c	= ( q & 1U ) ? ps : pc ;
+	*s	= ( q & 1U ) ? pc : ps ;
+
+	if( ( q + 1U ) & 2U )
+		*c = -*c ;
+	if( q & 2U )
+		*s = -*s ;
+}
+
+#endif
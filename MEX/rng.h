@@ -0,0 +1,72 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Random number generators for the native simulation engine sim.c .
+
+	Counter-based Philox4x32-10: every output block is a pure function of
+	key = seed and counter = ( block, frame, point ), so any frame of any
+	Eb/N0 point can be generated by any thread, in any order, bit-exactly.
+
+	Gaussian samples: Box-Muller with own polynomial log and sin/cos,
+	so the results do not depend on the C library. The AVX2 path
+	( built with -mavx2 or -march=native ) gives the same bits as the scalar one.
+*/
+
+#ifndef QCLDPCRNG
+#define QCLDPCRNG
+
+#define RNG_GB 8			// Box-Muller pairs per block, one block makes 2 * RNG_GB samples
+
+typedef struct rng {
+	uint32_t	key[ 2 ] ;	// Philox key: seed
+	uint32_t	ctr[ 4 ] ;	// Philox counter: block, frame low, frame high, point
+	uint32_t	buf[ 4 ] ;	// current output block
+	int			idx ;		// next unused word in buf, 4 > empty
+} RNG ;
+
+// 	initialize generator for frame nr. frame of Eb/N0 point nr. point
+extern void RngFrame( RNG *r, uint64_t seed, uint32_t point, uint64_t frame ) ;
+
+//	next 64 random bits
+extern uint64_t RngNext( RNG *r ) ;
+
+//	el normally distributed samples with standard deviation sigma
+extern void RngGauss( RNG *r, float *out, int el, float sigma ) ;
+
+#endif
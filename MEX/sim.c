@@ -0,0 +1,758 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+#include <pthread.h>
+#include <assert.h>
+#include <math.h>
+#include <memory.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <stdio.h>
+
+#ifdef MATLAB_MEX_FILE
+	#include "mex.h"
+	#include "matrix.h"
+#endif
+
+#include <float.h>
+#include "ldpc.h"
+#include "debug.h"
+#include "encoder.h"
+#include "decoder.h"
+#include "rng.h"
+#include "demap.h"
+#include "sim.h"
+#include "latency.h"
+
+#ifdef BITMAP
+	#define SIM_K KW
+	#define SIM_N NW
+#else
+	#define SIM_K K
+	#define SIM_N N
+#endif
+
+#define sign( x ) ( ( x ) < 0 ? 1U : 0U )
+#define wrong( x, b ) ( ( x ) == 0 || sign( x ) != ( b ) )	// a zero posterior is undecided, an error for 0 and 1
+
+#define SIM_Z			1.959963984540054	// 95 % two-sided normal quantile
+#define SIM_MIN_FERR	10					// adaptive stopping needs at least this many frame errors
+
+#define SIM_SHARD_SHIFT	40									// frames of shard s start at s << SIM_SHARD_SHIFT
+
+#define CK_MAGIC		"YALDPCCK"
+#define CK_VERSION		3
+#define CK_HEAD			( 8 + 4 * 7 + 8 * 3 + 4 * 3 + 8 + 4 + 4 )	// see packHead()
+#define CK_POINT		( 8 + 4 + 8 * 5 + 8 )								// ebn0, point, 5 counters, time
+
+typedef struct sim_thread {
+	pthread_t	id ;
+	int			idx ;
+	int			nth ;		// nr. of threads in this round
+	uint64_t	first ;		// global index of the first frame in this round
+	int			nf ;		// frames in this round
+	uint32_t	point ;
+	uint64_t	seed ;
+	uint64_t	base ;		// RNG frame index of frame 0, selects the shard
+	int			allZero ;
+	int			qam ;
+	int			demap ;
+	float		sigma ;
+
+	//thread-local counters for this round
+	uint64_t	bitErr ;
+	uint64_t	bitErr2 ;
+	uint64_t	frameErr ;
+	uint64_t	iter ;
+
+	//thread-local buffers
+	WORD		data[ SIM_K ] ;
+	WORD		cw[ ( int )SIM_N ] ;
+	float		noise[ SIM_NOISE ] ;
+	FP			llr[ N ] ;
+	FP			apllr[ N ] ;
+
+} SIM_THREAD ;
+
+static SIM_THREAD *Thr = NULL ;
+
+//local functions
+static int prepare( const SIM_PARAMS *p ) ;
+static void setPoint( const SIM_PARAMS *p, const SIM_COUNTERS *c ) ;
+static int runRound( int nth, SIM_COUNTERS *c, int nf ) ;
+static int pointDone( const SIM_PARAMS *p, const SIM_COUNTERS *c ) ;
+static int packHead( uint8_t *b, const SIM_PARAMS *p, int np ) ;
+static int putU32( uint8_t *b, int i, uint32_t v ) ;
+static int putU64( uint8_t *b, int i, uint64_t v ) ;
+static int putF64( uint8_t *b, int i, double v ) ;
+static uint32_t getU32( const uint8_t *b, int i ) ;
+static uint64_t getU64( const uint8_t *b, int i ) ;
+static double getF64( const uint8_t *b, int i ) ;
+static uint32_t fnv1a( const uint8_t *b, int len ) ;
+static void *simThread( void *arg ) ;
+static void simFrame( SIM_THREAD *a, uint64_t frame ) ;
+static unsigned getBit( WORD *v, int i ) ;
+static int zeroErrors( FP *llr, int el ) ;
+static int popcount64( uint64_t x ) ;
+
+
+//global functions definitions-------------------------------------------------
+
+void SimData( RNG *r, WORD *data ){
+	int i, e ;
+	uint64_t x ;
+
+	#ifdef BITMAP
+		for( i = 0 ; i < SIM_K ; i++ ){
+			data[ i ] = ( WORD )RngNext( r ) ;
+		}
+	#else
+		for( i = 0 ; i < SIM_K ; i += 64 ){
+			x = RngNext( r ) ;
+			for( e = i ; e < SIM_K && e < i + 64 ; e++ ){
+				data[ e ] = ( WORD )( x & 1U ) ;
+				x >>= 1 ;
+			}
+		}
+	#endif
+}
+
+void SimChannel( RNG *r, WORD *cw, float *noise, FP *llr, float sigma ){
+	float y, scale ;
+	int i ;
+
+	scale = 2.0f / ( sigma * sigma ) ;
+
+	RngGauss( r, noise, N, sigma ) ;
+
+	if( cw == NULL ){
+		for( i = 0 ; i < N ; i++ ){
+			llr[ i ] = QuantizeLLR( scale * ( 1.0f + noise[ i ] ) ) ;
+		}
+		return ;
+	}
+
+	for( i = 0 ; i < N ; i++ ){
+		y = ( getBit( cw, i ) ? -1.0f : 1.0f ) + noise[ i ] ;	// BPSK: 0 > +1, 1 > -1
+		llr[ i ] = QuantizeLLR( scale * y ) ;
+	}
+}
+
+/*
+ * 802.11 bit order: first bits / 2 bits of a symbol on I, the rest on Q, MSB first
+ * */
+void SimChannelQAM( RNG *r, WORD *cw, int bits, int method, float *y, FP *llr, float sigma ){
+	uint64_t sc[ ( N + 63 ) / 64 ] ;
+	float lev[ 1 << ( QAM_MAX_BITS / 2 ) ] ;
+	unsigned lab ;
+	int i, s, t, m, ns ;
+
+	m	= bits / 2 ;
+	ns	= QamSymbols( bits, N ) ;
+
+	for( i = 0 ; i < 1 << m ; i++ ){
+		lev[ i ] = QamLevel( bits, ( unsigned )i ) ;
+	}
+
+	RngGauss( r, y, 2 * ns, sigma ) ;
+
+	for( i = 0 ; i < ( N + 63 ) / 64 ; i++ ){
+		sc[ i ] = cw == NULL ? RngNext( r ) : 0 ;
+	}
+
+	for( s = 0 ; s < ns ; s++ ){
+		for( lab = 0, t = 0 ; t < bits ; t++ ){
+			i	= s * bits + t ;
+			lab	= lab << 1 | ( i < N ? ( unsigned )( sc[ i >> 6 ] >> ( i & 63 ) & 1U ) ^ ( cw == NULL ? 0U : getBit( cw, i ) ) : 0U ) ;
+		}
+		y[ 2 * s ]		+= lev[ lab >> m ] ;
+		y[ 2 * s + 1 ]	+= lev[ lab & ( ( 1U << m ) - 1 ) ] ;
+	}
+
+	QamDemapFP( y, ns, bits, sigma, method, llr, N ) ;
+
+	if( cw == NULL ){
+		for( i = 0 ; i < N ; i++ ){
+			llr[ i ] = ( sc[ i >> 6 ] >> ( i & 63 ) & 1U ) ? -llr[ i ] : llr[ i ] ;
+		}
+	}
+}
+
+int SimRunPoint( const SIM_PARAMS *p, SIM_COUNTERS *c ){
+	int nf, nth ;
+	uint64_t t0 ;
+
+	if( ( nth = prepare( p ) ) < 1 ){
+		return -1 ;
+	}
+
+	setPoint( p, c ) ;
+	t0 = LatNow() ;
+
+	while( c->bitErr < p->minErr && ( p->maxFrames == 0 || c->frames < p->maxFrames ) ){
+
+		nf = p->blkSize ;
+		if( p->maxFrames > 0 && c->frames + nf > p->maxFrames ){
+			nf = ( int )( p->maxFrames - c->frames ) ;
+		}
+
+		if( runRound( nth, c, nf ) != 0 ){
+			return -1 ;
+		}
+	}
+
+	c->time += 1e-9 * ( double )( LatNow() - t0 ) ;
+
+	return 0 ;
+}
+
+/*
+ * adaptive sweep: every round goes to the unfinished point with the widest relative interval,
+ * points without errors first, lower Eb/N0 first on ties
+ * fixed sweep: points in order
+ * */
+int SimRunSweep( const SIM_PARAMS *p, SIM_COUNTERS *c, int np, void ( *report )( const SIM_COUNTERS *c ) ){
+	SIM_CI ci ;
+	int i, x, nf, nth ;
+	double rel ;
+	uint64_t t0, tck ;
+
+	if( ( nth = prepare( p ) ) < 1 ){
+		return -1 ;
+	}
+	if( p->relCI > 0.0 ? p->maxFrames == 0 && p->ferFloor <= 0.0 : p->maxFrames == 0 && p->minErr == 0 ){
+		return -1 ;
+	}
+
+	tck = LatNow() ;
+
+	for( ;; ){
+		x	= -1 ;
+		rel	= 0.0 ;
+
+		for( i = 0 ; i < np ; i++ ){
+			if( pointDone( p, c + i ) )
+				continue ;
+
+			if( p->relCI <= 0.0 ){
+				x = i ;
+				break ;
+			}
+
+			SimInterval( c + i, &ci ) ;
+			if( x < 0 || ci.rel > rel ){
+				x	= i ;
+				rel	= ci.rel ;
+			}
+		}
+
+		if( x < 0 )
+			break ;
+
+		nf = p->blkSize ;
+		if( p->maxFrames > 0 && c[ x ].frames + nf > p->maxFrames ){
+			nf = ( int )( p->maxFrames - c[ x ].frames ) ;
+		}
+
+		setPoint( p, c + x ) ;
+		t0 = LatNow() ;
+
+		if( runRound( nth, c + x, nf ) != 0 ){
+			return -1 ;
+		}
+
+		c[ x ].time += 1e-9 * ( double )( LatNow() - t0 ) ;
+
+		if( p->ckptFile != NULL && 1e-9 * ( double )( LatNow() - tck ) >= p->ckptPeriod ){
+			if( SimSaveCheckpoint( p, c, np ) != 0 ){
+				return -1 ;
+			}
+			tck = LatNow() ;
+		}
+
+		if( report != NULL && pointDone( p, c + x ) ){
+			report( c + x ) ;
+		}
+	}
+
+	if( p->ckptFile != NULL ){
+		return SimSaveCheckpoint( p, c, np ) ;
+	}
+
+	return 0 ;
+}
+
+/*
+ * checkpoint: fixed-width little endian fields, FNV-1a checksum at the end,
+ * written to a temporary file first and then renamed, so a crash never leaves a broken checkpoint
+ * */
+int SimSaveCheckpoint( const SIM_PARAMS *p, const SIM_COUNTERS *c, int np ){
+	uint8_t *buf ;
+	char *tmp ;
+	FILE *f ;
+	int i, len, ok ;
+
+	len	= CK_HEAD + np * CK_POINT + 4 ;
+	buf	= ( uint8_t * )malloc( len ) ;
+	tmp	= ( char * )malloc( strlen( p->ckptFile ) + 5 ) ;
+
+	if( buf == NULL || tmp == NULL ){
+		free( buf ) ;
+		free( tmp ) ;
+		return -1 ;
+	}
+
+	i = packHead( buf, p, np ) ;
+	for( ; np > 0 ; np--, c++ ){
+		i = putF64( buf, i, c->ebn0 ) ;
+		i = putU32( buf, i, c->point ) ;
+		i = putU64( buf, i, c->bitErr ) ;
+		i = putU64( buf, i, c->bitErr2 ) ;
+		i = putU64( buf, i, c->frameErr ) ;
+		i = putU64( buf, i, c->frames ) ;
+		i = putU64( buf, i, c->iter ) ;
+		i = putF64( buf, i, c->time ) ;
+	}
+	i = putU32( buf, i, fnv1a( buf, i ) ) ;
+	assert( i == len ) ;
+
+	sprintf( tmp, "%s.tmp", p->ckptFile ) ;
+
+	ok = ( f = fopen( tmp, "wb" ) ) != NULL ;
+	if( ok ){
+		ok = fwrite( buf, 1, len, f ) == ( size_t )len ;
+		ok = ( fclose( f ) == 0 ) && ok ;
+	}
+	if( ok && rename( tmp, p->ckptFile ) != 0 ){	// Windows does not replace existing files
+		remove( p->ckptFile ) ;
+		ok = rename( tmp, p->ckptFile ) == 0 ;
+	}
+
+	free( buf ) ;
+	free( tmp ) ;
+
+	return ok ? 0 : -1 ;
+}
+
+/*
+ * counters are only restored if the whole configuration matches,
+ * the RNG stream position of a point is its frame count, so the run continues bit-exactly
+ * */
+int SimLoadCheckpoint( const SIM_PARAMS *p, SIM_COUNTERS *c, int np ){
+	uint8_t head[ CK_HEAD ] ;
+	uint8_t *buf ;
+	FILE *f ;
+	size_t rd ;
+	int i, x, len, ret ;
+
+	if( ( f = fopen( p->ckptFile, "rb" ) ) == NULL ){
+		return 0 ;
+	}
+
+	len = CK_HEAD + np * CK_POINT + 4 ;
+	if( ( buf = ( uint8_t * )malloc( len + 1 ) ) == NULL ){
+		fclose( f ) ;
+		return -1 ;
+	}
+
+	rd = fread( buf, 1, len + 1, f ) ;	// one more byte also rejects longer files
+	fclose( f ) ;
+
+	//configuration: header of this run must be byte-identical
+	packHead( head, p, np ) ;
+
+	if( rd < CK_HEAD || memcmp( head, buf, 12 ) != 0 ){
+		ret = -1 ;
+	}else if( memcmp( head, buf, CK_HEAD ) != 0 ){
+		ret = -2 ;
+	}else if( rd != ( size_t )len || getU32( buf, len - 4 ) != fnv1a( buf, len - 4 ) ){
+		ret = -1 ;
+	}else{
+		ret = 1 ;
+	}
+
+	for( x = 0, i = CK_HEAD ; ret == 1 && x < np ; x++, i += CK_POINT ){
+		if( getF64( buf, i ) != c[ x ].ebn0 || getU32( buf, i + 8 ) != c[ x ].point ){
+			ret = -2 ;
+		}
+	}
+
+	for( x = 0, i = CK_HEAD + 12 ; ret == 1 && x < np ; x++, i += CK_POINT ){
+		c[ x ].bitErr	= getU64( buf, i ) ;
+		c[ x ].bitErr2	= getU64( buf, i + 8 ) ;
+		c[ x ].frameErr	= getU64( buf, i + 16 ) ;
+		c[ x ].frames	= getU64( buf, i + 24 ) ;
+		c[ x ].iter		= getU64( buf, i + 32 ) ;
+		c[ x ].time		= getF64( buf, i + 40 ) ;
+	}
+
+	free( buf ) ;
+
+	return ret ;
+}
+
+/*
+ * FER: Wilson score interval, frames are independent
+ * BER: normal interval of the mean nr. of bit errors per frame,
+ * 		errors within a frame are not independent, so the per-frame variance is used
+ * without bit errors: BER upper bound is the FER upper bound, relative width is infinite
+ * */
+void SimInterval( const SIM_COUNTERS *c, SIM_CI *ci ){
+	double n, f, z2, d, h, m, v ;
+
+	memset( ( void * )ci, 0, sizeof( SIM_CI ) ) ;
+	ci->rel = HUGE_VAL ;
+
+	if( c->frames == 0 ){
+		ci->berHi = ci->ferHi = 1.0 ;
+		return ;
+	}
+
+	n	= ( double )c->frames ;
+	f	= ( double )c->frameErr / n ;
+	z2	= SIM_Z * SIM_Z ;
+	d	= 1.0 + z2 / n ;
+	m	= ( f + z2 / ( 2.0 * n ) ) / d ;
+	h	= SIM_Z * sqrt( f * ( 1.0 - f ) / n + z2 / ( 4.0 * n * n ) ) / d ;
+
+	ci->fer		= f ;
+	ci->ferLo	= c->frameErr > 0 && m - h > 0.0 ? m - h : 0.0 ;
+	ci->ferHi	= m + h < 1.0 ? m + h : 1.0 ;
+
+	m	= ( double )c->bitErr / n ;
+	v	= c->frames > 1 ? ( ( double )c->bitErr2 - m * m * n ) / ( n - 1.0 ) : 0.0 ;
+	h	= SIM_Z * sqrt( v > 0.0 ? v / n : 0.0 ) ;
+
+	ci->ber		= m / K ;
+	ci->berLo	= m - h > 0.0 ? ( m - h ) / K : 0.0 ;
+	ci->berHi	= c->bitErr > 0 ? ( m + h ) / K : ci->ferHi ;
+
+	if( c->frameErr > 0 ){
+		ci->rel = ( ci->ferHi - ci->ferLo ) / ( 2.0 * f ) ;
+		if( h / m > ci->rel )
+			ci->rel = h / m ;
+	}
+}
+
+//local functions definitions---------------------------------------------------
+
+/*
+ * check parameters, allocate thread state
+ * more threads than decoder states ( 1 with decoder.c ) is an error, not a silent clamp
+ * returns the nr. of threads to use, 0 on error
+ * */
+static int prepare( const SIM_PARAMS *p ){
+	if( p->blkSize < 1 || p->rate <= 0.0 || p->threads < 1 || p->threads > MSThreads || ( p->qam > 1 && !QamValid( p->qam ) ) ){
+		return 0 ;
+	}
+
+	if( Thr == NULL ){
+		if( ( Thr = ( SIM_THREAD * )calloc( N_TH, sizeof( SIM_THREAD ) ) ) == NULL ){
+			return 0 ;
+		}
+	}
+
+	return p->threads ;
+}
+
+static void setPoint( const SIM_PARAMS *p, const SIM_COUNTERS *c ){
+	double snr, var ;
+	int t ;
+
+	snr	= pow( 10.0, c->ebn0 / 10.0 ) ;
+	var = 1.0 / ( 2.0 * snr * p->rate * ( p->qam > 1 ? p->qam : 1 ) ) ;	// Es = 1, per real dimension
+
+	for( t = 0 ; t < N_TH ; t++ ){
+		Thr[ t ].idx 	= t ;
+		Thr[ t ].point 	= c->point ;
+		Thr[ t ].seed 	= p->seed ;
+		Thr[ t ].base 	= ( uint64_t )p->shard << SIM_SHARD_SHIFT ;
+		Thr[ t ].allZero = p->allZero ;
+		Thr[ t ].qam 	= p->qam > 1 ? p->qam : 0 ;
+		Thr[ t ].demap 	= p->demap ;
+		Thr[ t ].sigma 	= ( float )sqrt( var ) ;
+	}
+}
+
+/*
+ * simulate frames c->frames .. c->frames + nf - 1 of the current point and accumulate counters
+ * */
+static int runRound( int nth, SIM_COUNTERS *c, int nf ){
+	int t, r ;
+
+	for( t = 0 ; t < nth ; t++ ){
+		Thr[ t ].nth		= nth ;
+		Thr[ t ].first		= c->frames ;
+		Thr[ t ].nf			= nf ;
+		Thr[ t ].bitErr		= 0 ;
+		Thr[ t ].bitErr2	= 0 ;
+		Thr[ t ].frameErr	= 0 ;
+		Thr[ t ].iter		= 0 ;
+	}
+
+	if( nth == 1 ){
+		simThread( ( void * )Thr ) ;
+	}else{
+		for( t = 0 ; t < nth ; t++ ){
+			if( ( r = pthread_create( &( Thr[ t ].id ), NULL, &simThread, ( void * )( Thr + t ) ) ) != 0 ){
+				return -1 ;
+			}
+		}
+		for( t = 0 ; t < nth ; t++ ){
+			if( ( r = pthread_join( Thr[ t ].id, NULL ) ) != 0 ){
+				return -1 ;
+			}
+		}
+	}
+
+	for( t = 0 ; t < nth ; t++ ){
+		c->bitErr	+= Thr[ t ].bitErr ;
+		c->bitErr2	+= Thr[ t ].bitErr2 ;
+		c->frameErr	+= Thr[ t ].frameErr ;
+		c->iter		+= Thr[ t ].iter ;
+	}
+	c->frames += nf ;
+
+	return 0 ;
+}
+
+/*
+ * sweep stopping rule for one point
+ * */
+static int pointDone( const SIM_PARAMS *p, const SIM_COUNTERS *c ){
+	SIM_CI ci ;
+
+	if( p->maxFrames > 0 && c->frames >= p->maxFrames )
+		return 1 ;
+
+	if( p->relCI <= 0.0 )
+		return c->bitErr >= p->minErr ;
+
+	SimInterval( c, &ci ) ;
+
+	if( c->frameErr >= SIM_MIN_FERR && ci.rel <= p->relCI )
+		return 1 ;
+
+	return p->ferFloor > 0.0 && c->frames > 0 && ci.ferHi < p->ferFloor ;
+}
+
+/*
+ * simulate frames idx, idx + nth, idx + 2 * nth ... of the current round
+ * carefull: print statements here only work in CLI, will crash MATLAB
+ * */
+static void *simThread( void *arg ){
+	SIM_THREAD *a = ( SIM_THREAD * )arg ;
+	int i ;
+
+	for( i = a->idx ; i < a->nf ; i += a->nth ){
+		simFrame( a, a->first + i ) ;
+	}
+
+	return NULL ;
+}
+
+/*
+ * one frame: random data > encoder > BPSK or QAM > AWGN > LLR > decoder > error count
+ * all-zero mode skips data and encoder, the code is linear and the channel symmetric,
+ * so both modes agree only statistically: random data takes RNG words before the noise
+ * is drawn, a frame of either mode sees different noise
+ * all random numbers of a frame come from its own counter-based stream
+ * */
+static void simFrame( SIM_THREAD *a, uint64_t frame ){
+	RNG rng ;
+	int i, e ;
+
+	RngFrame( &rng, a->seed, a->point, a->base + frame ) ;
+
+	if( a->allZero ){
+		if( a->qam ){
+			SimChannelQAM( &rng, NULL, a->qam, a->demap, a->noise, a->llr, a->sigma ) ;
+		}else{
+			SimChannel( &rng, NULL, a->noise, a->llr, a->sigma ) ;
+		}
+		a->iter += ( uint64_t )MSDecode( a->llr, a->apllr, a->idx ) ;
+		e = zeroErrors( a->apllr, K ) ;
+	}else{
+		SimData( &rng, a->data ) ;
+		QCLDPCEncodeCW( a->data, a->cw ) ;
+		if( a->qam ){
+			SimChannelQAM( &rng, a->cw, a->qam, a->demap, a->noise, a->llr, a->sigma ) ;
+		}else{
+			SimChannel( &rng, a->cw, a->noise, a->llr, a->sigma ) ;
+		}
+		a->iter += ( uint64_t )MSDecode( a->llr, a->apllr, a->idx ) ;
+
+		e = 0 ;
+		for( i = 0 ; i < K ; i++ ){
+			e += wrong( a->apllr[ i ], getBit( a->data, i ) ) ;
+		}
+	}
+
+	a->bitErr	+= e ;
+	a->bitErr2	+= ( uint64_t )e * ( uint64_t )e ;
+	a->frameErr	+= e > 0 ;
+}
+
+/*
+ * bit i of a codeword or dataword, bitmap words store bits MSB first
+ * */
+static unsigned getBit( WORD *v, int i ){
+	#ifdef BITMAP
+		return ( unsigned )( v[ i >> WBE ] >> ( WB - 1 - ( i & ( WB - 1 ) ) ) ) & 1U ;
+	#else
+		return ( unsigned )v[ i ] ;
+	#endif
+}
+
+/*
+ * checkpoint header: format, compiled-in code, decoder and channel setup, nr. of points
+ * everything that changes the results, but neither the nr. of threads nor the stopping rules,
+ * so a finished sweep can be resumed with a tighter target
+ * */
+static int packHead( uint8_t *b, const SIM_PARAMS *p, int np ){
+	uint32_t h ;
+	int i, j ;
+
+	memcpy( ( void * )b, CK_MAGIC, 8 ) ;
+	i = 8 ;
+	i = putU32( b, i, CK_VERSION ) ;
+	i = putU32( b, i, N ) ;
+	i = putU32( b, i, K ) ;
+	i = putU32( b, i, Z ) ;
+	i = putU32( b, i, ( uint32_t )sizeof( FP ) ) ;
+
+	h = 0 ;
+	for( j = 0 ; j < MB * NB ; j++ ){
+		h = h * 31U + ( uint32_t )( ( const int8_t * )HBM )[ j ] ;
+	}
+	i = putU32( b, i, h ) ;
+
+	i = putU32( b, i, ( uint32_t )p->nIter ) ;
+	i = putF64( b, i, p->norm ) ;
+	i = putF64( b, i, p->offset ) ;
+	i = putF64( b, i, p->rate ) ;
+	i = putU32( b, i, ( uint32_t )p->allZero ) ;
+	i = putU32( b, i, ( uint32_t )( p->qam > 1 ? p->qam : 1 ) ) ;
+	i = putU32( b, i, ( uint32_t )p->demap ) ;
+	i = putU64( b, i, p->seed ) ;
+	i = putU32( b, i, p->shard ) ;
+	i = putU32( b, i, ( uint32_t )np ) ;
+
+	assert( i == CK_HEAD ) ;
+
+	return i ;
+}
+
+static int putU32( uint8_t *b, int i, uint32_t v ){
+	int j ;
+
+	for( j = 0 ; j < 4 ; j++ ){
+		b[ i + j ] = ( uint8_t )( v >> ( 8 * j ) ) ;
+	}
+	return i + 4 ;
+}
+
+static int putU64( uint8_t *b, int i, uint64_t v ){
+	i = putU32( b, i, ( uint32_t )v ) ;
+	return putU32( b, i, ( uint32_t )( v >> 32 ) ) ;
+}
+
+static int putF64( uint8_t *b, int i, double v ){
+	uint64_t u ;
+
+	memcpy( ( void * )&u, ( void * )&v, 8 ) ;
+	return putU64( b, i, u ) ;
+}
+
+static uint32_t getU32( const uint8_t *b, int i ){
+	return ( uint32_t )b[ i ] | ( uint32_t )b[ i + 1 ] << 8 | ( uint32_t )b[ i + 2 ] << 16 | ( uint32_t )b[ i + 3 ] << 24 ;
+}
+
+static uint64_t getU64( const uint8_t *b, int i ){
+	return ( uint64_t )getU32( b, i ) | ( uint64_t )getU32( b, i + 4 ) << 32 ;
+}
+
+static double getF64( const uint8_t *b, int i ){
+	uint64_t u = getU64( b, i ) ;
+	double v ;
+
+	memcpy( ( void * )&v, ( void * )&u, 8 ) ;
+	return v ;
+}
+
+static uint32_t fnv1a( const uint8_t *b, int len ){
+	uint32_t h = 2166136261U ;
+	int i ;
+
+	for( i = 0 ; i < len ; i++ ){
+		h = ( h ^ b[ i ] ) * 16777619U ;
+	}
+	return h ;
+}
+
+/*
+ * data bit errors of the all-zero codeword: 64 hard decisions packed, then popcount,
+ * a zero posterior counts as an error as in random-data mode ( wrong() )
+ * */
+static int zeroErrors( FP *llr, int el ){
+	uint64_t hd ;
+	int i, j, e = 0 ;
+
+	for( i = 0 ; i < el ; i += 64 ){
+		hd = 0 ;
+		for( j = i ; j < el && j < i + 64 ; j++ ){
+			hd |= ( uint64_t )( llr[ j ] <= 0 ) << ( j - i ) ;
+		}
+		e += popcount64( hd ) ;
+	}
+
+	return e ;
+}
+
+static int popcount64( uint64_t x ){
+	#if defined( __GNUC__ )
+		return __builtin_popcountll( x ) ;
+	#else
+		x = x - ( ( x >> 1 ) & 0x5555555555555555ULL ) ;
+		x = ( x & 0x3333333333333333ULL ) + ( ( x >> 2 ) & 0x3333333333333333ULL ) ;
+		x = ( x + ( x >> 4 ) ) & 0x0F0F0F0F0F0F0F0FULL ;
+		return ( int )( ( x * 0x0101010101010101ULL ) >> 56 ) ;
+	#endif
+}
+
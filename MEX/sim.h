@@ -0,0 +1,150 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Native Monte Carlo BER/FER simulation engine:
+	data generation, encoding, BPSK, AWGN, decoding and error counting
+	all run in C, multithreaded with up to N_TH threads.
+
+	Needs encoder.c, rng.c, demap.c, latency.c and either decoder.c ( 1 thread ) or decoderMT.c .
+	Decoder must be initialized by MSInitDecoder(), encoder by QCLDPCInitEncoder() .
+
+	dont forget build switch for multithreaded version:
+	CLI: -pthread
+	MEX: -lpthread
+*/
+
+#ifndef QCLDPCSIM
+#define QCLDPCSIM
+
+#define SIM_NOISE ( N + 2 )	// noise samples per frame, enough for BPSK and every QAM
+
+typedef struct sim_params {
+	double		rate ;		// code rate, converts Eb/N0 to noise variance
+	uint64_t	minErr ;	// stop the point after this many bit errors
+	uint64_t	maxFrames ;	// stop the point after this many frames, 0 > unlimited
+	int			blkSize ;	// frames simulated between stopping checks
+	int			threads ;	// worker threads 1 .. N_TH, > 1 needs decoderMT.c
+	int			allZero ;	// 1 > transmit the all-zero codeword, no data and no encoder
+	int			qam ;		// bits per Gray-mapped QAM symbol 2 .. 10, 0 or 1 > BPSK
+	int			demap ;		// QAM soft demapper: DEMAP_MAXLOG or DEMAP_EXACT, see demap.h
+	double		relCI ;		// adaptive sweep: target relative half-width of the 95 % BER and FER intervals
+	double		ferFloor ;	// adaptive sweep: point is done when its FER upper bound is below, 0 > off
+	uint64_t	seed ;		// RNG seed, same seed > same results
+	uint32_t	shard ;		// worker of a sharded sweep, every shard has its own RNG streams, 0 > not sharded
+	const char	*ckptFile ;	// sweep checkpoint file, NULL > off
+	double		ckptPeriod ;// seconds between checkpoints, the last one is written when the sweep ends
+	int			nIter ;		// decoder setup, only stored in and checked against checkpoints
+	double		norm ;
+	double		offset ;
+} SIM_PARAMS ;
+
+typedef struct sim_counters {
+	double		ebn0 ;		// Eb/N0 of this point in dB, set by caller
+	uint32_t	point ;		// index of the point, selects the RNG stream, set by caller
+	uint64_t	bitErr ;	// data bit errors
+	uint64_t	bitErr2 ;	// sum of squared per-frame bit errors, for the BER interval
+	uint64_t	frameErr ;	// frames with at least one data bit error
+	uint64_t	frames ;	// frames simulated
+	uint64_t	iter ;		// sum of decoder iterations over all frames
+	double		time ;		// wall-clock time in seconds
+} SIM_COUNTERS ;
+
+typedef struct sim_ci {
+	double		ber, berLo, berHi ;
+	double		fer, ferLo, ferHi ;
+	double		rel ;		// larger of the BER and FER relative half-widths, HUGE_VAL without errors
+} SIM_CI ;
+
+/*
+	simulate one Eb/N0 point until p->minErr bit errors or p->maxFrames frames,
+	counters in c are accumulated, so a point can be continued
+
+	returns 0 on success, -1 on error
+*/
+extern int SimRunPoint( const SIM_PARAMS *p, SIM_COUNTERS *c ) ;
+
+/*
+	sweep over np points, ebn0 and point of every c[ i ] set by caller, counters accumulated:
+	run in rounds of p->blkSize frames until every point is finished.
+
+	p->relCI > 0, adaptive: each round goes to the unfinished point with the widest relative
+	confidence interval, a point is finished at p->relCI with at least 10 frame errors,
+	p->maxFrames or p->ferFloor, p->minErr is not used, p->maxFrames or p->ferFloor must be set.
+	p->relCI == 0, fixed: points in order, each until p->minErr or p->maxFrames .
+
+	report, if not NULL, is called once a point is finished
+	p->ckptFile, if not NULL, gets a checkpoint every p->ckptPeriod seconds and in the end
+
+	returns 0 on success, -1 on error
+*/
+extern int SimRunSweep( const SIM_PARAMS *p, SIM_COUNTERS *c, int np, void ( *report )( const SIM_COUNTERS *c ) ) ;
+
+/*
+	write checkpoint: configuration, counters of all points, the RNG position of a point is its frame count
+	returns 0 on success, -1 on error
+*/
+extern int SimSaveCheckpoint( const SIM_PARAMS *p, const SIM_COUNTERS *c, int np ) ;
+
+/*
+	resume: restore counters from p->ckptFile, ebn0 and point of every c[ i ] set by caller
+	returns 1 if restored, 0 if there is no checkpoint,
+	-1 if it is unreadable or corrupt, -2 if it belongs to a different configuration
+*/
+extern int SimLoadCheckpoint( const SIM_PARAMS *p, SIM_COUNTERS *c, int np ) ;
+
+//	95 % confidence intervals of BER and FER
+extern void SimInterval( const SIM_COUNTERS *c, SIM_CI *ci ) ;
+
+//	random dataword, K bits or KW bitmap words
+extern void SimData( RNG *r, WORD *data ) ;
+
+/*
+	BPSK over AWGN with standard deviation sigma, channel LLRs for the decoder,
+	noise is a scratch buffer of N samples, cw == NULL > all-zero codeword
+*/
+extern void SimChannel( RNG *r, WORD *cw, float *noise, FP *llr, float sigma ) ;
+
+/*
+	same for Gray-mapped 2^bits-QAM, sigma per real dimension, y is a scratch buffer
+	of SIM_NOISE floats, cw == NULL > all-zero codeword: random scrambling bits are
+	mapped and the sign of their LLRs flipped back, which keeps the channel symmetric
+*/
+extern void SimChannelQAM( RNG *r, WORD *cw, int bits, int method, float *y, FP *llr, float sigma ) ;
+
+#endif
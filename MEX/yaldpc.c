@@ -0,0 +1,1276 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	libyaldpc: code handles, encoders, decoders and streams of yaldpc.h .
+
+	The decoder is MSDecode() of decoder.c for a code handle: the same
+	layered schedule and the same kernels, so a code made from the HBM of
+	ldpc.c decodes bit-exactly like the float MEX and CLI builds.
+	The encoder is encoder.c on unpacked bits.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define YALDPC_BUILD
+#include "yaldpc.h"
+#include "yaldpc_int.h"
+
+#include "schedule.inc"
+
+#if YALDPC_SCHED_NATURAL != LS_NATURAL || YALDPC_SCHED_OVERLAP != LS_OVERLAP
+	#error "yaldpc.h and schedule.inc disagree on the layer schedules"
+#endif
+
+#define Y_ZMAX		128		// shifts are int8_t in hbm and in code files
+
+#define Y_ANNEXG	0		// see ENC_ANNEXG in encoder.h
+#define Y_GENERIC	1
+
+/*
+	code file, fixed-width little endian fields, every section 8-byte aligned:
+		header		Y_FILE_HEAD bytes, see yaldpc_code_save()
+		hbm			int8 mb x nb
+		tables		YALDPC_FILE_TABLES: deg int32 mb, col and shift int16 mb x nb, order int16 mb
+		plan		YALDPC_FILE_PLAN of a generic encoder: piS int16 mb x mb, piSh int16 mb x mb x z
+		checksum	FNV-1a of everything before, uint32
+*/
+#define Y_FILE_MAGIC	"YALDPCCF"
+#define Y_FILE_VERSION	1
+#define Y_FILE_HEAD		48
+#define Y_ALIGN8( x )	( ( ( x ) + 7 ) & ~( size_t )7 )
+
+enum { F_HBM = 0, F_DEG, F_COL, F_SHIFT, F_ORDER, F_PIS, F_PISH, F_SUM, F_COUNT } ;
+
+struct yaldpc_encoder {
+	const YCODE		*code ;
+	int				method ;
+	int				p0 ;		// Annex G: inverse rotation of the first parity block
+	const int16_t	*piS ;		// generic: nr. of shifts of each circulant of Hp^-1, mb x mb
+	const int16_t	*piSh ;		// generic: shifts of each circulant of Hp^-1, mb x mb x z
+	int16_t			*mem ;		// piS and piSh made here, NULL for the plan of a code file
+} ;
+
+struct yaldpc_decoder {
+	const YCODE			*code ;
+	yaldpc_dec_params	p ;
+	float		*zold ;			// aka Zn(k-1), the posteriors
+	float		*zr ;			// zold in the rotation layout of layerMinSum, 2 x n
+	float		*lin ;			// channel LLRs of yaldpc_decode_typed()
+	float		*zt ;			// tiers, mb x n
+	float		*lm ;			// 2 x m: min1, min2 of all checks
+	uint32_t	*ls ;			// sign bitmaps of all checks
+	uint8_t		*li ;			// index of min1 of all checks
+	uint8_t		*hd ;
+	int			converged ;
+} ;
+
+//a frame in a stream
+typedef struct yslot {
+	const float	*llr ;
+	float		*apllr ;
+	void		*tag ;
+	int			iter ;
+	int			conv ;
+	int			done ;
+} YSLOT ;
+
+struct yaldpc_stream {
+	int				nth, ndec, depth ;
+	int				sync ;		// mutex and conditions initialized
+	pthread_t		*th ;
+	yaldpc_decoder	**dec ;		// one per thread
+	YSLOT			*q ;		// depth slots, frame f in q[ f % depth ]
+	long			head ;		// next frame to return by wait
+	long			next ;		// next frame to decode
+	long			tail ;		// next frame to submit
+	int				started ;	// threads that took their decoder
+	int				quit ;
+	pthread_mutex_t	mx ;
+	pthread_cond_t	work ;		// frames to decode or quit
+	pthread_cond_t	done ;		// a frame decoded or returned
+} ;
+
+static pthread_once_t KernelOnce = PTHREAD_ONCE_INIT ;
+
+//registry of yaldpc_code_get(), slots of YStdCode()
+static yaldpc_code *Registry[ Y_NSTD ] ;
+static pthread_mutex_t RegistryLock = PTHREAD_MUTEX_INITIALIZER ;
+
+//element sizes of YALDPC_FLOAT .. YALDPC_INT8
+static const size_t LLRSize[] = { sizeof( float ), sizeof( double ), sizeof( int16_t ), sizeof( int8_t ) } ;
+
+static YCODE *newCode( int mb, int nb, int z ) ;
+static int initTables( YCODE *c, const int8_t *hbm ) ;
+static int checkTables( const YCODE *c ) ;
+static int checkPlan( const YCODE *c ) ;
+static size_t fileLayout( int flags, int mb, int nb, int z, int generic, size_t *off ) ;
+static int littleEndian( void ) ;
+static int inPlace( void ) ;
+static void putU32( uint8_t *b, size_t i, uint32_t v ) ;
+static void putU16( uint8_t *b, size_t i, uint16_t v ) ;
+static uint32_t getU32( const uint8_t *b, size_t i ) ;
+static uint32_t fnv1a( const uint8_t *b, size_t len ) ;
+static void rot( uint8_t *dst, const uint8_t *src, int s, int z ) ;
+static void vxor( uint8_t *dst, const uint8_t *v, int z ) ;
+static int checkAnnexG( const YCODE *c ) ;
+static int initGenericPlan( yaldpc_encoder *e ) ;
+static void encodeFrame( const yaldpc_encoder *e, const uint8_t *in, uint8_t *out, uint8_t *si, uint8_t *t ) ;
+static int decodeFrame( yaldpc_decoder *d, const float *llch, float *apllr ) ;
+static int iterate( yaldpc_decoder *d, const float *llch ) ;
+static void *streamThread( void *arg ) ;
+
+
+//global functions definitions-------------------------------------------------
+
+unsigned yaldpc_version( void ){
+	return YALDPC_VERSION ;
+}
+
+const char *yaldpc_strerror( int err ){
+	switch( err ){
+		case YALDPC_OK:			return "OK" ;
+		case YALDPC_EINVAL:		return "invalid argument" ;
+		case YALDPC_ENOMEM:		return "out of memory" ;
+		case YALDPC_ENOCODE:	return "no such standard code" ;
+		case YALDPC_ENOTSUP:	return "code not supported" ;
+		case YALDPC_ETHREAD:	return "cannot start a thread" ;
+		case YALDPC_EIO:		return "cannot read or write the file" ;
+		case YALDPC_EFORMAT:	return "not a valid code file" ;
+		default:				return "unknown error" ;
+	}
+}
+
+const char *yaldpc_isa( void ){
+	pthread_once( &KernelOnce, YKernelInit ) ;
+	return YKernelISA() ;
+}
+
+int yaldpc_code_create( int mb, int nb, int z, const int8_t *hbm, yaldpc_code **code ){
+	YCODE *c ;
+	int r ;
+
+	if( code == NULL || hbm == NULL || mb < 1 || nb <= mb || z < 1 || z > Y_ZMAX )
+		return YALDPC_EINVAL ;
+	*code = NULL ;
+
+	if( ( c = newCode( mb, nb, z ) ) == NULL )
+		return YALDPC_ENOMEM ;
+	if( ( r = initTables( c, hbm ) ) != YALDPC_OK ){
+		yaldpc_code_free( c ) ;
+		return r ;
+	}
+
+	*code = c ;
+	return YALDPC_OK ;
+}
+
+int yaldpc_code_standard( int std, int rnum, int rden, int n, char variant, yaldpc_code **code ){
+	const int8_t *hbm ;
+	int mb, z, id, r ;
+
+	if( code == NULL )
+		return YALDPC_EINVAL ;
+	*code = NULL ;
+
+	if( ( r = YStdCode( std, rnum, rden, n, variant, &hbm, &mb, &z, &id ) ) != YALDPC_OK )
+		return r ;
+
+	return yaldpc_code_create( mb, 24, z, hbm, code ) ;
+}
+
+int yaldpc_code_get( int std, int rnum, int rden, int n, char variant, const yaldpc_code **code ){
+	const int8_t *hbm ;
+	int mb, z, id, r ;
+
+	if( code == NULL )
+		return YALDPC_EINVAL ;
+	*code = NULL ;
+
+	if( ( r = YStdCode( std, rnum, rden, n, variant, &hbm, &mb, &z, &id ) ) != YALDPC_OK )
+		return r ;
+
+	pthread_mutex_lock( &RegistryLock ) ;
+	if( Registry[ id ] == NULL )
+		r = yaldpc_code_create( mb, 24, z, hbm, Registry + id ) ;
+	*code = Registry[ id ] ;
+	pthread_mutex_unlock( &RegistryLock ) ;
+
+	return r ;
+}
+
+void yaldpc_code_free( yaldpc_code *code ){
+	if( code == NULL )
+		return ;
+	if( code->map != NULL )
+		munmap( code->map, code->mapLen ) ;
+	free( code->mem ) ;
+	free( code ) ;
+}
+
+/*
+ * the schedule of a code made by yaldpc_code_create() is in c->mem, that of mapped tables
+ * is read-only, it then gets a block of its own, also freed by yaldpc_code_free();
+ * shared registry codes keep the natural order
+ * */
+int yaldpc_code_schedule( yaldpc_code *code, int sched ){
+	int16_t *order ;
+	int i, shared = 0 ;
+
+	if( code == NULL || ( sched != YALDPC_SCHED_NATURAL && sched != YALDPC_SCHED_OVERLAP ) )
+		return YALDPC_EINVAL ;
+
+	//registry codes are read by decoders of other callers
+	pthread_mutex_lock( &RegistryLock ) ;
+	for( i = 0 ; i < Y_NSTD ; i++ )
+		shared |= Registry[ i ] == code ;
+	pthread_mutex_unlock( &RegistryLock ) ;
+	if( shared )
+		return YALDPC_EINVAL ;
+
+	if( code->mem != NULL ){
+		order = ( int16_t * )code->order ;
+	}else{
+		if( ( order = ( int16_t * )malloc( sizeof( int16_t ) * code->mb ) ) == NULL )
+			return YALDPC_ENOMEM ;
+		code->mem	= order ;
+		code->order	= order ;
+	}
+
+	return layerSchedule( sched, code->mb, code->nb, code->hbm, order ) < 0 ? YALDPC_ENOMEM : YALDPC_OK ;
+}
+
+/*
+ * the file is written to a temporary file first and then renamed, see SimSaveCheckpoint()
+ * */
+int yaldpc_code_save( const yaldpc_code *code, const char *file, int flags ){
+	yaldpc_encoder *e = NULL ;
+	size_t off[ F_COUNT ], len, i ;
+	uint8_t *b ;
+	char *tmp ;
+	FILE *f ;
+	int method = -1, p0 = 0, r = YALDPC_OK, ok ;
+	const int16_t *piS = NULL, *piSh = NULL ;
+
+	if( code == NULL || file == NULL || ( flags & ~( YALDPC_FILE_TABLES | YALDPC_FILE_PLAN ) ) != 0 )
+		return YALDPC_EINVAL ;
+
+	if( flags & YALDPC_FILE_PLAN ){
+		if( code->encMethod < 0 ){
+			if( ( r = yaldpc_encoder_create( code, &e ) ) != YALDPC_OK )
+				return r ;
+			method	= e->method ;
+			p0		= e->p0 ;
+			piS		= e->piS ;
+			piSh	= e->piSh ;
+		}else{
+			method	= code->encMethod ;
+			p0		= code->encP0 ;
+			piS		= code->piS ;
+			piSh	= code->piSh ;
+		}
+	}
+
+	len	= fileLayout( flags, code->mb, code->nb, code->z, method == Y_GENERIC, off ) ;
+	b	= ( uint8_t * )calloc( len, 1 ) ;
+	tmp	= ( char * )malloc( strlen( file ) + 5 ) ;
+	if( b == NULL || tmp == NULL ){
+		r = YALDPC_ENOMEM ;
+		goto done ;
+	}
+
+	memcpy( b, Y_FILE_MAGIC, 8 ) ;
+	putU32( b, 8, Y_FILE_VERSION ) ;
+	putU32( b, 12, ( uint32_t )flags ) ;
+	putU32( b, 16, ( uint32_t )code->mb ) ;
+	putU32( b, 20, ( uint32_t )code->nb ) ;
+	putU32( b, 24, ( uint32_t )code->z ) ;
+	putU32( b, 28, ( uint32_t )code->gmax ) ;
+	putU32( b, 32, ( uint32_t )method ) ;
+	putU32( b, 36, ( uint32_t )p0 ) ;
+	putU32( b, 40, ( uint32_t )len ) ;
+	putU32( b, 44, 0 ) ;
+
+	memcpy( b + off[ F_HBM ], code->hbm, ( size_t )code->mb * code->nb ) ;
+	if( flags & YALDPC_FILE_TABLES ){
+		for( i = 0 ; i < ( size_t )code->mb ; i++ ){
+			putU32( b, off[ F_DEG ] + 4 * i, ( uint32_t )code->deg[ i ] ) ;
+			putU16( b, off[ F_ORDER ] + 2 * i, ( uint16_t )code->order[ i ] ) ;
+		}
+		for( i = 0 ; i < ( size_t )code->mb * code->nb ; i++ ){
+			putU16( b, off[ F_COL ] + 2 * i, ( uint16_t )code->col[ i ] ) ;
+			putU16( b, off[ F_SHIFT ] + 2 * i, ( uint16_t )code->shift[ i ] ) ;
+		}
+	}
+	if( method == Y_GENERIC ){
+		for( i = 0 ; i < ( size_t )code->mb * code->mb ; i++ )
+			putU16( b, off[ F_PIS ] + 2 * i, ( uint16_t )piS[ i ] ) ;
+		for( i = 0 ; i < ( size_t )code->mb * code->mb * code->z ; i++ )
+			putU16( b, off[ F_PISH ] + 2 * i, ( uint16_t )piSh[ i ] ) ;
+	}
+	putU32( b, off[ F_SUM ], fnv1a( b, off[ F_SUM ] ) ) ;
+
+	sprintf( tmp, "%s.tmp", file ) ;
+
+	ok = ( f = fopen( tmp, "wb" ) ) != NULL ;
+	if( ok ){
+		ok = fwrite( b, 1, len, f ) == len ;
+		ok = ( fclose( f ) == 0 ) && ok ;
+	}
+	if( ok && rename( tmp, file ) != 0 ){
+		remove( file ) ;
+		ok = rename( tmp, file ) == 0 ;
+	}
+	r = ok ? YALDPC_OK : YALDPC_EIO ;
+
+done:
+	yaldpc_encoder_free( e ) ;
+	free( b ) ;
+	free( tmp ) ;
+	return r ;
+}
+
+/*
+ * the file is mapped, on little endian hosts its tables and plan are used in place,
+ * they are only checked for consistency with hbm, not rebuilt ( see inPlace() )
+ * */
+int yaldpc_code_load( const char *file, yaldpc_code **code ){
+	struct stat st ;
+	size_t off[ F_COUNT ], len ;
+	const uint8_t *b ;
+	void *map ;
+	YCODE *c = NULL ;
+	int16_t *order ;
+	int fd, flags, mb, nb, z, method, r, i ;
+
+	if( code == NULL || file == NULL )
+		return YALDPC_EINVAL ;
+	*code = NULL ;
+
+	if( ( fd = open( file, O_RDONLY ) ) < 0 )
+		return YALDPC_EIO ;
+	if( fstat( fd, &st ) != 0 || st.st_size < Y_FILE_HEAD + 4 ){
+		close( fd ) ;
+		return YALDPC_EFORMAT ;
+	}
+	len = ( size_t )st.st_size ;
+	map = mmap( NULL, len, PROT_READ, MAP_PRIVATE, fd, 0 ) ;
+	close( fd ) ;
+	if( map == MAP_FAILED )
+		return YALDPC_EIO ;
+	b = ( const uint8_t * )map ;
+
+	flags	= ( int )getU32( b, 12 ) ;
+	mb		= ( int )getU32( b, 16 ) ;
+	nb		= ( int )getU32( b, 20 ) ;
+	z		= ( int )getU32( b, 24 ) ;
+	method	= ( int )getU32( b, 32 ) ;
+
+	r = YALDPC_EFORMAT ;
+	if( memcmp( b, Y_FILE_MAGIC, 8 ) != 0 || getU32( b, 8 ) != Y_FILE_VERSION || getU32( b, 40 ) != len
+			|| getU32( b, len - 4 ) != fnv1a( b, len - 4 ) )
+		goto fail ;
+	if( ( flags & ~( YALDPC_FILE_TABLES | YALDPC_FILE_PLAN ) ) != 0 || mb < 1 || nb <= mb || nb > 4096 || z < 1 || z > Y_ZMAX )
+		goto fail ;
+	if( ( flags & YALDPC_FILE_PLAN ) && method != Y_ANNEXG && method != Y_GENERIC )
+		goto fail ;
+	if( fileLayout( flags, mb, nb, z, ( flags & YALDPC_FILE_PLAN ) && method == Y_GENERIC, off ) != len )
+		goto fail ;
+
+	if( ( flags & YALDPC_FILE_TABLES ) && inPlace() ){
+		//index tables in place
+		if( ( c = ( YCODE * )calloc( 1, sizeof( YCODE ) ) ) == NULL ){
+			r = YALDPC_ENOMEM ;
+			goto fail ;
+		}
+		c->mb		= mb ;
+		c->nb		= nb ;
+		c->kb		= nb - mb ;
+		c->z		= z ;
+		c->n		= nb * z ;
+		c->m		= mb * z ;
+		c->k		= c->n - c->m ;
+		c->gmax		= ( int )getU32( b, 28 ) ;
+		c->encMethod = -1 ;
+		c->hbm		= ( const int8_t * )( b + off[ F_HBM ] ) ;
+		c->deg		= ( const int * )( const void * )( b + off[ F_DEG ] ) ;
+		c->col		= ( const int16_t * )( const void * )( b + off[ F_COL ] ) ;
+		c->shift	= ( const int16_t * )( const void * )( b + off[ F_SHIFT ] ) ;
+		c->order	= ( const int16_t * )( const void * )( b + off[ F_ORDER ] ) ;
+		if( checkTables( c ) != 0 ){
+			free( c ) ;
+			c = NULL ;
+			goto fail ;
+		}
+		pthread_once( &KernelOnce, YKernelInit ) ;
+	}else{
+		//tables made from hbm
+		if( ( r = yaldpc_code_create( mb, nb, z, ( const int8_t * )( b + off[ F_HBM ] ), &c ) ) != YALDPC_OK )
+			goto fail ;
+		if( flags & YALDPC_FILE_TABLES ){
+			//only the schedule of the file
+			order = ( int16_t * )c->order ;
+			for( i = 0 ; i < mb ; i++ )
+				order[ i ] = ( int16_t )( b[ off[ F_ORDER ] + 2 * i ] | b[ off[ F_ORDER ] + 2 * i + 1 ] << 8 ) ;
+			if( checkTables( c ) != 0 ){
+				yaldpc_code_free( c ) ;
+				r = YALDPC_EFORMAT ;
+				goto fail ;
+			}
+		}
+	}
+
+	if( ( flags & YALDPC_FILE_PLAN ) && inPlace() ){
+		c->encMethod	= method ;
+		c->encP0		= ( int )getU32( b, 36 ) ;
+		if( method == Y_GENERIC ){
+			c->piS	= ( const int16_t * )( const void * )( b + off[ F_PIS ] ) ;
+			c->piSh	= ( const int16_t * )( const void * )( b + off[ F_PISH ] ) ;
+		}
+		if( checkPlan( c ) != 0 ){
+			r = YALDPC_EFORMAT ;
+			c->map = map ;
+			c->mapLen = len ;
+			yaldpc_code_free( c ) ;
+			return r ;
+		}
+	}
+
+	if( c->mem == NULL || c->encMethod >= 0 ){
+		c->map		= map ;		//in use, unmapped by yaldpc_code_free()
+		c->mapLen	= len ;
+	}else{
+		munmap( map, len ) ;
+	}
+
+	*code = c ;
+	return YALDPC_OK ;
+
+fail:
+	munmap( map, len ) ;
+	return r ;
+}
+
+void yaldpc_code_get_info( const yaldpc_code *code, yaldpc_code_info *info ){
+	info->n		= code->n ;
+	info->k		= code->k ;
+	info->m		= code->m ;
+	info->z		= code->z ;
+	info->mb	= code->mb ;
+	info->nb	= code->nb ;
+	info->gmax	= code->gmax ;
+}
+
+int yaldpc_encoder_create( const yaldpc_code *code, yaldpc_encoder **enc ){
+	yaldpc_encoder *e ;
+	int i, p0 ;
+
+	if( code == NULL || enc == NULL )
+		return YALDPC_EINVAL ;
+	*enc = NULL ;
+
+	if( ( e = ( yaldpc_encoder * )calloc( 1, sizeof( yaldpc_encoder ) ) ) == NULL )
+		return YALDPC_ENOMEM ;
+	e->code = code ;
+
+	if( code->encMethod >= 0 ){
+		//plan of a code file
+		e->method	= code->encMethod ;
+		e->p0		= code->encP0 ;
+		e->piS		= code->piS ;
+		e->piSh		= code->piSh ;
+	}else if( checkAnnexG( code ) ){
+		//the non-paired value of column KB for inversion, see encodeAnnexG() in encoder.c
+		for( p0 = 0, i = 1 ; i < code->mb - 1 ; i++ ){
+			if( code->hbm[ i * code->nb + code->kb ] > -1 )
+				p0 = code->hbm[ i * code->nb + code->kb ] ;
+		}
+		e->method	= Y_ANNEXG ;
+		e->p0		= p0 > 0 ? code->z - p0 : 0 ;
+	}else{
+		e->method = Y_GENERIC ;
+		if( ( i = initGenericPlan( e ) ) != YALDPC_OK ){
+			yaldpc_encoder_free( e ) ;
+			return i ;
+		}
+	}
+
+	*enc = e ;
+	return YALDPC_OK ;
+}
+
+void yaldpc_encoder_free( yaldpc_encoder *enc ){
+	if( enc == NULL )
+		return ;
+	free( enc->mem ) ;
+	free( enc ) ;
+}
+
+int yaldpc_encode( const yaldpc_encoder *enc, const uint8_t *data, uint8_t *cw, int frames ){
+	const YCODE *c ;
+	uint8_t *si ;
+	int f ;
+
+	if( enc == NULL || data == NULL || cw == NULL || frames < 0 )
+		return YALDPC_EINVAL ;
+	c = enc->code ;
+
+	//scratch of the calling thread: tier sums and one block
+	if( ( si = ( uint8_t * )malloc( ( size_t )( c->mb + 1 ) * c->z ) ) == NULL )
+		return YALDPC_ENOMEM ;
+
+	for( f = 0 ; f < frames ; f++ ){
+		if( data + ( size_t )f * c->k != cw + ( size_t )f * c->n )
+			memmove( cw + ( size_t )f * c->n, data + ( size_t )f * c->k, c->k ) ;
+		encodeFrame( enc, cw + ( size_t )f * c->n, cw + ( size_t )f * c->n + c->k, si, si + c->m ) ;
+	}
+
+	free( si ) ;
+	return YALDPC_OK ;
+}
+
+void yaldpc_dec_params_default( yaldpc_dec_params *p ){
+	p->nIter	= 10 ;
+	p->lambda	= 1.0f ;
+	p->beta		= 0.0f ;
+	p->early	= 1 ;
+}
+
+int yaldpc_decoder_create( const yaldpc_code *code, const yaldpc_dec_params *p, yaldpc_decoder **dec ){
+	yaldpc_decoder *d ;
+
+	if( code == NULL || dec == NULL || ( p != NULL && p->nIter < 1 ) )
+		return YALDPC_EINVAL ;
+	*dec = NULL ;
+
+	if( ( d = ( yaldpc_decoder * )calloc( 1, sizeof( yaldpc_decoder ) ) ) == NULL )
+		return YALDPC_ENOMEM ;
+	d->code = code ;
+	if( p != NULL )
+		d->p = *p ;
+	else
+		yaldpc_dec_params_default( &d->p ) ;
+
+	d->zold	= ( float * )calloc( code->n, sizeof( float ) ) ;
+	d->zr	= ( float * )calloc( 2 * ( size_t )code->n, sizeof( float ) ) ;
+	d->lin	= ( float * )calloc( code->n, sizeof( float ) ) ;
+	d->zt	= ( float * )calloc( ( size_t )code->mb * code->n, sizeof( float ) ) ;
+	d->lm	= ( float * )calloc( 2 * ( size_t )code->m, sizeof( float ) ) ;
+	d->ls	= ( uint32_t * )calloc( code->m, sizeof( uint32_t ) ) ;
+	d->li	= ( uint8_t * )calloc( code->m, sizeof( uint8_t ) ) ;
+	d->hd	= ( uint8_t * )calloc( code->n, sizeof( uint8_t ) ) ;
+
+	if( d->zold == NULL || d->zr == NULL || d->lin == NULL || d->zt == NULL || d->lm == NULL || d->ls == NULL || d->li == NULL || d->hd == NULL ){
+		yaldpc_decoder_free( d ) ;
+		return YALDPC_ENOMEM ;
+	}
+
+	*dec = d ;
+	return YALDPC_OK ;
+}
+
+void yaldpc_decoder_free( yaldpc_decoder *dec ){
+	if( dec == NULL )
+		return ;
+	free( dec->zold ) ;
+	free( dec->zr ) ;
+	free( dec->lin ) ;
+	free( dec->zt ) ;
+	free( dec->lm ) ;
+	free( dec->ls ) ;
+	free( dec->li ) ;
+	free( dec->hd ) ;
+	free( dec ) ;
+}
+
+int yaldpc_decode( yaldpc_decoder *dec, const float *llr, float *apllr, int *iter, int frames ){
+	size_t n ;
+	int f, it, conv = 0 ;
+
+	if( dec == NULL || llr == NULL || apllr == NULL || frames < 0 )
+		return YALDPC_EINVAL ;
+	n = ( size_t )dec->code->n ;
+
+	for( f = 0 ; f < frames ; f++ ){
+		it = decodeFrame( dec, llr + f * n, apllr + f * n ) ;
+		conv += dec->converged ;
+		if( iter != NULL )
+			iter[ f ] = it ;
+	}
+	return conv ;
+}
+
+int yaldpc_decode_typed( yaldpc_decoder *dec, const void *llr, int intype, float scale, void *apllr, int outtype, int *iter, int frames ){
+	size_t n ;
+	int f, it, conv = 0 ;
+
+	if( dec == NULL || llr == NULL || apllr == NULL || frames < 0 || intype < YALDPC_FLOAT || intype > YALDPC_INT8
+		|| ( outtype != YALDPC_FLOAT && outtype != YALDPC_DOUBLE ) )
+		return YALDPC_EINVAL ;
+	n = ( size_t )dec->code->n ;
+
+	for( f = 0 ; f < frames ; f++ ){
+		YKern.loadLLR( dec->code, ( const char * )llr + f * n * LLRSize[ intype ], intype, scale, dec->lin, dec->zold ) ;
+		it = iterate( dec, dec->lin ) ;
+		YKern.storeLLR( dec->code, dec->zold, ( char * )apllr + f * n * LLRSize[ outtype ], outtype, dec->code->n ) ;
+		conv += dec->converged ;
+		if( iter != NULL )
+			iter[ f ] = it ;
+	}
+	return conv ;
+}
+
+int yaldpc_decode_bits( yaldpc_decoder *dec, const void *llr, int intype, float scale, uint8_t *bits, void *sysllr, int outtype, int *iter, int frames ){
+	size_t n, k ;
+	int f, it, conv = 0 ;
+
+	if( dec == NULL || llr == NULL || bits == NULL || frames < 0 || intype < YALDPC_FLOAT || intype > YALDPC_INT8
+		|| ( sysllr != NULL && outtype != YALDPC_FLOAT && outtype != YALDPC_DOUBLE ) )
+		return YALDPC_EINVAL ;
+	n = ( size_t )dec->code->n ;
+	k = ( size_t )dec->code->k ;
+
+	for( f = 0 ; f < frames ; f++ ){
+		YKern.loadLLR( dec->code, ( const char * )llr + f * n * LLRSize[ intype ], intype, scale, dec->lin, dec->zold ) ;
+		it = iterate( dec, dec->lin ) ;
+		YKern.packBits( dec->code, dec->zold, bits + f * ( ( k + 7 ) / 8 ), ( int )k ) ;
+		if( sysllr != NULL )
+			YKern.storeLLR( dec->code, dec->zold, ( char * )sysllr + f * k * LLRSize[ outtype ], outtype, ( int )k ) ;
+		conv += dec->converged ;
+		if( iter != NULL )
+			iter[ f ] = it ;
+	}
+	return conv ;
+}
+
+int yaldpc_stream_create( const yaldpc_code *code, const yaldpc_dec_params *p, int threads, int depth, yaldpc_stream **s ){
+	yaldpc_stream *st ;
+	int t, r ;
+
+	if( code == NULL || s == NULL || threads < 1 || depth < 1 )
+		return YALDPC_EINVAL ;
+	*s = NULL ;
+
+	if( ( st = ( yaldpc_stream * )calloc( 1, sizeof( yaldpc_stream ) ) ) == NULL )
+		return YALDPC_ENOMEM ;
+	st->depth	= depth ;
+	st->th		= ( pthread_t * )calloc( threads, sizeof( pthread_t ) ) ;
+	st->dec		= ( yaldpc_decoder ** )calloc( threads, sizeof( yaldpc_decoder * ) ) ;
+	st->q		= ( YSLOT * )calloc( depth, sizeof( YSLOT ) ) ;
+	if( st->th == NULL || st->dec == NULL || st->q == NULL ){
+		yaldpc_stream_free( st ) ;
+		return YALDPC_ENOMEM ;
+	}
+	for( t = 0 ; t < threads ; t++ ){
+		if( ( r = yaldpc_decoder_create( code, p, st->dec + t ) ) != YALDPC_OK ){
+			yaldpc_stream_free( st ) ;
+			return r ;
+		}
+		st->ndec++ ;
+	}
+
+	pthread_mutex_init( &st->mx, NULL ) ;
+	pthread_cond_init( &st->work, NULL ) ;
+	pthread_cond_init( &st->done, NULL ) ;
+	st->sync = 1 ;
+
+	for( t = 0 ; t < threads ; t++ ){
+		if( pthread_create( st->th + t, NULL, streamThread, st ) != 0 ){
+			yaldpc_stream_free( st ) ;
+			return YALDPC_ETHREAD ;
+		}
+		st->nth++ ;
+	}
+
+	*s = st ;
+	return YALDPC_OK ;
+}
+
+int yaldpc_stream_submit( yaldpc_stream *s, const float *llr, float *apllr, void *tag ){
+	YSLOT *q ;
+
+	if( s == NULL || llr == NULL || apllr == NULL )
+		return YALDPC_EINVAL ;
+
+	pthread_mutex_lock( &s->mx ) ;
+	while( s->tail - s->head >= s->depth )
+		pthread_cond_wait( &s->done, &s->mx ) ;
+
+	q			= s->q + s->tail % s->depth ;
+	q->llr		= llr ;
+	q->apllr	= apllr ;
+	q->tag		= tag ;
+	q->done		= 0 ;
+	s->tail++ ;
+
+	pthread_cond_signal( &s->work ) ;
+	pthread_mutex_unlock( &s->mx ) ;
+	return YALDPC_OK ;
+}
+
+int yaldpc_stream_wait( yaldpc_stream *s, void **tag, int *iter ){
+	YSLOT *q ;
+	int conv ;
+
+	if( s == NULL )
+		return YALDPC_EINVAL ;
+
+	pthread_mutex_lock( &s->mx ) ;
+	if( s->head == s->tail ){
+		pthread_mutex_unlock( &s->mx ) ;
+		return YALDPC_EINVAL ;
+	}
+
+	q = s->q + s->head % s->depth ;
+	while( !q->done )
+		pthread_cond_wait( &s->done, &s->mx ) ;
+
+	if( tag != NULL )
+		*tag = q->tag ;
+	if( iter != NULL )
+		*iter = q->iter ;
+	conv = q->conv ;
+	s->head++ ;
+
+	pthread_cond_broadcast( &s->done ) ;	//a slot for submit
+	pthread_mutex_unlock( &s->mx ) ;
+	return conv ;
+}
+
+void yaldpc_stream_free( yaldpc_stream *s ){
+	int t ;
+
+	if( s == NULL )
+		return ;
+
+	if( s->nth > 0 ){
+		pthread_mutex_lock( &s->mx ) ;
+		s->quit = 1 ;
+		pthread_cond_broadcast( &s->work ) ;
+		pthread_mutex_unlock( &s->mx ) ;
+
+		for( t = 0 ; t < s->nth ; t++ )
+			pthread_join( s->th[ t ], NULL ) ;
+	}
+	if( s->sync ){
+		pthread_mutex_destroy( &s->mx ) ;
+		pthread_cond_destroy( &s->work ) ;
+		pthread_cond_destroy( &s->done ) ;
+	}
+
+	for( t = 0 ; t < s->ndec ; t++ )
+		yaldpc_decoder_free( s->dec[ t ] ) ;
+	free( s->dec ) ;
+	free( s->th ) ;
+	free( s->q ) ;
+	free( s ) ;
+}
+
+//local functions definitions---------------------------------------------------
+
+/*
+ * code of the given size, hbm and tables go to one block c->mem
+ * */
+static YCODE *newCode( int mb, int nb, int z ){
+	YCODE *c ;
+	size_t len ;
+
+	if( ( c = ( YCODE * )calloc( 1, sizeof( YCODE ) ) ) == NULL )
+		return NULL ;
+
+	len = ( size_t )mb * sizeof( int ) + ( 2 * ( size_t )mb * nb + mb ) * sizeof( int16_t ) + ( size_t )mb * nb ;
+	if( ( c->mem = calloc( len, 1 ) ) == NULL ){
+		free( c ) ;
+		return NULL ;
+	}
+
+	c->mb			= mb ;
+	c->nb			= nb ;
+	c->kb			= nb - mb ;
+	c->z			= z ;
+	c->n			= nb * z ;
+	c->m			= mb * z ;
+	c->k			= c->n - c->m ;
+	c->encMethod	= -1 ;
+	return c ;
+}
+
+/*
+ * copy of hbm and its index tables: nonzero blocks of every layer in ascending
+ * column order, natural layer schedule
+ * */
+static int initTables( YCODE *c, const int8_t *hbm ){
+	const int mb = c->mb, nb = c->nb, z = c->z ;
+	int *deg = ( int * )c->mem ;
+	int16_t *col = ( int16_t * )( deg + mb ) ;
+	int16_t *shift = col + mb * nb ;
+	int16_t *order = shift + mb * nb ;
+	int8_t *h = ( int8_t * )( order + mb ) ;
+	int i, j, g ;
+
+	memcpy( h, hbm, ( size_t )mb * nb ) ;
+
+	for( c->gmax = 0, i = 0 ; i < mb ; i++ ){
+		for( g = 0, j = 0 ; j < nb ; j++ ){
+			if( h[ i * nb + j ] < -1 || h[ i * nb + j ] >= z )
+				return YALDPC_EINVAL ;
+			if( h[ i * nb + j ] < 0 )
+				continue ;
+			col[ i * nb + g ]	= ( int16_t )j ;
+			shift[ i * nb + g ]	= h[ i * nb + j ] ;
+			g++ ;
+		}
+		if( g > Y_GMAX )
+			return YALDPC_ENOTSUP ;
+		deg[ i ]	= g ;
+		order[ i ]	= ( int16_t )i ;
+		c->gmax		= g > c->gmax ? g : c->gmax ;
+	}
+
+	c->hbm		= h ;
+	c->deg		= deg ;
+	c->col		= col ;
+	c->shift	= shift ;
+	c->order	= order ;
+
+	pthread_once( &KernelOnce, YKernelInit ) ;
+	return YALDPC_OK ;
+}
+
+/*
+ * index tables of a code file are those of its hbm, the schedule is a permutation
+ * */
+static int checkTables( const YCODE *c ){
+	const int mb = c->mb, nb = c->nb ;
+	uint8_t *seen ;
+	int i, j, g, s, gmax = 0, r = 0 ;
+
+	if( ( seen = ( uint8_t * )calloc( mb, 1 ) ) == NULL )
+		return -1 ;
+
+	for( i = 0 ; r == 0 && i < mb ; i++ ){
+		if( c->deg[ i ] < 0 || c->deg[ i ] > Y_GMAX )
+			r = -1 ;
+		for( g = 0, j = 0 ; r == 0 && j < nb ; j++ ){
+			if( ( s = c->hbm[ i * nb + j ] ) < -1 || s >= c->z )
+				r = -1 ;
+			else if( s >= 0 && ( g >= c->deg[ i ] || c->col[ i * nb + g ] != j || c->shift[ i * nb + g++ ] != s ) )
+				r = -1 ;
+		}
+		if( g != c->deg[ i ] || c->order[ i ] < 0 || c->order[ i ] >= mb || seen[ c->order[ i ] ]++ )
+			r = -1 ;
+		gmax = c->deg[ i ] > gmax ? c->deg[ i ] : gmax ;
+	}
+
+	free( seen ) ;
+	return r == 0 && gmax == c->gmax ? 0 : -1 ;
+}
+
+/*
+ * shifts of an encoder plan of a code file are in range
+ * */
+static int checkPlan( const YCODE *c ){
+	const int mb = c->mb, z = c->z ;
+	int i, l ;
+
+	if( c->encMethod == Y_ANNEXG )
+		return checkAnnexG( c ) && c->encP0 >= 0 && c->encP0 < z ? 0 : -1 ;
+
+	for( i = 0 ; i < mb * mb ; i++ ){
+		if( c->piS[ i ] < 0 || c->piS[ i ] > z )
+			return -1 ;
+		for( l = 0 ; l < c->piS[ i ] ; l++ ){
+			if( c->piSh[ i * z + l ] < 0 || c->piSh[ i * z + l ] >= z )
+				return -1 ;
+		}
+	}
+	return 0 ;
+}
+
+/*
+ * offsets of the sections of a code file, returns its length
+ * */
+static size_t fileLayout( int flags, int mb, int nb, int z, int generic, size_t *off ){
+	size_t i = Y_FILE_HEAD ;
+
+	memset( off, 0, F_COUNT * sizeof( size_t ) ) ;
+
+	off[ F_HBM ] = i ;
+	i = Y_ALIGN8( i + ( size_t )mb * nb ) ;
+
+	if( flags & YALDPC_FILE_TABLES ){
+		off[ F_DEG ] = i ;
+		i = Y_ALIGN8( i + 4 * ( size_t )mb ) ;
+		off[ F_COL ] = i ;
+		i = Y_ALIGN8( i + 2 * ( size_t )mb * nb ) ;
+		off[ F_SHIFT ] = i ;
+		i = Y_ALIGN8( i + 2 * ( size_t )mb * nb ) ;
+		off[ F_ORDER ] = i ;
+		i = Y_ALIGN8( i + 2 * ( size_t )mb ) ;
+	}
+
+	if( ( flags & YALDPC_FILE_PLAN ) && generic ){
+		off[ F_PIS ] = i ;
+		i = Y_ALIGN8( i + 2 * ( size_t )mb * mb ) ;
+		off[ F_PISH ] = i ;
+		i = Y_ALIGN8( i + 2 * ( size_t )mb * mb * z ) ;
+	}
+
+	off[ F_SUM ] = i ;
+	return i + 4 ;
+}
+
+static int littleEndian( void ){
+	const uint16_t one = 1 ;
+
+	return *( const uint8_t * )&one ;
+}
+
+/*
+ * tables and plan of a code file are used in place on little endian hosts,
+ * YALDPC_INPLACE=0 makes them from hbm there too, to test the big endian path
+ * */
+static int inPlace( void ){
+	const char *e = getenv( "YALDPC_INPLACE" ) ;
+
+	return littleEndian() && !( e != NULL && strcmp( e, "0" ) == 0 ) ;
+}
+
+static void putU32( uint8_t *b, size_t i, uint32_t v ){
+	b[ i ]		= ( uint8_t )v ;
+	b[ i + 1 ]	= ( uint8_t )( v >> 8 ) ;
+	b[ i + 2 ]	= ( uint8_t )( v >> 16 ) ;
+	b[ i + 3 ]	= ( uint8_t )( v >> 24 ) ;
+}
+
+static void putU16( uint8_t *b, size_t i, uint16_t v ){
+	b[ i ]		= ( uint8_t )v ;
+	b[ i + 1 ]	= ( uint8_t )( v >> 8 ) ;
+}
+
+static uint32_t getU32( const uint8_t *b, size_t i ){
+	return ( uint32_t )b[ i ] | ( uint32_t )b[ i + 1 ] << 8 | ( uint32_t )b[ i + 2 ] << 16 | ( uint32_t )b[ i + 3 ] << 24 ;
+}
+
+static uint32_t fnv1a( const uint8_t *b, size_t len ){
+	uint32_t h = 2166136261U ;
+	size_t i ;
+
+	for( i = 0 ; i < len ; i++ ){
+		h = ( h ^ b[ i ] ) * 16777619U ;
+	}
+	return h ;
+}
+
+/*
+ * dst[ k ] = src[ ( k + s ) % z ], the rotation of vROR() in encoder.c
+ * */
+static void rot( uint8_t *dst, const uint8_t *src, int s, int z ){
+	memcpy( dst, src + s, z - s ) ;
+	memcpy( dst + z - s, src, s ) ;
+}
+
+static void vxor( uint8_t *dst, const uint8_t *v, int z ){
+	int i ;
+
+	for( i = 0 ; i < z ; i++ )
+		dst[ i ] ^= v[ i ] ;
+}
+
+/*
+ * the parity part has the structure assumed by Annex G, see checkAnnexG() in encoder.c
+ * */
+static int checkAnnexG( const YCODE *c ){
+	const int8_t *h = c->hbm ;
+	int i, j, np, kb = c->kb, nb = c->nb, mb = c->mb ;
+
+	if( mb < 2 || h[ kb ] < 0 || h[ kb ] != h[ ( mb - 1 ) * nb + kb ] )
+		return 0 ;
+
+	for( np = 0, i = 1 ; i < mb - 1 ; i++ ){
+		np += h[ i * nb + kb ] > -1 ;
+	}
+	if( np != 1 )
+		return 0 ;
+
+	for( i = 0 ; i < mb ; i++ ){
+		for( j = 1 ; j < mb ; j++ ){
+			if( h[ i * nb + kb + j ] != ( i == j - 1 || i == j ? 0 : -1 ) )
+				return 0 ;
+		}
+	}
+	return 1 ;
+}
+
+/*
+ * Gauss-Jordan inversion of the binary parity part, see initGenericPlan() in encoder.c
+ * */
+static int initGenericPlan( yaldpc_encoder *e ){
+	const YCODE *cd = e->code ;
+	const int M = cd->m, Z = cd->z, MB = cd->mb ;
+	const int w = ( M + 63 ) / 64 ;
+	uint64_t *A, *r, *p, tmp ;
+	int16_t *piS, *piSh ;
+	int i, j, l, c, s, col, row, piv ;
+
+	e->mem	= ( int16_t * )calloc( ( size_t )MB * MB * ( Z + 1 ), sizeof( int16_t ) ) ;
+	A		= ( uint64_t * )calloc( ( size_t )M * 2 * w, sizeof( uint64_t ) ) ;
+	if( e->mem == NULL || A == NULL ){
+		free( A ) ;
+		return YALDPC_ENOMEM ;
+	}
+	piS		= e->mem ;
+	piSh	= e->mem + MB * MB ;
+	e->piS	= piS ;
+	e->piSh	= piSh ;
+
+	for( i = 0 ; i < MB ; i++ ){
+		for( j = 0 ; j < MB ; j++ ){
+			if( ( s = cd->hbm[ i * cd->nb + cd->kb + j ] ) == -1 )
+				continue ;
+			for( l = 0 ; l < Z ; l++ ){
+				row = i * Z + l ;
+				col = j * Z + ( l + s ) % Z ;
+				A[ ( size_t )row * 2 * w + col / 64 ] ^= 1ULL << ( col % 64 ) ;
+			}
+		}
+	}
+	for( row = 0 ; row < M ; row++ ){
+		col = w * 64 + row ;
+		A[ ( size_t )row * 2 * w + col / 64 ] |= 1ULL << ( col % 64 ) ;
+	}
+
+	for( col = 0 ; col < M ; col++ ){
+		for( piv = col ; piv < M ; piv++ ){
+			if( ( A[ ( size_t )piv * 2 * w + col / 64 ] >> ( col % 64 ) ) & 1ULL )
+				break ;
+		}
+		if( piv == M ){
+			free( A ) ;
+			return YALDPC_ENOTSUP ;		//singular parity part
+		}
+
+		p = A + ( size_t )piv * 2 * w ;
+		if( piv != col ){
+			r = A + ( size_t )col * 2 * w ;
+			for( c = 0 ; c < 2 * w ; c++ ){
+				tmp = r[ c ] ; r[ c ] = p[ c ] ; p[ c ] = tmp ;
+			}
+			p = r ;
+		}
+
+		for( row = 0 ; row < M ; row++ ){
+			r = A + ( size_t )row * 2 * w ;
+			if( row != col && ( ( r[ col / 64 ] >> ( col % 64 ) ) & 1ULL ) ){
+				for( c = col / 64 ; c < 2 * w ; c++ ){
+					r[ c ] ^= p[ c ] ;
+				}
+			}
+		}
+	}
+
+	for( i = 0 ; i < MB ; i++ ){
+		r = A + ( size_t )i * Z * 2 * w ;
+		for( j = 0 ; j < MB ; j++ ){
+			for( l = 0 ; l < Z ; l++ ){
+				col = w * 64 + j * Z + l ;
+				if( ( r[ col / 64 ] >> ( col % 64 ) ) & 1ULL ){
+					piSh[ ( i * MB + j ) * Z + piS[ i * MB + j ]++ ] = ( int16_t )l ;
+				}
+			}
+		}
+	}
+
+	free( A ) ;
+	return YALDPC_OK ;
+}
+
+/*
+ * parity bits out of data bits in, scratch si: mb blocks, t: one block
+ * */
+static void encodeFrame( const yaldpc_encoder *e, const uint8_t *in, uint8_t *out, uint8_t *si, uint8_t *t ){
+	const YCODE *c = e->code ;
+	const int z = c->z, mb = c->mb, nb = c->nb, kb = c->kb ;
+	int i, j, l, s ;
+
+	//si = Hs * u
+	memset( si, 0, ( size_t )mb * z ) ;
+	for( i = 0 ; i < mb ; i++ ){
+		for( j = 0 ; j < kb ; j++ ){
+			if( ( s = c->hbm[ i * nb + j ] ) != -1 ){
+				rot( t, in + j * z, s, z ) ;
+				vxor( si + i * z, t, z ) ;
+			}
+		}
+	}
+
+	if( e->method == Y_GENERIC ){
+		memset( out, 0, ( size_t )mb * z ) ;
+		for( i = 0 ; i < mb ; i++ ){
+			for( j = 0 ; j < mb ; j++ ){
+				for( l = 0 ; l < e->piS[ i * mb + j ] ; l++ ){
+					rot( t, si + j * z, e->piSh[ ( i * mb + j ) * z + l ], z ) ;
+					vxor( out + i * z, t, z ) ;
+				}
+			}
+		}
+		return ;
+	}
+
+	//Annex G: eq. G.1, v( 0 ) by inverse rotation of the sum of all tiers
+	memset( t, 0, z ) ;
+	for( i = 0 ; i < mb ; i++ )
+		vxor( t, si + i * z, z ) ;
+	rot( out, t, e->p0, z ) ;
+
+	//eq. G.2
+	memcpy( out + z, si, z ) ;
+	if( ( s = c->hbm[ kb ] ) != -1 ){
+		rot( t, out, s, z ) ;
+		vxor( out + z, t, z ) ;
+	}
+
+	//eq. G.3
+	for( i = 1 ; i < mb - 1 ; i++ ){
+		memcpy( out + ( i + 1 ) * z, out + i * z, z ) ;
+		vxor( out + ( i + 1 ) * z, si + i * z, z ) ;
+		if( ( s = c->hbm[ i * nb + kb ] ) != -1 ){
+			rot( t, out, s, z ) ;
+			vxor( out + ( i + 1 ) * z, t, z ) ;
+		}
+	}
+}
+
+/*
+ * layered min-sum of one frame, MSDecode() of decoder.c
+ * returns the nr. of iterations, sets d->converged
+ * */
+static int decodeFrame( yaldpc_decoder *d, const float *llch, float *apllr ){
+	const size_t n = ( size_t )d->code->n * sizeof( float ) ;
+	int iter ;
+
+	memcpy( d->zold, llch, n ) ;
+	iter = iterate( d, llch ) ;
+	memcpy( apllr, d->zold, n ) ;
+	return iter ;
+}
+
+/*
+ * the iterations of decodeFrame(), d->zold already holds llch, the posteriors end there,
+ * the layers read them from their copy in the rotation layout d->zr
+ * */
+static int iterate( yaldpc_decoder *d, const float *llch ){
+	const YCODE *c = d->code ;
+	const size_t n = ( size_t )c->n * sizeof( float ) ;
+	const int z = c->z ;
+	float *zold = d->zold ;
+	int iter, l, mb ;
+
+	memset( d->lm, 0, 2 * ( size_t )c->m * sizeof( float ) ) ;
+	memset( d->ls, 0, ( size_t )c->m * sizeof( uint32_t ) ) ;
+	memset( d->li, 0, ( size_t )c->m ) ;
+	memset( d->zt, 0, ( size_t )c->mb * n ) ;
+	d->converged = 0 ;
+	YKern.rotateLayout( c, zold, d->zr ) ;
+
+	for( iter = 0 ; iter < d->p.nIter ; iter++ ){
+
+		for( l = 0 ; l < c->mb ; l++ ){
+			mb = c->order[ l ] ;
+			memcpy( zold, llch, n ) ;
+			memset( d->zt + ( size_t )mb * c->n, 0, n ) ;
+
+			YKern.layerMinSum( c, mb, iter, d->zr, d->zt + ( size_t )mb * c->n, d->lm + mb * z, d->lm + c->m + mb * z,
+				d->ls + mb * z, d->li + mb * z, d->p.lambda, d->p.beta ) ;
+
+			YKern.sumTiers( c, zold, d->zt ) ;	//tiers from previous iteration are also used
+
+			YKern.rotateLayout( c, zold, d->zr ) ;
+		}
+
+		YKern.hardDecision( c, zold, d->hd ) ;
+
+		d->converged = YKern.orthogonal( c, d->hd ) ;
+		if( d->converged && d->p.early )
+			return iter + 1 ;
+	}
+
+	return iter ;
+}
+
+static void *streamThread( void *arg ){
+	yaldpc_stream *s = ( yaldpc_stream * )arg ;
+	yaldpc_decoder *d ;
+	YSLOT *q ;
+	int it ;
+
+	pthread_mutex_lock( &s->mx ) ;
+	d = s->dec[ s->started++ ] ;
+
+	for( ;; ){
+		while( !s->quit && s->next == s->tail )
+			pthread_cond_wait( &s->work, &s->mx ) ;
+		if( s->next == s->tail )
+			break ;		//quit, nothing left
+
+		q = s->q + s->next % s->depth ;
+		s->next++ ;
+		pthread_mutex_unlock( &s->mx ) ;
+
+		it = decodeFrame( d, q->llr, q->apllr ) ;
+
+		pthread_mutex_lock( &s->mx ) ;
+		q->iter	= it ;
+		q->conv	= d->converged ;
+		q->done	= 1 ;
+		pthread_cond_broadcast( &s->done ) ;
+	}
+
+	pthread_mutex_unlock( &s->mx ) ;
+	return NULL ;
+}
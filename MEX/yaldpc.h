@@ -0,0 +1,232 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	libyaldpc: QC-LDPC encoder and layered min-sum decoder as a C library.
+
+	Unlike the MEX and CLI builds, nothing is compiled in: a code handle is
+	made at run time from any scaled base matrix or from the built-in
+	IEEE 802.11 and 802.16 tables, encoders and decoders are made from it.
+	The library does not need MATLAB, ldpc.h or ldpc.c, it uses the same
+	kernels ( kernel.inc ) and gives the same results as the float decoder.
+
+	Bits are unpacked, one bit per uint8_t ( 0 or 1 ), LLRs are float,
+	positive for bit 0. Blocks of frames are stored column-wise, frame after
+	frame ( N values each ), as in MATLAB.
+
+	Threads: code handles and encoders are read-only after creation and
+	can be shared, a decoder belongs to one thread at a time, a stream
+	decodes on its own threads.
+
+	Build, see README.md:
+	cc -O3 -DNDEBUG -fPIC -fvisibility=hidden -pthread -shared -o libyaldpc.so yaldpc.c ykernel.c ystd.c
+*/
+
+#ifndef YALDPC_H
+#define YALDPC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//same major version > same API and ABI, minor adds functions
+#define YALDPC_VERSION_MAJOR	1
+#define YALDPC_VERSION_MINOR	5
+#define YALDPC_VERSION_PATCH	0
+#define YALDPC_VERSION			( ( YALDPC_VERSION_MAJOR << 16 ) | ( YALDPC_VERSION_MINOR << 8 ) | YALDPC_VERSION_PATCH )
+
+#if defined( __GNUC__ ) && defined( YALDPC_BUILD )
+	#define YALDPC_API __attribute__(( visibility( "default" ) ))
+#else
+	#define YALDPC_API
+#endif
+
+//return codes
+#define YALDPC_OK			0
+#define YALDPC_EINVAL		-1		// invalid argument
+#define YALDPC_ENOMEM		-2		// out of memory
+#define YALDPC_ENOCODE		-3		// no such standard code
+#define YALDPC_ENOTSUP		-4		// code not supported, e.g. singular parity part for the encoder
+#define YALDPC_ETHREAD		-5		// cannot start a thread
+#define YALDPC_EIO			-6		// cannot read or write a file
+#define YALDPC_EFORMAT		-7		// not a code file, wrong version, checksum or inconsistent tables
+
+//standards for yaldpc_code_standard() and yaldpc_code_get()
+#define YALDPC_WIFI			1		// IEEE 802.11-2020 Annex F: N = 648, 1296, 1944, R = 1/2, 2/3, 3/4, 5/6
+#define YALDPC_WIMAX		2		// IEEE 802.16-2009: N = 576 .. 2304 step 96, R = 1/2, 2/3 A/B, 3/4 A/B, 5/6
+
+typedef struct yaldpc_code		yaldpc_code ;
+typedef struct yaldpc_encoder	yaldpc_encoder ;
+typedef struct yaldpc_decoder	yaldpc_decoder ;
+typedef struct yaldpc_stream	yaldpc_stream ;
+
+typedef struct yaldpc_code_info {
+	int n, k, m ;		// codeword, data and parity bits
+	int z ;				// block size
+	int mb, nb ;		// base matrix rows and columns
+	int gmax ;			// max. check node degree
+} yaldpc_code_info ;
+
+typedef struct yaldpc_dec_params {
+	int		nIter ;		// max. nr. of iterations, default 10
+	float	lambda ;	// min-sum normalization, default 1.0
+	float	beta ;		// min-sum offset, default 0.0
+	int		early ;		// 1 > stop when converged ( default ), 0 > all nIter iterations
+} yaldpc_dec_params ;
+
+//	run-time version, YALDPC_VERSION of the library binary
+YALDPC_API unsigned yaldpc_version( void ) ;
+
+YALDPC_API const char *yaldpc_strerror( int err ) ;
+
+//	instruction set of the kernels in use, see kernel.h for YALDPC_ISA
+YALDPC_API const char *yaldpc_isa( void ) ;
+
+/*
+	code handles
+
+	yaldpc_code_create: hbm is mb x nb row-major, shifts already scaled to z ( 0 .. z - 1 ),
+	-1 for a zero block, mb < nb, z <= 128 ( int8_t shifts ), at most 32 nonzero blocks per row
+	yaldpc_code_standard: rnum / rden is the rate, variant 'A' or 'B' selects the 802.16
+	2/3 and 3/4 codes, 0 > 'A'
+
+	yaldpc_code_get: the same standard code from the built-in registry, made on first use,
+	then shared by all callers until the process exits, never free it, natural layer schedule
+
+	encoders, decoders and streams keep a pointer to the code, free it after them
+*/
+YALDPC_API int yaldpc_code_create( int mb, int nb, int z, const int8_t *hbm, yaldpc_code **code ) ;
+YALDPC_API int yaldpc_code_standard( int std, int rnum, int rden, int n, char variant, yaldpc_code **code ) ;
+YALDPC_API int yaldpc_code_get( int std, int rnum, int rden, int n, char variant, const yaldpc_code **code ) ;
+YALDPC_API void yaldpc_code_free( yaldpc_code *code ) ;
+YALDPC_API void yaldpc_code_get_info( const yaldpc_code *code, yaldpc_code_info *info ) ;
+
+/*
+	code files: hbm and z of any code in a compact binary file, lib/saveCodeFile.m writes them
+	from MATLAB, optionally with the derived tables, so loading a code rebuilds nothing
+
+	yaldpc_code_save: flags YALDPC_FILE_TABLES adds the index tables and layer schedule of
+	the decoder, YALDPC_FILE_PLAN the encoder plan ( the inverse of the parity part )
+	yaldpc_code_load: the file is memory-mapped and checksum-validated, embedded tables
+	are used in place on little endian hosts, otherwise made from hbm ( also with the
+	environment variable YALDPC_INPLACE=0, for testing )
+*/
+#define YALDPC_FILE_TABLES	1
+#define YALDPC_FILE_PLAN	2
+
+YALDPC_API int yaldpc_code_save( const yaldpc_code *code, const char *file, int flags ) ;
+YALDPC_API int yaldpc_code_load( const char *file, yaldpc_code **code ) ;
+
+/*
+	layer schedule of the decoder, set it before decoders of the code are created
+	codes of yaldpc_code_get() are shared and always decode in natural order, the call
+	fails with YALDPC_EINVAL for them: make an own copy with yaldpc_code_standard() first
+	YALDPC_SCHED_NATURAL: layers 0 .. mb - 1, the default of a code made from hbm
+	YALDPC_SCHED_OVERLAP: the cyclic order in which consecutive layers share the fewest
+	columns ( read-after-write dependencies ), natural if that is as good, see MEX/schedule.inc
+	yaldpc_code_save( YALDPC_FILE_TABLES ) stores it, yaldpc_code_load() restores it
+*/
+#define YALDPC_SCHED_NATURAL	0
+#define YALDPC_SCHED_OVERLAP	1
+
+YALDPC_API int yaldpc_code_schedule( yaldpc_code *code, int sched ) ;
+
+/*
+	encoder plan: 802.11 / 802.16 Annex G for a dual-diagonal parity part,
+	otherwise the block-circulant inverse of the parity part
+
+	yaldpc_encode: data K x frames, cw N x frames, systematic bits first
+*/
+YALDPC_API int yaldpc_encoder_create( const yaldpc_code *code, yaldpc_encoder **enc ) ;
+YALDPC_API void yaldpc_encoder_free( yaldpc_encoder *enc ) ;
+YALDPC_API int yaldpc_encode( const yaldpc_encoder *enc, const uint8_t *data, uint8_t *cw, int frames ) ;
+
+/*
+	decoder instance: message memory of one frame
+
+	yaldpc_decode: llr and apllr N x frames, iter ( NULL > not needed ) gets the iterations
+	of every frame, returns the nr. of frames that converged to a codeword, or an error
+*/
+YALDPC_API void yaldpc_dec_params_default( yaldpc_dec_params *p ) ;
+YALDPC_API int yaldpc_decoder_create( const yaldpc_code *code, const yaldpc_dec_params *p, yaldpc_decoder **dec ) ;
+YALDPC_API void yaldpc_decoder_free( yaldpc_decoder *dec ) ;
+YALDPC_API int yaldpc_decode( yaldpc_decoder *dec, const float *llr, float *apllr, int *iter, int frames ) ;
+
+/*
+	yaldpc_decode_typed: yaldpc_decode() of LLRs of another type, each frame is converted while
+	it is loaded for the first iteration, no converted copy of the block is made
+	intype: YALDPC_FLOAT, YALDPC_DOUBLE, YALDPC_INT16 or YALDPC_INT8, integer LLRs are multiplied
+	by scale ( the LLR of one quantization step ), floats are used as they are
+	outtype: YALDPC_FLOAT or YALDPC_DOUBLE
+*/
+#define YALDPC_FLOAT		0
+#define YALDPC_DOUBLE		1
+#define YALDPC_INT16		2
+#define YALDPC_INT8			3
+
+YALDPC_API int yaldpc_decode_typed( yaldpc_decoder *dec, const void *llr, int intype, float scale, void *apllr, int outtype, int *iter, int frames ) ;
+
+/*
+	yaldpc_decode_bits: yaldpc_decode_typed() for the data only, the K systematic hard decisions
+	of every frame packed MSB first to bits, ( K + 7 ) / 8 bytes per frame, no N posteriors are
+	copied; sysllr ( NULL > not needed ) gets the K systematic posteriors as outtype
+*/
+YALDPC_API int yaldpc_decode_bits( yaldpc_decoder *dec, const void *llr, int intype, float scale, uint8_t *bits, void *sysllr, int outtype, int *iter, int frames ) ;
+
+/*
+	stream: frames are decoded by a pool of threads as they are submitted,
+	results come back in submission order
+
+	yaldpc_stream_submit: queues one frame, blocks while depth frames are in flight,
+	llr and apllr ( N values ) must stay valid until the frame is returned by wait
+	yaldpc_stream_wait: waits for the oldest frame, returns 1 if it converged, 0 if not,
+	YALDPC_EINVAL if no frame is in flight, tag and iter may be NULL
+	yaldpc_stream_free: finishes the frames in flight first
+*/
+YALDPC_API int yaldpc_stream_create( const yaldpc_code *code, const yaldpc_dec_params *p, int threads, int depth, yaldpc_stream **s ) ;
+YALDPC_API int yaldpc_stream_submit( yaldpc_stream *s, const float *llr, float *apllr, void *tag ) ;
+YALDPC_API int yaldpc_stream_wait( yaldpc_stream *s, void **tag, int *iter ) ;
+YALDPC_API void yaldpc_stream_free( yaldpc_stream *s ) ;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	libyaldpc internals, shared by yaldpc.c, ykernel.c and ystd.c, not installed.
+*/
+
+#ifndef YALDPCINT
+#define YALDPCINT
+
+#define Y_GMAX		32		// max. nonzero blocks per row: sign bitmaps are uint32_t
+
+struct yaldpc_code {
+	int		n, k, m, z ;
+	int		mb, nb, kb ;
+	int		gmax ;
+	const int8_t	*hbm ;		// mb x nb, scaled shifts, -1 > zero block
+
+	//index tables, see kernel.inc
+	const int		*deg ;		// nonzero blocks of every layer
+	const int16_t	*col ;		// mb x nb, their columns in ascending order
+	const int16_t	*shift ;	// mb x nb, their shifts
+	const int16_t	*order ;	// layer schedule of the decoder, see schedule.inc
+
+	//encoder plan of a code file, see yaldpc_encoder in yaldpc.c
+	int				encMethod ;	// -1 > none, the encoder makes its own
+	int				encP0 ;
+	const int16_t	*piS ;
+	const int16_t	*piSh ;
+
+	void	*mem ;				// hbm and tables made by yaldpc_code_create(), or the schedule of mapped tables
+	void	*map ;				// or mapped from a code file
+	size_t	mapLen ;
+} ;
+
+typedef struct yaldpc_code YCODE ;
+
+//kernels of kernel.inc for a run-time code, see KERNELS in kernel.h
+typedef struct ykernels {
+	int isa ;
+	void ( *layerMinSum )( const YCODE *kc, int mb, int iter, const float *zold, float *zt, float *lm0, float *lm1, uint32_t *ls, uint8_t *li, float lambda, float beta ) ;
+	void ( *rotateLayout )( const YCODE *kc, const float *z, float *zr ) ;
+	void ( *sumTiers )( const YCODE *kc, float *znew, const float *zt ) ;
+	void ( *hardDecision )( const YCODE *kc, const float *z, uint8_t *hd ) ;
+	int ( *orthogonal )( const YCODE *kc, const uint8_t *hd ) ;
+	void ( *loadLLR )( const YCODE *kc, const void *in, int type, float scale, float *llr, float *z ) ;
+	void ( *storeLLR )( const YCODE *kc, const float *z, void *out, int type, int n ) ;
+	void ( *packBits )( const YCODE *kc, const float *z, uint8_t *bits, int n ) ;
+	void ( *packBytes )( const YCODE *kc, const uint8_t *v, uint8_t *bits, int n ) ;
+	void ( *unpackBits )( const YCODE *kc, const uint8_t *bits, uint8_t *v, int n ) ;
+	uint64_t ( *bitErrors )( const YCODE *kc, const uint8_t *a, const uint8_t *b, int nb ) ;
+} YKERNELS ;
+
+//	kernels in use, scalar until YKernelInit()
+extern YKERNELS YKern ;
+
+extern void YKernelInit( void ) ;
+extern const char *YKernelISA( void ) ;
+
+/*
+	base matrix of a standard code, shifts scaled to z = n / 24 by the compiler,
+	id is its slot in the registry, returns YALDPC_OK or YALDPC_ENOCODE
+*/
+#define Y_NSTD		( 12 + 19 * 8 )		// registry slots: 3 x 4 Wi-Fi, 19 x 4 x 2 WiMAX
+
+extern int YStdCode( int std, int rnum, int rden, int n, char variant, const int8_t **hbm, int *mb, int *z, int *id ) ;
+
+#endif
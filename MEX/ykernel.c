@@ -0,0 +1,204 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Kernels of libyaldpc: kernel.inc for a code handle instead of ldpc.h,
+	float messages, unpacked bits, selected like kernel.c selects its own.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+
+#include "yaldpc.h"
+#include "yaldpc_int.h"
+
+typedef float FP ;
+typedef uint8_t WORD ;
+#define FP_MAX FLT_MAX
+
+#define K_SIGN( x ) ( ( x ) < 0 ? 1U : 0U )
+#define K_MAG( x )  ( ( x ) >= 0 ? ( x ) : -( x ) )
+#define K_MAX( x, y ) ( ( x ) > ( y ) ? ( x ) : ( y ) )
+#if defined( __GNUC__ )
+	#define K_POPCOUNT64( x ) ( ( uint64_t )__builtin_popcountll( x ) )
+#else
+	//SWAR bit count for compilers without __builtin_popcountll
+	static uint64_t popcount64( uint64_t x ){
+		x = x - ( ( x >> 1 ) & 0x5555555555555555ULL ) ;
+		x = ( x & 0x3333333333333333ULL ) + ( ( x >> 2 ) & 0x3333333333333333ULL ) ;
+		x = ( x + ( x >> 4 ) ) & 0x0F0F0F0F0F0F0F0FULL ;
+		return ( x * 0x0101010101010101ULL ) >> 56 ;
+	}
+	#define K_POPCOUNT64( x ) popcount64( x )
+#endif
+
+//the code handle kc, see kernel.inc
+#define KZ ( kc->z )
+#define KN ( kc->n )
+#define KMB ( kc->mb )
+#define KDEG( mb ) ( kc->deg[ mb ] )
+#define KCOL( mb, i ) ( kc->col[ ( mb ) * kc->nb + ( i ) ] )
+#define KSHIFT( mb, i ) ( kc->shift[ ( mb ) * kc->nb + ( i ) ] )
+#define KPARAM const YCODE *kc,
+
+//LLR types of loadLLR and storeLLR are those of yaldpc_decode_typed()
+#define LLR_SINGLE	YALDPC_FLOAT
+#define LLR_DOUBLE	YALDPC_DOUBLE
+#define LLR_INT16	YALDPC_INT16
+#define LLR_INT8	YALDPC_INT8
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+	#define KERNEL_X86
+#endif
+
+enum { Y_SCALAR = 0, Y_SSE42, Y_AVX2, Y_AVX512, Y_ISAS } ;
+
+#define KFN( f ) f##_scalar
+#if defined( KERNEL_X86 ) && !defined( __clang__ )
+	#define KATTR __attribute__(( optimize( "no-tree-vectorize" ) ))
+#else
+	#define KATTR
+#endif
+#include "kernel.inc"
+#undef KFN
+#undef KATTR
+
+/*
+ * SIMD variants: the loops vectorize at -O2 too ( the MEX -O build ), where GCC
+ * otherwise only vectorizes the cheapest of them; clang does at -O2 anyway
+ * */
+#if defined( KERNEL_X86 ) && !defined( __clang__ )
+	#define KSIMD( isa ) __attribute__(( target( isa ), optimize( "tree-vectorize" ) ))
+#elif defined( KERNEL_X86 )
+	#define KSIMD( isa ) __attribute__(( target( isa ) ))
+#endif
+
+#ifdef KERNEL_X86
+	#define KFN( f ) f##_sse42
+	#define KATTR KSIMD( "sse4.2,popcnt" )
+	#include "kernel.inc"
+	#undef KFN
+	#undef KATTR
+
+	#define KFN( f ) f##_avx2
+	#define KATTR KSIMD( "avx2,popcnt" )
+	#include "kernel.inc"
+	#undef KFN
+	#undef KATTR
+
+	#define KFN( f ) f##_avx512
+	#define KATTR KSIMD( "avx512f,avx512bw,avx512vl,popcnt" )
+	#include "kernel.inc"
+	#undef KFN
+	#undef KATTR
+#endif
+
+#define KERNEL_SET( isa, sfx ) { isa, layerMinSum##sfx, rotateLayout##sfx, sumTiers##sfx, hardDecision##sfx, orthogonal##sfx, loadLLR##sfx, storeLLR##sfx, packBits##sfx, packBytes##sfx, unpackBits##sfx, bitErrors##sfx }
+
+static const YKERNELS Variants[ Y_ISAS ] = {
+	KERNEL_SET( Y_SCALAR, _scalar ),
+	#ifdef KERNEL_X86
+		KERNEL_SET( Y_SSE42, _sse42 ),
+		KERNEL_SET( Y_AVX2, _avx2 ),
+		KERNEL_SET( Y_AVX512, _avx512 )
+	#endif
+} ;
+
+static const char *ISAName[ Y_ISAS ] = { "scalar", "sse4.2", "avx2", "avx512" } ;
+
+YKERNELS YKern = KERNEL_SET( Y_SCALAR, _scalar ) ;
+
+static int cpuISA( void ) ;
+static int envISA( void ) ;
+
+
+//global functions definitions-------------------------------------------------
+
+void YKernelInit( void ){
+	int isa, env ;
+
+	isa = cpuISA() ;
+	env = envISA() ;
+	if( env >= 0 && env < isa )
+		isa = env ;
+
+	YKern = Variants[ isa ] ;
+}
+
+const char *YKernelISA( void ){
+	return ISAName[ YKern.isa ] ;
+}
+
+//local functions definitions---------------------------------------------------
+
+static int cpuISA( void ){
+	#ifdef KERNEL_X86
+		__builtin_cpu_init() ;
+
+		if( !__builtin_cpu_supports( "popcnt" ) )
+			return Y_SCALAR ;
+		if( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ) && __builtin_cpu_supports( "avx512vl" ) )
+			return Y_AVX512 ;
+		if( __builtin_cpu_supports( "avx2" ) )
+			return Y_AVX2 ;
+		if( __builtin_cpu_supports( "sse4.2" ) )
+			return Y_SSE42 ;
+	#endif
+	return Y_SCALAR ;
+}
+
+/*
+ * YALDPC_ISA as in kernel.c, -1 if not set or unknown
+ * */
+static int envISA( void ){
+	const char *e = getenv( "YALDPC_ISA" ) ;
+	int i ;
+
+	if( e == NULL )
+		return -1 ;
+
+	if( strcmp( e, "sse42" ) == 0 )
+		return Y_SSE42 ;
+	for( i = 0 ; i < Y_ISAS ; i++ ){
+		if( strcmp( e, ISAName[ i ] ) == 0 )
+			return i ;
+	}
+	return -1 ;
+}
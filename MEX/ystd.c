@@ -0,0 +1,342 @@
+/* ==========================================================================
+QC LDPC decoder
+
+Copyrigth (C) 2022 Tomas Palenik, All rights reserved.
+
+This file is part of YALDPC MATLAB/C99 MEX Toolkit.
+	
+SRC code and documentation: https://github.com/talenik/YALDPC
+
+Released under the BSD 3-Clause License:
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================== */
+
+/*
+	Base matrices of the standard QC-LDPC codes, as in lib/IEEE80211_2020_LDPC.m
+	and lib/IEEE80216_LDPC.m :
+		IEEE Std 802.11-2020 Annex F, Tables F-1 .. F-3, one matrix per N and R, Z = N / 24
+		IEEE Std 802.16-2009, one matrix per R ( and variant ) for Z0 = 96,
+		shifts are scaled to Z = N / 24 like rescaleHbm() in lib/loadWIMAX_LDPC.m
+
+	The WiMAX matrices are X-macros of their Z0 shifts: the compiler scales
+	them for all 19 lengths into constant tables, nothing is computed at
+	run-time.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "yaldpc.h"
+#include "yaldpc_int.h"
+
+//802.11 N = 648, R = 1/2, Z = 27
+static const int8_t WiFi_R12_N648[ 12 ][ 24 ] = {
+	{   0,  -1,  -1,  -1,   0,   0,  -1,  -1,   0,  -1,  -1,   0,   1,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  22,   0,  -1,  -1,  17,  -1,   0,   0,  12,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{   6,  -1,   0,  -1,  10,  -1,  -1,  -1,  24,  -1,   0,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{   2,  -1,  -1,   0,  20,  -1,  -1,  -1,  25,   0,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  23,  -1,  -1,  -1,   3,  -1,  -1,  -1,   0,  -1,   9,  11,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  24,  -1,  23,   1,  17,  -1,   3,  -1,  10,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1 },
+	{  25,  -1,  -1,  -1,   8,  -1,  -1,  -1,   7,  18,  -1,  -1,   0,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1 },
+	{  13,  24,  -1,  -1,   0,  -1,   8,  -1,   6,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1 },
+	{   7,  20,  -1,  16,  22,  10,  -1,  -1,  23,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1 },
+	{  11,  -1,  -1,  -1,  19,  -1,  -1,  -1,  13,  -1,   3,  17,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1 },
+	{  25,  -1,   8,  -1,  23,  18,  -1,  14,   9,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0 },
+	{   3,  -1,  -1,  -1,  16,  -1,  -1,   2,  25,   5,  -1,  -1,   1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 648, R = 2/3, Z = 27
+static const int8_t WiFi_R23_N648[ 8 ][ 24 ] = {
+	{  25,  26,  14,  -1,  20,  -1,   2,  -1,   4,  -1,  -1,   8,  -1,  16,  -1,  18,   1,   0,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  10,   9,  15,  11,  -1,   0,  -1,   1,  -1,  -1,  18,  -1,   8,  -1,  10,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1 },
+	{  16,   2,  20,  26,  21,  -1,   6,  -1,   1,  26,  -1,   7,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1 },
+	{  10,  13,   5,   0,  -1,   3,  -1,   7,  -1,  -1,  26,  -1,  -1,  13,  -1,  16,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1 },
+	{  23,  14,  24,  -1,  12,  -1,  19,  -1,  17,  -1,  -1,  -1,  20,  -1,  21,  -1,   0,  -1,  -1,  -1,   0,   0,  -1,  -1 },
+	{   6,  22,   9,  20,  -1,  25,  -1,  17,  -1,   8,  -1,  14,  -1,  18,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1 },
+	{  14,  23,  21,  11,  20,  -1,  24,  -1,  18,  -1,  19,  -1,  -1,  -1,  -1,  22,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0 },
+	{  17,  11,  11,  20,  -1,  21,  -1,  26,  -1,   3,  -1,  -1,  18,  -1,  26,  -1,   1,  -1,  -1,  -1,  -1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 648, R = 3/4, Z = 27
+static const int8_t WiFi_R34_N648[ 6 ][ 24 ] = {
+	{  16,  17,  22,  24,   9,   3,  14,  -1,   4,   2,   7,  -1,  26,  -1,   2,  -1,  21,  -1,   1,   0,  -1,  -1,  -1,  -1 },
+	{  25,  12,  12,   3,   3,  26,   6,  21,  -1,  15,  22,  -1,  15,  -1,   4,  -1,  -1,  16,  -1,   0,   0,  -1,  -1,  -1 },
+	{  25,  18,  26,  16,  22,  23,   9,  -1,   0,  -1,   4,  -1,   4,  -1,   8,  23,  11,  -1,  -1,  -1,   0,   0,  -1,  -1 },
+	{   9,   7,   0,   1,  17,  -1,  -1,   7,   3,  -1,   3,  23,  -1,  16,  -1,  -1,  21,  -1,   0,  -1,  -1,   0,   0,  -1 },
+	{  24,   5,  26,   7,   1,  -1,  -1,  15,  24,  15,  -1,   8,  -1,  13,  -1,  13,  -1,  11,  -1,  -1,  -1,  -1,   0,   0 },
+	{   2,   2,  19,  14,  24,   1,  15,  19,  -1,  21,  -1,   2,  -1,  24,  -1,   3,  -1,   2,   1,  -1,  -1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 648, R = 5/6, Z = 27
+static const int8_t WiFi_R56_N648[ 4 ][ 24 ] = {
+	{  17,  13,   8,  21,   9,   3,  18,  12,  10,   0,   4,  15,  19,   2,   5,  10,  26,  19,  13,  13,   1,   0,  -1,  -1 },
+	{   3,  12,  11,  14,  11,  25,   5,  18,   0,   9,   2,  26,  26,  10,  24,   7,  14,  20,   4,   2,  -1,   0,   0,  -1 },
+	{  22,  16,   4,   3,  10,  21,  12,   5,  21,  14,  19,   5,  -1,   8,   5,  18,  11,   5,   5,  15,   0,  -1,   0,   0 },
+	{   7,   7,  14,  14,   4,  16,  16,  24,  24,  10,   1,   7,  15,   6,  10,  26,   8,  18,  21,  14,   1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 1296, R = 1/2, Z = 54
+static const int8_t WiFi_R12_N1296[ 12 ][ 24 ] = {
+	{  40,  -1,  -1,  -1,  22,  -1,  49,  23,  43,  -1,  -1,  -1,   1,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  50,   1,  -1,  -1,  48,  35,  -1,  -1,  13,  -1,  30,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  39,  50,  -1,  -1,   4,  -1,   2,  -1,  -1,  -1,  -1,  49,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  33,  -1,  -1,  38,  37,  -1,  -1,   4,   1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  45,  -1,  -1,  -1,   0,  22,  -1,  -1,  20,  42,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  51,  -1,  -1,  48,  35,  -1,  -1,  -1,  44,  -1,  18,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1 },
+	{  47,  11,  -1,  -1,  -1,  17,  -1,  -1,  51,  -1,  -1,  -1,   0,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1 },
+	{   5,  -1,  25,  -1,   6,  -1,  45,  -1,  13,  40,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1 },
+	{  33,  -1,  -1,  34,  24,  -1,  -1,  -1,  23,  -1,  -1,  46,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1 },
+	{   1,  -1,  27,  -1,   1,  -1,  -1,  -1,  38,  -1,  44,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1 },
+	{  -1,  18,  -1,  -1,  23,  -1,  -1,   8,   0,  35,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0 },
+	{  49,  -1,  17,  -1,  30,  -1,  -1,  -1,  34,  -1,  -1,  19,   1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 1296, R = 2/3, Z = 54
+static const int8_t WiFi_R23_N1296[ 8 ][ 24 ] = {
+	{  39,  31,  22,  43,  -1,  40,   4,  -1,  11,  -1,  -1,  50,  -1,  -1,  -1,   6,   1,   0,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  25,  52,  41,   2,   6,  -1,  14,  -1,  34,  -1,  -1,  -1,  24,  -1,  37,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1 },
+	{  43,  31,  29,   0,  21,  -1,  28,  -1,  -1,   2,  -1,  -1,   7,  -1,  17,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1 },
+	{  20,  33,  48,  -1,   4,  13,  -1,  26,  -1,  -1,  22,  -1,  -1,  46,  42,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1 },
+	{  45,   7,  18,  51,  12,  25,  -1,  -1,  -1,  50,  -1,  -1,   5,  -1,  -1,  -1,   0,  -1,  -1,  -1,   0,   0,  -1,  -1 },
+	{  35,  40,  32,  16,   5,  -1,  -1,  18,  -1,  -1,  43,  51,  -1,  32,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1 },
+	{   9,  24,  13,  22,  28,  -1,  -1,  37,  -1,  -1,  25,  -1,  -1,  52,  -1,  13,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0 },
+	{  32,  22,   4,  21,  16,  -1,  -1,  -1,  27,  28,  -1,  38,  -1,  -1,  -1,   8,   1,  -1,  -1,  -1,  -1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 1296, R = 3/4, Z = 54
+static const int8_t WiFi_R34_N1296[ 6 ][ 24 ] = {
+	{  39,  40,  51,  41,   3,  29,   8,  36,  -1,  14,  -1,   6,  -1,  33,  -1,  11,  -1,   4,   1,   0,  -1,  -1,  -1,  -1 },
+	{  48,  21,  47,   9,  48,  35,  51,  -1,  38,  -1,  28,  -1,  34,  -1,  50,  -1,  50,  -1,  -1,   0,   0,  -1,  -1,  -1 },
+	{  30,  39,  28,  42,  50,  39,   5,  17,  -1,   6,  -1,  18,  -1,  20,  -1,  15,  -1,  40,  -1,  -1,   0,   0,  -1,  -1 },
+	{  29,   0,   1,  43,  36,  30,  47,  -1,  49,  -1,  47,  -1,   3,  -1,  35,  -1,  34,  -1,   0,  -1,  -1,   0,   0,  -1 },
+	{   1,  32,  11,  23,  10,  44,  12,   7,  -1,  48,  -1,   4,  -1,   9,  -1,  17,  -1,  16,  -1,  -1,  -1,  -1,   0,   0 },
+	{  13,   7,  15,  47,  23,  16,  47,  -1,  43,  -1,  29,  -1,  52,  -1,   2,  -1,  53,  -1,   1,  -1,  -1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 1296, R = 5/6, Z = 54
+static const int8_t WiFi_R56_N1296[ 4 ][ 24 ] = {
+	{  48,  29,  37,  52,   2,  16,   6,  14,  53,  31,  34,   5,  18,  42,  53,  31,  45,  -1,  46,  52,   1,   0,  -1,  -1 },
+	{  17,   4,  30,   7,  43,  11,  24,   6,  14,  21,   6,  39,  17,  40,  47,   7,  15,  41,  19,  -1,  -1,   0,   0,  -1 },
+	{   7,   2,  51,  31,  46,  23,  16,  11,  53,  40,  10,   7,  46,  53,  33,  35,  -1,  25,  35,  38,   0,  -1,   0,   0 },
+	{  19,  48,  41,   1,  10,   7,  36,  47,   5,  29,  52,  52,  31,  10,  26,   6,   3,   2,  -1,  51,   1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 1944, R = 1/2, Z = 81
+static const int8_t WiFi_R12_N1944[ 12 ][ 24 ] = {
+	{  57,  -1,  -1,  -1,  50,  -1,  11,  -1,  50,  -1,  79,  -1,   1,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{   3,  -1,  28,  -1,   0,  -1,  -1,  -1,  55,   7,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  30,  -1,  -1,  -1,  24,  37,  -1,  -1,  56,  14,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  62,  53,  -1,  -1,  53,  -1,  -1,   3,  35,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  40,  -1,  -1,  20,  66,  -1,  -1,  22,  28,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{   0,  -1,  -1,  -1,   8,  -1,  42,  -1,  50,  -1,  -1,   8,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1 },
+	{  69,  79,  79,  -1,  -1,  -1,  56,  -1,  52,  -1,  -1,  -1,   0,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1 },
+	{  65,  -1,  -1,  -1,  38,  57,  -1,  -1,  72,  -1,  27,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1 },
+	{  64,  -1,  -1,  -1,  14,  52,  -1,  -1,  30,  -1,  -1,  32,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1 },
+	{  -1,  45,  -1,  70,   0,  -1,  -1,  -1,  77,   9,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1 },
+	{   2,  56,  -1,  57,  35,  -1,  -1,  -1,  -1,  -1,  12,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0 },
+	{  24,  -1,  61,  -1,  60,  -1,  -1,  27,  51,  -1,  -1,  16,   1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 1944, R = 2/3, Z = 81
+static const int8_t WiFi_R23_N1944[ 8 ][ 24 ] = {
+	{  61,  75,   4,  63,  56,  -1,  -1,  -1,  -1,  -1,  -1,   8,  -1,   2,  17,  25,   1,   0,  -1,  -1,  -1,  -1,  -1,  -1 },
+	{  56,  74,  77,  20,  -1,  -1,  -1,  64,  24,   4,  67,  -1,   7,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1,  -1 },
+	{  28,  21,  68,  10,   7,  14,  65,  -1,  -1,  -1,  23,  -1,  -1,  -1,  75,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1,  -1 },
+	{  48,  38,  43,  78,  76,  -1,  -1,  -1,  -1,   5,  36,  -1,  15,  72,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1 },
+	{  40,   2,  53,  25,  -1,  52,  62,  -1,  20,  -1,  -1,  44,  -1,  -1,  -1,  -1,   0,  -1,  -1,  -1,   0,   0,  -1,  -1 },
+	{  69,  23,  64,  10,  22,  -1,  21,  -1,  -1,  -1,  -1,  -1,  68,  23,  29,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0,  -1 },
+	{  12,   0,  68,  20,  55,  61,  -1,  40,  -1,  -1,  -1,  52,  -1,  -1,  -1,  44,  -1,  -1,  -1,  -1,  -1,  -1,   0,   0 },
+	{  58,   8,  34,  64,  78,  -1,  -1,  11,  78,  24,  -1,  -1,  -1,  -1,  -1,  58,   1,  -1,  -1,  -1,  -1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 1944, R = 3/4, Z = 81
+static const int8_t WiFi_R34_N1944[ 6 ][ 24 ] = {
+	{  48,  29,  28,  39,   9,  61,  -1,  -1,  -1,  63,  45,  80,  -1,  -1,  -1,  37,  32,  22,   1,   0,  -1,  -1,  -1,  -1 },
+	{   4,  49,  42,  48,  11,  30,  -1,  -1,  -1,  49,  17,  41,  37,  15,  -1,  54,  -1,  -1,  -1,   0,   0,  -1,  -1,  -1 },
+	{  35,  76,  78,  51,  37,  35,  21,  -1,  17,  64,  -1,  -1,  -1,  59,   7,  -1,  -1,  32,  -1,  -1,   0,   0,  -1,  -1 },
+	{   9,  65,  44,   9,  54,  56,  73,  34,  42,  -1,  -1,  -1,  35,  -1,  -1,  -1,  46,  39,   0,  -1,  -1,   0,   0,  -1 },
+	{   3,  62,   7,  80,  68,  26,  -1,  80,  55,  -1,  36,  -1,  26,  -1,   9,  -1,  72,  -1,  -1,  -1,  -1,  -1,   0,   0 },
+	{  26,  75,  33,  21,  69,  59,   3,  38,  -1,  -1,  -1,  35,  -1,  62,  36,  26,  -1,  -1,   1,  -1,  -1,  -1,  -1,   0 },
+} ;
+
+//802.11 N = 1944, R = 5/6, Z = 81
+static const int8_t WiFi_R56_N1944[ 4 ][ 24 ] = {
+	{  13,  48,  80,  66,   4,  74,   7,  30,  76,  52,  37,  60,  -1,  49,  73,  31,  74,  73,  23,  -1,   1,   0,  -1,  -1 },
+	{  69,  63,  74,  56,  64,  77,  57,  65,   6,  16,  51,  -1,  64,  -1,  68,   9,  48,  62,  54,  27,  -1,   0,   0,  -1 },
+	{  51,  15,   0,  80,  24,  25,  42,  54,  44,  71,  71,   9,  67,  35,  -1,  58,  -1,  29,  -1,  53,   0,  -1,   0,   0 },
+	{  16,  29,  36,  41,  44,  56,  59,  37,  50,  24,  -1,  65,   4,  65,  52,  -1,   4,  -1,  73,  52,   1,  -1,  -1,   0 },
+} ;
+
+//WiMAX matrices of the Z0 = 96 shifts, F( s, z ) scales one shift to z
+
+//802.16 R = 5/6
+#define WIMAX_R56( F, z ) { \
+	{ F(   1, z ), F(  25, z ), F(  55, z ), F(  -1, z ), F(  47, z ), F(   4, z ), F(  -1, z ), F(  91, z ), F(  84, z ), F(   8, z ), F(  86, z ), F(  52, z ), F(  82, z ), F(  33, z ), F(   5, z ), F(   0, z ), F(  36, z ), F(  20, z ), F(   4, z ), F(  77, z ), F(  80, z ), F(   0, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(   6, z ), F(  -1, z ), F(  36, z ), F(  40, z ), F(  47, z ), F(  12, z ), F(  79, z ), F(  47, z ), F(  -1, z ), F(  41, z ), F(  21, z ), F(  12, z ), F(  71, z ), F(  14, z ), F(  72, z ), F(   0, z ), F(  44, z ), F(  49, z ), F(   0, z ), F(   0, z ), F(   0, z ), F(   0, z ), F(  -1, z ) }, \
+	{ F(  51, z ), F(  81, z ), F(  83, z ), F(   4, z ), F(  67, z ), F(  -1, z ), F(  21, z ), F(  -1, z ), F(  31, z ), F(  24, z ), F(  91, z ), F(  61, z ), F(  81, z ), F(   9, z ), F(  86, z ), F(  78, z ), F(  60, z ), F(  88, z ), F(  67, z ), F(  15, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ) }, \
+	{ F(  68, z ), F(  -1, z ), F(  50, z ), F(  15, z ), F(  -1, z ), F(  36, z ), F(  13, z ), F(  10, z ), F(  11, z ), F(  20, z ), F(  53, z ), F(  90, z ), F(  29, z ), F(  92, z ), F(  57, z ), F(  30, z ), F(  84, z ), F(  92, z ), F(  11, z ), F(  66, z ), F(  80, z ), F(  -1, z ), F(  -1, z ), F(   0, z ) } \
+}
+
+//802.16 R = 3/4 A
+#define WIMAX_R34A( F, z ) { \
+	{ F(   6, z ), F(  38, z ), F(   3, z ), F(  93, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  30, z ), F(  70, z ), F(  -1, z ), F(  86, z ), F(  -1, z ), F(  37, z ), F(  38, z ), F(   4, z ), F(  11, z ), F(  -1, z ), F(  46, z ), F(  48, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  62, z ), F(  94, z ), F(  19, z ), F(  84, z ), F(  -1, z ), F(  92, z ), F(  78, z ), F(  -1, z ), F(  15, z ), F(  -1, z ), F(  -1, z ), F(  92, z ), F(  -1, z ), F(  45, z ), F(  24, z ), F(  32, z ), F(  30, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  71, z ), F(  -1, z ), F(  55, z ), F(  -1, z ), F(  12, z ), F(  66, z ), F(  45, z ), F(  79, z ), F(  -1, z ), F(  78, z ), F(  -1, z ), F(  -1, z ), F(  10, z ), F(  -1, z ), F(  22, z ), F(  55, z ), F(  70, z ), F(  82, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  38, z ), F(  61, z ), F(  -1, z ), F(  66, z ), F(   9, z ), F(  73, z ), F(  47, z ), F(  64, z ), F(  -1, z ), F(  39, z ), F(  61, z ), F(  43, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  95, z ), F(  32, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  32, z ), F(  52, z ), F(  55, z ), F(  80, z ), F(  95, z ), F(  22, z ), F(   6, z ), F(  51, z ), F(  24, z ), F(  90, z ), F(  44, z ), F(  20, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ) }, \
+	{ F(  -1, z ), F(  63, z ), F(  31, z ), F(  88, z ), F(  20, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   6, z ), F(  40, z ), F(  56, z ), F(  16, z ), F(  71, z ), F(  53, z ), F(  -1, z ), F(  -1, z ), F(  27, z ), F(  26, z ), F(  48, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ) } \
+}
+
+//802.16 R = 3/4 B
+#define WIMAX_R34B( F, z ) { \
+	{ F(  -1, z ), F(  81, z ), F(  -1, z ), F(  28, z ), F(  -1, z ), F(  -1, z ), F(  14, z ), F(  25, z ), F(  17, z ), F(  -1, z ), F(  -1, z ), F(  85, z ), F(  29, z ), F(  52, z ), F(  78, z ), F(  95, z ), F(  22, z ), F(  92, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  42, z ), F(  -1, z ), F(  14, z ), F(  68, z ), F(  32, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  70, z ), F(  43, z ), F(  11, z ), F(  36, z ), F(  40, z ), F(  33, z ), F(  57, z ), F(  38, z ), F(  24, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(  20, z ), F(  -1, z ), F(  -1, z ), F(  63, z ), F(  39, z ), F(  -1, z ), F(  70, z ), F(  67, z ), F(  -1, z ), F(  38, z ), F(   4, z ), F(  72, z ), F(  47, z ), F(  29, z ), F(  60, z ), F(   5, z ), F(  80, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  64, z ), F(   2, z ), F(  -1, z ), F(  -1, z ), F(  63, z ), F(  -1, z ), F(  -1, z ), F(   3, z ), F(  51, z ), F(  -1, z ), F(  81, z ), F(  15, z ), F(  94, z ), F(   9, z ), F(  85, z ), F(  36, z ), F(  14, z ), F(  19, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  53, z ), F(  60, z ), F(  80, z ), F(  -1, z ), F(  26, z ), F(  75, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  86, z ), F(  77, z ), F(   1, z ), F(   3, z ), F(  72, z ), F(  60, z ), F(  25, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ) }, \
+	{ F(  77, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  15, z ), F(  28, z ), F(  -1, z ), F(  35, z ), F(  -1, z ), F(  72, z ), F(  30, z ), F(  68, z ), F(  85, z ), F(  84, z ), F(  26, z ), F(  64, z ), F(  11, z ), F(  89, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ) } \
+}
+
+//802.16 R = 2/3 A, shifts scaled modulo Z
+#define WIMAX_R23A( F, z ) { \
+	{ F(   3, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(   2, z ), F(   0, z ), F(  -1, z ), F(   3, z ), F(   7, z ), F(  -1, z ), F(   1, z ), F(   1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   1, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(   1, z ), F(  -1, z ), F(  36, z ), F(  -1, z ), F(  -1, z ), F(  34, z ), F(  10, z ), F(  -1, z ), F(  -1, z ), F(  18, z ), F(   2, z ), F(  -1, z ), F(   3, z ), F(   0, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(  12, z ), F(   2, z ), F(  -1, z ), F(  15, z ), F(  -1, z ), F(  40, z ), F(  -1, z ), F(   3, z ), F(  -1, z ), F(  15, z ), F(  -1, z ), F(   2, z ), F(  13, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(  19, z ), F(  24, z ), F(  -1, z ), F(   3, z ), F(   0, z ), F(  -1, z ), F(   6, z ), F(  -1, z ), F(  17, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   8, z ), F(  39, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  20, z ), F(  -1, z ), F(   6, z ), F(  -1, z ), F(  -1, z ), F(  10, z ), F(  29, z ), F(  -1, z ), F(  -1, z ), F(  28, z ), F(  -1, z ), F(  14, z ), F(  -1, z ), F(  38, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(  10, z ), F(  -1, z ), F(  28, z ), F(  20, z ), F(  -1, z ), F(  -1, z ), F(   8, z ), F(  -1, z ), F(  36, z ), F(  -1, z ), F(   9, z ), F(  -1, z ), F(  21, z ), F(  45, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ) }, \
+	{ F(  35, z ), F(  25, z ), F(  -1, z ), F(  37, z ), F(  -1, z ), F(  21, z ), F(  -1, z ), F(  -1, z ), F(   5, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(  -1, z ), F(   4, z ), F(  20, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ) }, \
+	{ F(  -1, z ), F(   6, z ), F(   6, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   4, z ), F(  -1, z ), F(  14, z ), F(  30, z ), F(  -1, z ), F(   3, z ), F(  36, z ), F(  -1, z ), F(  14, z ), F(  -1, z ), F(   1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ) } \
+}
+
+//802.16 R = 2/3 B
+#define WIMAX_R23B( F, z ) { \
+	{ F(   2, z ), F(  -1, z ), F(  19, z ), F(  -1, z ), F(  47, z ), F(  -1, z ), F(  48, z ), F(  -1, z ), F(  36, z ), F(  -1, z ), F(  82, z ), F(  -1, z ), F(  47, z ), F(  -1, z ), F(  15, z ), F(  -1, z ), F(  95, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  69, z ), F(  -1, z ), F(  88, z ), F(  -1, z ), F(  33, z ), F(  -1, z ), F(   3, z ), F(  -1, z ), F(  16, z ), F(  -1, z ), F(  37, z ), F(  -1, z ), F(  40, z ), F(  -1, z ), F(  48, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  10, z ), F(  -1, z ), F(  86, z ), F(  -1, z ), F(  62, z ), F(  -1, z ), F(  28, z ), F(  -1, z ), F(  85, z ), F(  -1, z ), F(  16, z ), F(  -1, z ), F(  34, z ), F(  -1, z ), F(  73, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  28, z ), F(  -1, z ), F(  32, z ), F(  -1, z ), F(  81, z ), F(  -1, z ), F(  27, z ), F(  -1, z ), F(  88, z ), F(  -1, z ), F(   5, z ), F(  -1, z ), F(  56, z ), F(  -1, z ), F(  37, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  23, z ), F(  -1, z ), F(  29, z ), F(  -1, z ), F(  15, z ), F(  -1, z ), F(  30, z ), F(  -1, z ), F(  66, z ), F(  -1, z ), F(  24, z ), F(  -1, z ), F(  50, z ), F(  -1, z ), F(  62, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  30, z ), F(  -1, z ), F(  65, z ), F(  -1, z ), F(  54, z ), F(  -1, z ), F(  14, z ), F(  -1, z ), F(   0, z ), F(  -1, z ), F(  30, z ), F(  -1, z ), F(  74, z ), F(  -1, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ) }, \
+	{ F(  32, z ), F(  -1, z ), F(   0, z ), F(  -1, z ), F(  15, z ), F(  -1, z ), F(  56, z ), F(  -1, z ), F(  85, z ), F(  -1, z ), F(   5, z ), F(  -1, z ), F(   6, z ), F(  -1, z ), F(  52, z ), F(  -1, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ) }, \
+	{ F(  -1, z ), F(   0, z ), F(  -1, z ), F(  47, z ), F(  -1, z ), F(  13, z ), F(  -1, z ), F(  61, z ), F(  -1, z ), F(  84, z ), F(  -1, z ), F(  55, z ), F(  -1, z ), F(  78, z ), F(  -1, z ), F(  41, z ), F(  95, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ) } \
+}
+
+//802.16 R = 1/2
+#define WIMAX_R12( F, z ) { \
+	{ F(  -1, z ), F(  94, z ), F(  73, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  55, z ), F(  83, z ), F(  -1, z ), F(  -1, z ), F(   7, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  27, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  22, z ), F(  79, z ), F(   9, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  12, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  24, z ), F(  22, z ), F(  81, z ), F(  -1, z ), F(  33, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  61, z ), F(  -1, z ), F(  47, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  65, z ), F(  25, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(  39, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  84, z ), F(  -1, z ), F(  -1, z ), F(  41, z ), F(  72, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  46, z ), F(  40, z ), F(  -1, z ), F(  82, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  79, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(  95, z ), F(  53, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  14, z ), F(  18, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  11, z ), F(  73, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   2, z ), F(  -1, z ), F(  -1, z ), F(  47, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  12, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  83, z ), F(  24, z ), F(  -1, z ), F(  43, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  51, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  94, z ), F(  -1, z ), F(  59, z ), F(  -1, z ), F(  -1, z ), F(  70, z ), F(  72, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ), F(  -1, z ) }, \
+	{ F(  -1, z ), F(  -1, z ), F(   7, z ), F(  65, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  39, z ), F(  49, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ), F(   0, z ) }, \
+	{ F(  43, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  66, z ), F(  -1, z ), F(  41, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  26, z ), F(   7, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(  -1, z ), F(   0, z ) } \
+}
+
+//Z = N / 24 of all WiMAX lengths, N = 576 : 96 : 2304
+#define Y_WIMAX_Z( X ) X( 24 ) X( 28 ) X( 32 ) X( 36 ) X( 40 ) X( 44 ) X( 48 ) X( 52 ) X( 56 ) X( 60 ) \
+	X( 64 ) X( 68 ) X( 72 ) X( 76 ) X( 80 ) X( 84 ) X( 88 ) X( 92 ) X( 96 )
+#define Y_WIMAX_NZ 19
+
+#define Y_FLOOR( s, z ) ( ( s ) > 0 ? ( s ) * ( z ) / 96 : ( s ) )		// floor( s z / z0 )
+#define Y_MOD( s, z ) ( ( s ) > 0 ? ( s ) % ( z ) : ( s ) )				// mod( s, z ), rate 2/3 A only
+
+#define Y_R56( z ) WIMAX_R56( Y_FLOOR, z ),
+#define Y_R34A( z ) WIMAX_R34A( Y_FLOOR, z ),
+#define Y_R34B( z ) WIMAX_R34B( Y_FLOOR, z ),
+#define Y_R23A( z ) WIMAX_R23A( Y_MOD, z ),
+#define Y_R23B( z ) WIMAX_R23B( Y_FLOOR, z ),
+#define Y_R12( z ) WIMAX_R12( Y_FLOOR, z ),
+
+static const int8_t WiMAX_R56[ Y_WIMAX_NZ ][ 4 ][ 24 ] = { Y_WIMAX_Z( Y_R56 ) } ;
+static const int8_t WiMAX_R34A[ Y_WIMAX_NZ ][ 6 ][ 24 ] = { Y_WIMAX_Z( Y_R34A ) } ;
+static const int8_t WiMAX_R34B[ Y_WIMAX_NZ ][ 6 ][ 24 ] = { Y_WIMAX_Z( Y_R34B ) } ;
+static const int8_t WiMAX_R23A[ Y_WIMAX_NZ ][ 8 ][ 24 ] = { Y_WIMAX_Z( Y_R23A ) } ;
+static const int8_t WiMAX_R23B[ Y_WIMAX_NZ ][ 8 ][ 24 ] = { Y_WIMAX_Z( Y_R23B ) } ;
+static const int8_t WiMAX_R12[ Y_WIMAX_NZ ][ 12 ][ 24 ] = { Y_WIMAX_Z( Y_R12 ) } ;
+
+//rates in the order of the tables: numerator, denominator, block rows
+static const int Rates[ 4 ][ 3 ] = { { 1, 2, 12 }, { 2, 3, 8 }, { 3, 4, 6 }, { 5, 6, 4 } } ;
+
+static const int8_t *WiFi[ 3 ][ 4 ] = {
+	{ &WiFi_R12_N648[ 0 ][ 0 ], &WiFi_R23_N648[ 0 ][ 0 ], &WiFi_R34_N648[ 0 ][ 0 ], &WiFi_R56_N648[ 0 ][ 0 ] },
+	{ &WiFi_R12_N1296[ 0 ][ 0 ], &WiFi_R23_N1296[ 0 ][ 0 ], &WiFi_R34_N1296[ 0 ][ 0 ], &WiFi_R56_N1296[ 0 ][ 0 ] },
+	{ &WiFi_R12_N1944[ 0 ][ 0 ], &WiFi_R23_N1944[ 0 ][ 0 ], &WiFi_R34_N1944[ 0 ][ 0 ], &WiFi_R56_N1944[ 0 ][ 0 ] },
+} ;
+
+//[ rate ][ variant A, B ], 1/2 and 5/6 have only one, Y_WIMAX_NZ matrices each
+static const int8_t *WiMAX[ 4 ][ 2 ] = {
+	{ &WiMAX_R12[ 0 ][ 0 ][ 0 ], NULL },
+	{ &WiMAX_R23A[ 0 ][ 0 ][ 0 ], &WiMAX_R23B[ 0 ][ 0 ][ 0 ] },
+	{ &WiMAX_R34A[ 0 ][ 0 ][ 0 ], &WiMAX_R34B[ 0 ][ 0 ][ 0 ] },
+	{ &WiMAX_R56[ 0 ][ 0 ][ 0 ], NULL },
+} ;
+
+
+//global functions definitions-------------------------------------------------
+
+/*
+ * find the base matrix of a standard code, Wi-Fi codes are in slots 0 .. 11,
+ * WiMAX codes in 12 .. Y_NSTD - 1: 8 per length, rate and variant
+ * */
+int YStdCode( int std, int rnum, int rden, int n, char variant, const int8_t **hbm, int *mb, int *z, int *id ){
+	int r, v ;
+
+	for( r = 0 ; r < 4 ; r++ ){
+		if( Rates[ r ][ 0 ] * rden == Rates[ r ][ 1 ] * rnum )
+			break ;
+	}
+	if( r == 4 || rden <= 0 )
+		return YALDPC_ENOCODE ;
+
+	if( variant != 0 && variant != 'A' && variant != 'B' && variant != 'a' && variant != 'b' )
+		return YALDPC_ENOCODE ;
+	v = variant == 'B' || variant == 'b' ;
+
+	*z	= n / 24 ;
+	*mb	= Rates[ r ][ 2 ] ;
+
+	if( std == YALDPC_WIFI ){
+		if( v || ( n != 648 && n != 1296 && n != 1944 ) )
+			return YALDPC_ENOCODE ;
+		*hbm	= WiFi[ n / 648 - 1 ][ r ] ;
+		*id		= ( n / 648 - 1 ) * 4 + r ;
+	}else if( std == YALDPC_WIMAX ){
+		if( n < 576 || n > 2304 || n % 96 != 0 || WiMAX[ r ][ v ] == NULL )
+			return YALDPC_ENOCODE ;
+		*hbm	= WiMAX[ r ][ v ] + ( n / 96 - 6 ) * *mb * 24 ;
+		*id		= 12 + ( ( n / 96 - 6 ) * 4 + r ) * 2 + v ;
+	}else{
+		return YALDPC_ENOCODE ;
+	}
+	return YALDPC_OK ;
+}
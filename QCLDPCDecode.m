@@ -10,13 +10,26 @@ function [ ApLLR, nIter, HD ] = QCLDPCDecode( LLch, dec )
 	%	dec = QCLDPCDecode( dec )
 	%		recompute dependent parameters 
 	%		
+	%	QCLDPCDecode( 'clear' )
+	%		end the worker threads of the MEX file and drop its decoder context,
+	%		the MEX file keeps both between calls and only re-initializes the
+	%		decoder when nIter, lambda, beta or term change
+	%		
 	%	[ ApLLR, Iter [, HD ] ] =  QCLDPCDecode( LLch, dec )
 	%		decode channel LLRs using given decoder parameters
 	%
+	%	[ Bits, Iter [, SysLLR ] ] =  QCLDPCDecode( LLch, dec ) with dec.output = 'bits'
+	%		only the data: Bits are the K systematic hard decisions of every column
+	%		packed MSB first into ( K + 7 ) / 8 uint8, SysLLR the K systematic
+	%		posteriors, the N posteriors are neither copied nor returned
+	%
 	%		LLch - column vector or matrix of column vectors of length N
-	%					default type for fixed point is 'short int', 
-	%					default type for floating point is 'float'
-	%					native MATLAB 'double' type is auto-converted 
+	%					single, double, int16 or int8, passed to the MEX file
+	%					without a converted copy, each column is converted
+	%					while the decoder loads it
+	%					fixed point quantizes single and double like
+	%					float2int( LLch, dec.qbits, dec.fp_max ), integers
+	%					are taken as already quantized
 	%
 	%		dec	- decoder options structure
 	%					assuming MEX file is built with these parameters
@@ -30,6 +43,10 @@ function [ ApLLR, nIter, HD ] = QCLDPCDecode( LLch, dec )
 	%				dec.beta - min-sum offset
 	%								values from 0 (default 0.0 )
 	%				dec.term - termination 'early' (default) or 'max'
+	%				dec.outclass - class of ApLLR: 'double', 'single' or
+	%								'native' ( the decoder's single or int16 ),
+	%								default '': single, fixed point the class of LLch
+	%				dec.output - 'llr' ( default ) or 'bits', see above
 	%		ApLLR	- posterior LLRs (soft-output) for ALL codeword symbols
 	%		Iter	- actual number of iterations performed
 	%		HD		- hard decision, aka decoded bits
@@ -57,10 +74,15 @@ dopts.lambda	= 1 ;		% min-sum normalization
 dopts.beta		= 0 ;		%min-sum offset
 dopts.term		= 'early' ;	% termination: 'early' > when converged 'max' > all iterations
 dopts.hdbitmap	= false ;	% set this to true if using 'bitmap' encoder
+dopts.outclass	= '' ;		% ApLLR class, '' > single, fixed point: class of LLch
+dopts.output	= 'llr' ;	% 'llr' > N posteriors, 'bits' > K packed systematic bits
 
 %build-time options:
 dopts.build		= 'release' ;
 dopts.nthread	= 1 ;	%number of threads to use
+dopts.batch		= 1 ;	% frames per thread decoded layer by layer together, 0 > as many as fit dopts.l2
+dopts.l2		= 2^20 ;	% L2 cache bytes per core for dopts.batch = 0
+dopts.schedule	= 'natural' ;	% layer order: 'natural' or 'overlap' > fewest columns shared by consecutive layers
 
 %defaults for fixed-point implementation:
 %assuming fixed point type is signed 16bit wide 'short int'
@@ -81,8 +103,12 @@ dopts = setMethodParams( dopts.method, dopts ) ;
 		return ;
 
 	elseif nargin == 1 ;
+		if ischar( LLch ) && strcmp( LLch, 'clear' )
+			QCLDPCDecodeMEX() ;
+			return ;
+		end
 		if ~isstruct( LLch )
-			error('Usage: dec = QCLDPCDecode( dec )') ;
+			error('Usage: dec = QCLDPCDecode( dec ) or QCLDPCDecode( ''clear'' )') ;
 		end
 		ApLLR = setMethodParams( LLch.method, LLch ) ;
 		return ;
@@ -94,45 +120,41 @@ dopts = setMethodParams( dopts.method, dopts ) ;
 		hd = 1 ;
 	end
 		
-	%call MEX file 
+	%call MEX file, LLch of class single, double, int16 or int8 goes to the decoder as it is
 	term	= double( strcmp( dec.term, 'early' ) ) ;
-	Options = [ dec.nIter, dec.lambda, dec.beta, dec.dbglev, term ] ;
-	
-	if strcmp( dec.method, 'fixed')
-		t		= class( LLch ) ;
-		LLchQ	= int16( float2int( LLch, dec.qbits, dec.fp_max ) ) ;
-		
-		if hd
-			[ IApLLR, nIter, HD ] = QCLDPCDecodeMEX( LLchQ, Options ) ;
-		else
-			[ IApLLR, nIter ] = QCLDPCDecodeMEX( LLchQ, Options ) ;
-		end
-	
-		%these will really be intXY values
-		ApLLR	= cast( IApLLR, t ) ;
+	Options = [ dec.nIter, dec.lambda, dec.beta, dec.dbglev, term, outClass( dec, LLch ) ] ;
+	bits	= isfield( dec, 'output' ) && strcmp( dec.output, 'bits' ) ;
+	if bits
+		Options = [ Options 1 ] ;
+	end
+
+	if hd
+		[ ApLLR, nIter, HD ] = QCLDPCDecodeMEX( LLch, Options ) ;
 	else
-		if isa( LLch, dec.type )
-			if hd
-				[ ApLLR, nIter, HD ] = QCLDPCDecodeMEX( LLch, Options ) ;
-			else
-				[ ApLLR, nIter ] = QCLDPCDecodeMEX( LLch, Options ) ;
-			end
-		else
-			SLLch = single( LLch ) ;
-			if hd
-				[ SApLLR, nIter, HD ] = QCLDPCDecodeMEX( SLLch, Options ) ;
-			else
-				[ SApLLR, nIter ] = QCLDPCDecodeMEX( SLLch, Options ) ;
-			end
-			ApLLR = cast( SApLLR, dec.type ) ;
-		end
+		[ ApLLR, nIter ] = QCLDPCDecodeMEX( LLch, Options ) ;
 	end
 
-	if hd && ~dec.hdbitmap
+	if hd && ~dec.hdbitmap && ~bits
 		HD = double( HD ) ;
 	end
 end
 
+% Options( 6 ) of QCLDPCDecodeMEX: class of the posteriors
+function c = outClass( dec, LLch )
+	if ~isfield( dec, 'outclass' ) || isempty( dec.outclass )
+		o = dec.type ;
+		if strcmp( dec.method, 'fixed' )
+			o = class( LLch ) ;	% quantized values in the class of LLch
+		end
+	else
+		o = dec.outclass ;
+	end
+	c = find( strcmp( o, { 'double' 'single' } ) ) ;
+	if isempty( c )
+		c = 0 ;		% the decoder's own
+	end
+end
+
 function par = setMethodParams( method, par )
 
 	if strcmp( method, 'float' )
@@ -157,9 +179,9 @@ function par = setMethodParams( method, par )
 	end
 
 	if par.nthread == 1	
-		par.sources	= [ "decoder.c" "debug.c" "ldpc.c" ] ;
+		par.sources	= [ "decoder.c" "debug.c" "ldpc.c" "kernel.c" ] ;
 	else
-		par.sources	= [ "decoderMT.c" "debug.c" "ldpc.c" ] ;
+		par.sources	= [ "decoderMT.c" "debug.c" "ldpc.c" "kernel.c" ] ;
 	end
 
 end
\ No newline at end of file
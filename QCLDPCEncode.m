@@ -29,7 +29,10 @@ function CW = QCLDPCEncode( p1, p2, p3 )
 	%			nr. of rows must == code.K / enc.wb
 	%
 	%		code - code options structure, see loadQCLDPC()
+	%			custom codes with code.std = 'custom' need enc.parity = 'generic'
 	%		enc - encoder options structure 
+	%			enc.parity - 'annexG' (default) dual-diagonal parity part as in WiMAX and WIFI6
+	%						'generic' any invertible parity part, inverse is precomputed once
     %
 	% compatible MEX file must first be built using saveLDPCheader() and buildMEXfile()
 	% see testEnc for examples
@@ -40,8 +43,9 @@ function CW = QCLDPCEncode( p1, p2, p3 )
 
 	%build options
 	dopts.method	= 'array' ;	% 'array' or 'bitmap'
+	dopts.parity	= 'annexG' ;	% 'annexG' or 'generic'
 	dopts.mexfun	= 'QCLDPCEncodeMEX' ; 
-	dopts.sources	= [ "encoder.c" "debug.c" "ldpc.c" ] ;
+	dopts.sources	= [ "encoder.c" "debug.c" "ldpc.c" "kernel.c" ] ;
 	
 	%default options for the bitmap method:
 	dopts.type		= 'uint8' ;
@@ -85,8 +89,12 @@ function OK = paramsOK( code, enc )
 				error( "Bitmap encoding unsupported parameters: N,K,M must be disible by WB.") ;
 			end
 		end
+	elseif strcmp( code.std, 'custom' )
+		if ~isfield( enc, 'parity' ) || ~strcmp( enc.parity, 'generic' )
+			error( "Custom codes need the 'generic' parity encoder.") ;
+		end
 	else
-		error( "Unsupported standard, set: 'wimax' of 'wifi'.") ;
+		error( "Unsupported standard, set: 'wimax', 'wifi' or 'custom'.") ;
 	end
 
 	OK = true ;
@@ -94,29 +102,31 @@ end
 
 function CW = encode( Data, enc )
 
-	Options = [ enc.dbglev, 0 ] ;	%method option is unused now
+	method = 0 ;	% 0 > Annex G, 1 > generic
+	if isfield( enc, 'parity' ) && strcmp( enc.parity, 'generic' )
+		method = 1 ;
+	end
+	Options = [ enc.dbglev, method ] ;
 	
 	if strcmp( enc.method, 'array')
 		%for 'array' encoder type auto-convert the Data to enc.type
 		assert( isBinary( Data ) ) ;
 
+		%MEX returns whole codewords [ Data ; Par ], no concatenation needed
 		if ~isa( Data, enc.type )
 			t		= class( Data ) ;
 			UData	= cast( Data, enc.type ) ;
-			UPar	= QCLDPCEncodeMEX( UData, Options ) ;
-			Par		= cast( UPar, t ) ;
-			CW		= [ Data ; Par ] ;
+			UCW		= QCLDPCEncodeMEX( UData, Options ) ;
+			CW		= cast( UCW, t ) ;
 		else
-			Par		= QCLDPCEncodeMEX( Data, Options ) ;
-			CW		= [ Data ; Par ] ;
+			CW		= QCLDPCEncodeMEX( Data, Options ) ;
 		end
 	else
 		if ~isa( Data, enc.type )
 			error( "For bitmap encoding you must explicitly use the Data of encoder type.") ;
 		end
 		%no auto-datatype conversion performed for 'bitmap' encoder
-		Par = QCLDPCEncodeMEX( Data, Options ) ;
-		CW	= [ Data ; Par ] ;
+		CW = QCLDPCEncodeMEX( Data, Options ) ;
 	end
 end
 
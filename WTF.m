@@ -7,9 +7,24 @@ function res = WTF( code, enc, dec, sim )
 %	sim = WTF()
 %		return default simulation paramaters, many can be changed:
 %		sim.minErr - minimum number of error collected per Eb/N0 point
+%		sim.relCI - if > 0 stop a point once the relative half-width of its 95 % BER and FER
+%				intervals is below relCI ( and at least 10 frame errors ), minErr is then ignored
+%				with 'SIM' the whole sweep is adaptive: each block goes to the widest interval
+%		sim.ferFloor - with relCI: stop a point once its FER upper bound is below ferFloor, 0 > off
 %		sim.blkSize - nr. of codewords per block 
 %				must be a multiple of dec.nthread
 %		sim.impl - 'MEX' (default) or 'COM' for calling Communications Toolbox 
+%				or 'SIM' to run the whole simulation natively in QCLDPCSimMEX
+%		sim.seed - RNG seed for 'SIM', same seed > same results
+%		sim.maxFrames - max. nr. of codewords per Eb/N0 point, 0 > unlimited
+%				relCI needs maxFrames or ferFloor
+%		sim.allZero - transmit the all-zero codeword, skips data generation and encoder
+%				valid for linear codes over symmetric channels, keep false to validate the encoder
+%		sim.qam - 'SIM' only: bits per Gray-mapped QAM symbol, 1 > BPSK, 2, 4 .. 10 > 4 .. 1024-QAM
+%		sim.demap - 'SIM' only: QAM soft demapper 'maxlog' or 'exact'
+%		sim.ckpt - 'SIM' only: checkpoint file, '' > off, a killed sweep resumes
+%				from it when WTF is called again with the same configuration
+%		sim.ckptPeriod - seconds between checkpoints
 %		sim.plot - toggle automatic semilogy plot
 %		sim.save - toggle automatic saving of results to a mat file (res subfolder)
 %		sim.report - send an email with results to a given address
@@ -33,6 +48,15 @@ function res = WTF( code, enc, dec, sim )
 		sim.plot	= true ;	% plot waterfall figure in the end
 		sim.save	= true ;	% save results to local .mat file immediately in WTF
 		sim.impl	= 'MEX' ;	% use custom MEX file, run built-in COM toolbox functions 
+		sim.seed	= 1 ;		% 'SIM' only: RNG seed
+		sim.maxFrames = 0 ;		% stop a point after this many codewords
+		sim.relCI	= 0 ;		% adaptive stopping on confidence intervals, 0 > minErr rule
+		sim.ferFloor = 0 ;		% adaptive stopping: FER of no interest
+		sim.allZero	= false ;	% all-zero codeword, no encoder
+		sim.qam		= 1 ;		% 'SIM' only: bits per QAM symbol, 1 > BPSK
+		sim.demap	= 'maxlog' ;% 'SIM' only: 'maxlog' or 'exact' QAM demapper
+		sim.ckpt	= '' ;		% 'SIM' only: checkpoint file for resuming long sweeps
+		sim.ckptPeriod = 60 ;	% seconds between checkpoints
 		res = sim ;
 		return ;
 	end
@@ -55,8 +79,20 @@ function res = WTF( code, enc, dec, sim )
 	DBits		= zeros( s ) ;		% number of data bits simulated
 	TElaps		= zeros( s ) ;		% elapsed time for each point
 	ITER		= zeros( s ) ;		% average nr. of iterations
+	FERR		= zeros( s ) ;		% frame errors
+	FRM			= zeros( s ) ;		% frames simulated
+	CI			= zeros( 4, s( 2 ) ) ;	% 95 % intervals: BER low, BER high, FER low, FER high
+
+	if sim.relCI > 0 && sim.maxFrames == 0 && sim.ferFloor <= 0
+		error( 'sim.relCI needs sim.maxFrames or sim.ferFloor.' ) ;
+	end
 
 	com = strcmp( sim.impl, 'COM') ;
+	nat = strcmp( sim.impl, 'SIM') ;
+
+	if sim.qam > 1 && ~nat
+		error( 'sim.qam > 1 needs sim.impl = ''SIM''.' ) ;
+	end
 
 	if com
 		% use MATLAB communications system toolbox implementation
@@ -64,13 +100,33 @@ function res = WTF( code, enc, dec, sim )
 		enc	= ldpcEncoderConfig( dec ) ;
 		dec.Algorithm = 'norm-min-sum' ;
 		disp( 'Running Communications System Toolbox Implementation.' ) ;
+	elseif nat
+		% data, encoder, channel, decoder and error counting all in C
+		enc = QCLDPCEncode( enc ) ; 
+		dec = QCLDPCDecode( dec ) ;
+		
+		saveLDPCheader( 'ldpc', code, enc, dec, 'MEX' ) ;
+		desc			= dec ;
+		desc.mexfun		= 'QCLDPCSimMEX' ;
+		desc.sources	= [ "sim.c" "rng.c" "demap.c" "latency.c" "encoder.c" dec.sources ] ;
+		desc.pthread	= true ;
+		buildMEXfile( desc ) ;
+		
+		DecOpts	= [ NIter, Lambda, dec.beta, dec.dbglev, double( strcmp( dec.term, 'early' ) ) ] ;
+		SimOpts	= [ R, sim.minErr, sim.maxFrames, BLK, sim.seed, NThread, strcmp( enc.parity, 'generic' ), 0, sim.allZero, sim.relCI, sim.ferFloor, sim.ckptPeriod, sim.qam, strcmp( sim.demap, 'exact' ) ] ;
+		disp( 'Running native C simulation.' ) ;
 	else
 		enc = QCLDPCEncode( enc ) ; 
+		dec.output = 'bits' ;	% packed data bits, errors counted by popcount
 		dec = QCLDPCDecode( dec ) ;
 		
 		saveLDPCheader( 'ldpc', code, enc, dec, 'MEX' ) ;
 		buildMEXfile( enc ) ;
 		buildMEXfile( dec ) ;
+		desc			= dec ;
+		desc.mexfun		= 'QCLDPCBitsMEX' ;
+		desc.sources	= [ "ykernel.c" ] ;
+		buildMEXfile( desc ) ;
 		disp( 'Running MEX Implementation.' ) ;
 	end
 
@@ -102,11 +158,33 @@ function res = WTF( code, enc, dec, sim )
 		sigma	= sqrt( varCh ) ;
 	
 		nErr	= 0 ;
+		nErr2	= 0 ;
+		nFErr	= 0 ;
 		nBlk	= 0 ;
+
+		if nat
+			if x == 1
+				% one sweep over all points, counters of all points at once
+				if isempty( sim.ckpt )
+					Cnt		= QCLDPCSimMEX( EBN0, DecOpts, SimOpts ) ;
+				else
+					Cnt		= QCLDPCSimMEX( EBN0, DecOpts, SimOpts, sim.ckpt ) ;
+				end
+			end
+			cnt				= Cnt( :, x ) ;
+			nErr			= cnt( 1 ) ;
+			nFErr			= cnt( 2 ) ;
+			nBlk			= cnt( 3 ) / BLK ;
+			ITER( x )		= cnt( 4 ) ;
+			CI( :, x )		= cnt( 6 : 9 ) ;
+		end
 	
-		while nErr < sim.minErr
+		while ~nat && ~pointDone( sim, nErr, nErr2, nFErr, nBlk * BLK, K )
 			
-			if com
+			if sim.allZero
+				Data	= false( K, BLK ) ;
+				CW		= false( N, BLK ) ;
+			elseif com
 				Data	= logical( randi( [ 0 1 ], K, BLK ) ) ;
 				CW		= ldpcEncode( Data, enc ) ;
 			else
@@ -123,14 +201,19 @@ function res = WTF( code, enc, dec, sim )
 			if com
 				[ HD, Iter ] = ldpcDecode( LLRch, dec, NIter, MinSumScalingFactor=Lambda ) ;
 				HD					= logical( HD ) ; 
+				if sim.allZero
+					e		= sum( HD, 1 ) ;
+				else
+					e		= sum( Data ~= HD, 1 ) ;
+				end
 			else
-				[ ApLLR, Iter ] = QCLDPCDecode( LLRch, dec ) ;
-				HD				= hardDecision( ApLLR, enc.type ) ;
-				HD				= HD( 1 : K, : ) ;
+				% K decoded bits per column packed to uint8, no double matrices
+				[ HD, Iter ]	= QCLDPCDecode( LLRch, dec ) ;
+				e				= QCLDPCBitsMEX( 'errors', HD, QCLDPCBitsMEX( 'pack', Data ) ) ;
 			end
-
-			
-			nErr			= nErr + nnz( Data ~= HD ) ;
+			nErr			= nErr + sum( e ) ;
+			nErr2			= nErr2 + sum( e .^ 2 ) ;
+			nFErr			= nFErr + nnz( e ) ;
 			nBlk			= nBlk + 1 ;
 			ITER( x )		= ITER( x ) + sum( Iter ) ;
 		end
@@ -139,6 +222,13 @@ function res = WTF( code, enc, dec, sim )
 		DBits( x )	= DBits( x ) + nBlk * BLK * K ;
 		BER( x )	= ERR( x ) / DBits( x ) ;
 		ITER( x )	= ITER( x ) / ( nBlk * BLK ) ;
+		FERR( x )	= nFErr ;
+		FRM( x )	= nBlk * BLK ;
+
+		if ~nat
+			ci			= simCI( nErr, nErr2, nFErr, FRM( x ), K ) ;
+			CI( :, x )	= [ ci.berLo ; ci.berHi ; ci.ferLo ; ci.ferHi ] ;
+		end
 
 		% Immediate user printouts ---------------------------------------
 		telapsed	= toc( tstart ) ;
@@ -146,8 +236,8 @@ function res = WTF( code, enc, dec, sim )
 		tstr		= datestr( datenum( 0, 0, 0, 0, 0, telapsed ), "DD:HH:MM:SS" ) ; 
 		TElaps( x ) = telapsed ;
 	
-		fprintf( 'Eb/N0: %4.2f ITER: %4.2f Errors: %10d Bits: %15d BER: %e Tel: %s\n', ...
-		EBN0( x ), ITER( x ), ERR( x ), DBits( x ), BER( x ), tstr )
+		fprintf( 'Eb/N0: %4.2f ITER: %4.2f Errors: %10d Bits: %15d BER: %e [ %e %e ] FER: %e [ %e %e ] Tel: %s\n', ...
+		EBN0( x ), ITER( x ), ERR( x ), DBits( x ), BER( x ), CI( 1, x ), CI( 2, x ), FERR( x ) / FRM( x ), CI( 3, x ), CI( 4, x ), tstr )
 	
 
 		if sim.report && x < size( EBN0, 2 )
@@ -166,6 +256,10 @@ function res = WTF( code, enc, dec, sim )
 		end
 	
 	end
+
+	if ~com && ~nat
+		QCLDPCDecode( 'clear' ) ;	% end the MEX decoder threads
+	end
 	
 
 %% results processing 
@@ -180,6 +274,8 @@ function res = WTF( code, enc, dec, sim )
 		
 	res.ERR			= ERR ;
 	res.BER			= BER ;
+	res.FER			= FERR ./ FRM ;
+	res.CI			= CI ;
 	res.ITER		= ITER ;
 	res.DBits		= DBits ;
 	res.TElaps		= TElaps ;
@@ -188,6 +284,8 @@ function res = WTF( code, enc, dec, sim )
 		name	= [ 'wtf_' res.std '_n' num2str( N ) '_R' rate2str( R ) ] ;
 		if strcmp( sim.impl, 'MEX' )
 			name = [ name '_MEX_' dec.method ] ;
+		elseif nat
+			name = [ name '_SIM_' dec.method ] ;
 		else
 			name = [ name '_COM'] ;
 		end
@@ -217,46 +315,17 @@ function res = WTF( code, enc, dec, sim )
 		msg = formatEmail( res ) ;
 		reportEmail( 'Simulation completed', msg, sim.emailCfg ) ;
 	end
-end 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+end
 
+function done = pointDone( sim, nErr, nErr2, nFErr, nFrm, K )
+% stopping rule of one Eb/N0 point, same as pointDone() in MEX/sim.c when relCI > 0
 
+	if sim.maxFrames > 0 && nFrm >= sim.maxFrames
+		done = true ;
+	elseif sim.relCI > 0
+		ci		= simCI( nErr, nErr2, nFErr, nFrm, K ) ;
+		done	= ( nFErr >= 10 && ci.rel <= sim.relCI ) || ( sim.ferFloor > 0 && nFrm > 0 && ci.ferHi < sim.ferFloor ) ;
+	else
+		done	= nErr >= sim.minErr ;
+	end
+end
@@ -0,0 +1,153 @@
+%This file runs the native C decoder benchmark ( MEX/main.c ) for every
+%standard code: 19 x 6 WiMAX and 3 x 4 WiFi 6 codes, each with the float and
+%fixed-point decoder, for several nr. of threads and Eb/N0 points.
+%Every code is compiled into its own main binary, so you need a C compiler
+%( cc ) with POSIX threads, MATLAB Communications Toolbox is not needed.
+%
+%Results: wall-clock throughput in Mbps of decoded data bits, frames/s and
+%average nr. of iterations, p50/p90/p99/p99.9 and max. per-frame latency in us
+%of converged and not converged frames, one row per code, method, threads and Eb/N0,
+%written to res/bench_<date>.csv and res/bench_<date>.json .
+%The codes in mexCodes are also built at -O2 like the MEX files ( <code>_O2 rows ).
+%MEX/ldpc.h and MEX/ldpc.c are regenerated for every code, like WTF() does.
+%
+%Regression tracking: set baseline to an earlier res/bench_<date>.csv, every
+%row is compared with it ( main -C ), the comparison goes to
+%res/bench_<date>_compare.txt and the regressions are listed in the end.
+%
+%Layer schedules: every point runs with each of schedules ( YALDPC_SCHED ), the
+%natural and overlap rows are joined into res/bench_<date>_sched.csv with the
+%throughput and iterations of both.
+
+clear ;
+format compact ;
+
+path( './lib', path ) ;
+path( './MEX', path ) ;
+
+%only need to modify these values ----------------------------------------
+
+methods		= { 'float' 'fixed' } ;
+threads		= [ 1 2 4 8 ] ;
+ebn0		= '2:1:5' ;		% Eb/N0 points in dB, from:step:to
+rounds		= 10 ;			% decoder rounds over 1000 codewords
+nIter		= 10 ;
+early		= true ;		% early termination, otherwise all nIter iterations
+perf		= false ;		% hardware counters per decoded bit, Linux only
+runs		= 3 ;			% runs per point, mean and std. deviation for the regression check
+baseline	= '' ;			% earlier bench CSV to compare with, '' > none
+threshold	= 5 ;			% regression threshold in %
+schedules	= { 'natural' 'overlap' } ;	% layer schedules, see MEX/schedule.inc
+cc			= 'cc -O3 -march=native -DNDEBUG -pthread' ;
+ccMex		= 'cc -O2 -DNDEBUG -pthread' ;	% the MEX -O build, rows labeled <code>_O2
+mexCodes	= { 'wifi_1944_34' } ;	% codes also built with ccMex
+
+%only need to modify these values ----------------------------------------
+
+codes	= {} ;
+R		= [ 5/6 3/4 3/4 2/3 2/3 1/2 ] ;	% WiMAX code ids 0 .. 5
+variant	= { '' 'A' 'B' 'A' 'B' '' } ;
+for n = 576 + 96 * [ 0 : 1 : 18 ]
+	for id = 0 : 5
+		c		= loadWIMAX_LDPC( R( id + 1 ), n, id ) ;
+		c.label	= [ 'wimax_' num2str( n ) '_' rate2str( R( id + 1 ) ) variant{ id + 1 } ] ;
+		codes{ end + 1 } = c ;
+	end
+end
+for n = [ 648 1296 1944 ]
+	for r = [ 1/2 2/3 3/4 5/6 ]
+		c		= loadQCLDPC( 'wifi', r, n ) ;
+		c.label	= [ 'wifi_' num2str( n ) '_' rate2str( r ) ] ;
+		codes{ end + 1 } = c ;
+	end
+end
+
+enc = QCLDPCEncode() ;
+dec = QCLDPCDecode() ;
+dec.nIter	= nIter ;
+dec.nthread	= max( threads ) ;
+dec.qbits	= 9 ;
+dec.fp_max	= 512 ;
+
+name	= [ 'res/bench_' datestr( now, 'yyyymmdd_HHMMSS' ) ] ;
+csv		= '' ;
+opts	= [ ' -e ' ebn0 ' -d ' num2str( rounds ) ' -R ' num2str( runs ) ' -o csv' ] ;
+if early
+	opts = [ opts ' -E' ] ;
+end
+if perf
+	opts = [ opts ' -P' ] ;
+end
+if ~isempty( baseline )
+	opts = [ opts ' -C ' baseline ' -T ' num2str( threshold ) ' 2>> ' name '_compare.txt' ] ;
+end
+regressed = {} ;
+
+tstart = tic ;
+for i = 1 : numel( codes )
+	for m = 1 : numel( methods )
+		dec.method = methods{ m } ;
+		dec = QCLDPCDecode( dec ) ;
+		saveLDPCheader( 'ldpc', codes{ i }, enc, dec, 'MEX' ) ;
+
+		builds = { { cc, codes{ i }.label } } ;
+		if any( strcmp( mexCodes, codes{ i }.label ) )
+			builds{ end + 1 } = { ccMex, [ codes{ i }.label '_O2' ] } ;
+		end
+
+		for b = 1 : numel( builds )
+			label = builds{ b }{ 2 } ;
+			cmd = [ 'cd MEX && ' builds{ b }{ 1 } ' -o main_bench main.c decoderMT.c encoder.c ldpc.c debug.c sim.c rng.c demap.c latency.c perf.c benchcmp.c kernel.c -lm' ] ;
+			if system( cmd ) ~= 0
+				error( [ 'Build FAIL: ' label ' ' methods{ m } ] ) ;
+			end
+
+			for t = threads
+				for s = schedules
+					[ st, out ] = system( [ 'YALDPC_SCHED=' s{ 1 } ' MEX/main_bench -t ' num2str( t ) opts ' -L ' label ] ) ;
+					if st == 2	% main -C: throughput or latency regressed
+						regressed{ end + 1 } = [ label ' ' methods{ m } ' ' num2str( t ) ' threads ' s{ 1 } ] ;
+					elseif st ~= 0
+						error( [ 'Benchmark FAIL: ' label ' ' methods{ m } ' ' s{ 1 } ': ' out ] ) ;
+					end
+					lines = splitlines( strtrim( out ) ) ;
+					if isempty( csv )
+						csv = [ lines{ 1 } newline ] ;	% header once
+					end
+					csv = [ csv strjoin( lines( 2 : end ), newline ) newline ] ;
+					fprintf( '%s', strjoin( lines( 2 : end ), newline ), newline ) ;
+				end
+			end
+		end
+	end
+end
+disp( [ 'Benchmark finished in: ' datestr( datenum( 0, 0, 0, 0, 0, toc( tstart ) ), "HH:MM:SS" ) ] ) ;
+
+fh = fopen( [ name '.csv' ], 'w' ) ;
+fprintf( fh, '%s', csv ) ;
+fclose( fh ) ;
+
+res = readtable( [ name '.csv' ], 'TextType', 'char' ) ;
+fh = fopen( [ name '.json' ], 'w' ) ;
+fprintf( fh, '%s\n', jsonencode( table2struct( res ) ) ) ;
+fclose( fh ) ;
+
+disp( [ 'Results: ' name '.csv ' name '.json' ] ) ;
+
+%natural vs. overlap layer schedule, same code, method, kernels, threads and Eb/N0
+if all( ismember( { 'natural' 'overlap' }, schedules ) )
+	keys	= { 'label' 'fp' 'isa' 'threads' 'ebn0' } ;
+	nat		= res( strcmp( res.sched, 'natural' ), [ keys { 'mbps' 'iterations' } ] ) ;
+	ovl		= res( strcmp( res.sched, 'overlap' ), [ keys { 'mbps' 'iterations' } ] ) ;
+	nat.Properties.VariableNames( end - 1 : end ) = { 'mbps_natural' 'iter_natural' } ;
+	ovl.Properties.VariableNames( end - 1 : end ) = { 'mbps_overlap' 'iter_overlap' } ;
+	cmp			= innerjoin( nat, ovl, 'Keys', keys ) ;
+	cmp.gain	= 100 * ( cmp.mbps_overlap ./ cmp.mbps_natural - 1 ) ;	% throughput change in %
+	writetable( cmp, [ name '_sched.csv' ] ) ;
+	fprintf( 'Overlap vs. natural schedule: throughput %+.1f %% ( median ), iterations %.2f / %.2f ( mean ), see %s_sched.csv\n', ...
+		median( cmp.gain ), mean( cmp.iter_overlap ), mean( cmp.iter_natural ), name ) ;
+end
+if ~isempty( baseline )
+	disp( [ 'Compared with ' baseline ', ' num2str( numel( regressed ) ) ' regressions, see ' name '_compare.txt' ] ) ;
+	disp( char( regressed ) ) ;
+end
@@ -24,6 +24,8 @@ classdef Bits
 %	L = b.bit2mat( B )
 %		convert bitmap matrix B of type 'type' to a binary double matrix column-wise
 %		nr. of rows of L will be == size( B, 1 ) * 'type' bit-width  
+%
+%	logical2bit and bit2logical run in C if MEX/QCLDPCBitsMEX is built ( see WTF )
 
 properties
 	type = 'uint64' ;
@@ -86,6 +88,10 @@ methods
 			error('Rows must exactly fit to words.')
 		end
 		ru = r / bpw ;
+		if exist( 'QCLDPCBitsMEX', 'file' ) == 3
+			B = o.fromBytes( QCLDPCBitsMEX( 'pack', A ), ru, c, type ) ;
+			return ;
+		end
 		B = zeros( ru, c, type ) ;
 	
 		for j = 1 : c
@@ -127,6 +133,10 @@ methods
 		bpw = o.typeWidth( type ) ;
 		[ r, c ] = size( B ) ;
 		ru = r * bpw ;
+		if exist( 'QCLDPCBitsMEX', 'file' ) == 3
+			L = QCLDPCBitsMEX( 'unpack', o.toBytes( B, ru / 8, c ) ) ;
+			return ;
+		end
 		L = zeros( ru, c, 'logical' ) ;
 		for j = 1 : c
 			for i = 1 : r
@@ -145,6 +155,28 @@ methods
 		M = double( L ) ;
 	end
 	
+	function B = fromBytes( o, U, r, c, type )
+	%uint8 bitmap of QCLDPCBitsMEX to r x c uintXY words, the first byte is the most significant
+		U = reshape( U, [], r * c ) ;
+		if o.littleEndian()
+			U = flipud( U ) ;
+		end
+		B = reshape( typecast( U( : ), type ), r, c ) ;
+	end
+
+	function U = toBytes( o, B, r, c )
+	%uintXY words to an r x c uint8 bitmap of QCLDPCBitsMEX, inverse of fromBytes
+		U = reshape( typecast( B( : ), 'uint8' ), [], numel( B ) ) ;
+		if o.littleEndian()
+			U = flipud( U ) ;
+		end
+		U = reshape( U, r, c ) ;
+	end
+
+	function le = littleEndian( ~ )
+		le = isequal( typecast( uint16( 1 ), 'uint8' ), uint8( [ 1 0 ] ) ) ;
+	end
+
 	function B = vector2bits( o, vL, type )
 	%converts vector of logical values to single uintXY scalar
 		L = length( vL ) ;
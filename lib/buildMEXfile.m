@@ -14,6 +14,7 @@ function buildMEXfile( desc )
 %		optional:
 %		desc.sources - list of additional source file names 
 %		desc.nthreads - if set and > 1 turns on POSIX threading
+%		desc.pthread - if set turns on POSIX threading regardless of nthreads
 %		desc.defines - if set defines compiler macros
 %
 %	for more details and assumptions see: edit buildMEXfile 
@@ -56,7 +57,7 @@ function buildMEXfile( desc )
 		end
 	end
 
-	if isfield( desc, 'nthread' ) && desc.nthread > 1
+	if ( isfield( desc, 'nthread' ) && desc.nthread > 1 ) || isfield( desc, 'pthread' )
 		cmd = [ cmd ' -lpthread' ] ;
 	end
 	
@@ -0,0 +1,24 @@
+function f = frameBatch( code, decoder )
+%frameBatch - nr. of frames per thread the multithreaded decoder ( MEX/decoderMT.c )
+%	decodes layer by layer together, F_B of ldpc.h
+%
+%	f = frameBatch( code, decoder )
+%		decoder.batch	- frames, 0 > as many as their decoder state fits decoder.l2 bytes,
+%						  at most 8, 1 if not set
+%
+%	per frame: ZNold, ZT ( MB tiers ), ZR, LLin and LM of FP, HD, LS and LI
+
+f = 1 ;
+if isfield( decoder, 'batch' ) && decoder.batch > 0
+	f = decoder.batch ;
+elseif isfield( decoder, 'batch' ) && isfield( decoder, 'l2' )
+	[ mb, nb ]	= size( code.Hbm ) ;
+	n			= nb * code.z ;
+	m			= mb * code.z ;
+	fpb			= 4 ;			% float
+	if ~strcmp( decoder.method, 'float' )
+		fpb = 2 ;				% int16_t
+	end
+	ws	= fpb * ( ( mb + 4 ) * n + 2 * m ) + n + 5 * m ;
+	f	= min( max( floor( decoder.l2 / ws ), 1 ), 8 ) ;
+end
@@ -0,0 +1,102 @@
+function res = loadSweep( files, std )
+%loadSweep - merge checkpoints of a native ( sharded ) sweep into a WTF results structure
+%		checkpoints are written by MEX/main -k file [ -w workers ] or QCLDPCSimMEX
+%
+%	res = loadSweep( files )
+%	res = loadSweep( files, std )
+%		files	- checkpoint file name, wildcard pattern ( e.g. 'sweep.ck.*' )
+%				  or cell array of names, all of the same code, decoder and Eb/N0 points
+%		std		- optional standard name stored in res.std for plotWTF, default ''
+%
+%		counters of all files are summed, shards use independent RNG streams,
+%		time of a point is that of its slowest shard
+%		res can be plotted by plotWTF( res )
+%
+%	checkpoint format: see SimSaveCheckpoint() in MEX/sim.c, little endian
+
+	if nargin < 2
+		std = '' ;
+	end
+
+	if ischar( files ) || isstring( files )
+		d		= dir( char( files ) ) ;
+		files	= fullfile( { d.folder }, { d.name } ) ;
+	end
+	if isempty( files )
+		error( 'loadSweep: no checkpoint files.' ) ;
+	end
+
+	HEAD	= 88 ;	% CK_HEAD
+	POINT	= 60 ;	% CK_POINT
+
+	for f = 1 : numel( files )
+		fid = fopen( files{ f }, 'r' ) ;
+		if fid < 0
+			error( 'loadSweep: cannot open %s.', files{ f } ) ;
+		end
+		b = fread( fid, Inf, 'uint8=>uint8' ) ;
+		fclose( fid ) ;
+
+		if numel( b ) < HEAD || ~strcmp( char( b( 1 : 8 )' ), 'YALDPCCK' ) || u32( b, 8 ) ~= 3
+			error( 'loadSweep: %s is not a version 3 checkpoint.', files{ f } ) ;
+		end
+		np = u32( b, 84 ) ;
+		if numel( b ) ~= HEAD + np * POINT + 4
+			error( 'loadSweep: %s is truncated.', files{ f } ) ;
+		end
+
+		if f == 1
+			head	= b( 1 : 80 ) ;	% everything but shard and nr. of points
+			N		= u32( b, 12 ) ;
+			K		= u32( b, 16 ) ;
+			EBN0	= zeros( 1, np ) ;
+			C		= zeros( 5, np ) ;	% bit errors, squared, frame errors, frames, iterations
+			TElaps	= zeros( 1, np ) ;
+			res.nIter	= u32( b, 32 ) ;
+			res.lambda	= f64( b, 36 ) ;
+			res.beta	= f64( b, 44 ) ;
+			res.qam		= u32( b, 64 ) ;
+			res.seed	= typecast( b( 73 : 80 ), 'uint64' ) ;
+		elseif ~isequal( b( 1 : 80 ), head ) || np ~= numel( EBN0 )
+			error( 'loadSweep: %s is from a different configuration.', files{ f } ) ;
+		end
+
+		for x = 1 : np
+			i			= HEAD + ( x - 1 ) * POINT ;
+			EBN0( x )	= f64( b, i ) ;
+			C( :, x )	= C( :, x ) + double( typecast( b( i + 13 : i + 52 ), 'uint64' ) ) ;
+			TElaps( x )	= max( TElaps( x ), f64( b, i + 52 ) ) ;
+		end
+	end
+
+	CI = zeros( 4, np ) ;
+	for x = 1 : np
+		ci			= simCI( C( 1, x ), C( 2, x ), C( 3, x ), C( 4, x ), K ) ;
+		CI( :, x )	= [ ci.berLo ; ci.berHi ; ci.ferLo ; ci.ferHi ] ;
+	end
+
+	res.N			= N ;
+	res.n			= N ;
+	res.R			= K / N ;
+	res.std			= std ;
+	res.impl		= 'SIM' ;
+	res.shards		= numel( files ) ;
+	res.EbN0		= EBN0 ;
+	res.DBits		= C( 4, : ) * K ;
+	res.ERR			= C( 1, : ) ;
+	res.BER			= C( 1, : ) ./ res.DBits ;
+	res.FER			= C( 3, : ) ./ C( 4, : ) ;
+	res.CI			= CI ;
+	res.ITER		= C( 5, : ) ./ C( 4, : ) ;
+	res.TElaps		= TElaps ;
+	res.totalBits	= sum( res.DBits ) ;
+	res.totalTime	= sum( TElaps ) ;
+end
+
+function v = u32( b, i )
+	v = double( typecast( b( i + 1 : i + 4 ), 'uint32' ) ) ;
+end
+
+function v = f64( b, i )
+	v = typecast( b( i + 1 : i + 8 ), 'double' ) ;
+end
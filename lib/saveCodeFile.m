@@ -0,0 +1,57 @@
+function saveCodeFile( code, filename )
+%saveCodeFile - write a QC-LDPC code as a libyaldpc code file ( MEX/yaldpc.h )
+%		only hbm and z, yaldpc_code_load() makes the derived tables,
+%		yaldpc_code_save() writes a file with them embedded
+%
+%	saveCodeFile( code, filename )
+%		code		- code structure with the scaled base matrix code.Hbm ( -1 > zero block )
+%					  and block size code.z <= 128, e.g. from loadQCLDPC
+%		filename	- code file name
+%
+%	code file format: see yaldpc_code_save() in MEX/yaldpc.c, little endian
+
+	hbm			= double( code.Hbm ) ;
+	z			= double( code.z ) ;
+	[ mb, nb ]	= size( hbm ) ;
+
+	if z < 1 || z > 128	% Y_ZMAX, shifts are int8 in the file
+		error( 'saveCodeFile: z must be 1 .. 128.' ) ;
+	end
+	if any( hbm( : ) < -1 | hbm( : ) >= z ) || any( hbm( : ) ~= round( hbm( : ) ) )
+		error( 'saveCodeFile: shifts must be -1 .. z - 1.' ) ;
+	end
+
+	HEAD	= 48 ;	% Y_FILE_HEAD
+	len		= HEAD + ceil( mb * nb / 8 ) * 8 + 4 ;
+	gmax	= max( sum( hbm >= 0, 2 ) ) ;
+
+	b				= zeros( 1, len, 'uint8' ) ;
+	b( 1 : 8 )		= uint8( 'YALDPCCF' ) ;
+	%version, flags, mb, nb, z, gmax, no encoder plan, p0, length, reserved
+	b( 9 : 48 )		= u32( [ 1 0 mb nb z gmax 2^32-1 0 len 0 ] ) ;
+	b( HEAD + 1 : HEAD + mb * nb ) = typecast( int8( reshape( hbm.', 1, [] ) ), 'uint8' ) ;
+	b( len - 3 : len ) = u32( fnv1a( b( 1 : len - 4 ) ) ) ;
+
+	fid = fopen( filename, 'w' ) ;
+	if fid < 0
+		error( 'saveCodeFile: cannot write %s.', filename ) ;
+	end
+	fwrite( fid, b, 'uint8' ) ;
+	fclose( fid ) ;
+end
+
+function b = u32( v )
+	b = typecast( uint32( v ), 'uint8' ) ;
+	if typecast( uint16( 1 ), 'uint8' ) ~= [ 1 0 ]
+		b = reshape( flipud( reshape( b, 4, [] ) ), 1, [] ) ;	% big endian host
+	end
+end
+
+function h = fnv1a( b )
+	%32-bit FNV-1a in doubles: h * 16777619 = h * 2^24 + h * 403 modulo 2^32
+	h = 2166136261 ;
+	for i = 1 : numel( b )
+		h = bitxor( h, double( b( i ) ) ) ;
+		h = mod( mod( h, 256 ) * 2^24 + h * 403, 2^32 ) ;
+	end
+end
@@ -112,6 +112,12 @@ else
 	fprintf( fh, [ '#define LMX ' num2str( decoder.llrmax ) '.0f\n' ] ) ;	
 end
 fprintf( fh, [ '#define N_TH ' num2str( decoder.nthread ) ' //nr. of decoder threads\n' ] ) ;
+fprintf( fh, [ '#define F_B ' num2str( frameBatch( code, decoder ) ) ' //frames per thread decoded layer by layer together\n' ] ) ;
+if isfield( decoder, 'schedule' ) && strcmp( decoder.schedule, 'overlap' )
+	fprintf( fh, '#define SCHED 1 //layer schedule: 0 > natural, 1 > fewest columns shared by consecutive layers, see schedule.inc\n' ) ;
+else
+	fprintf( fh, '#define SCHED 0 //layer schedule: 0 > natural, 1 > fewest columns shared by consecutive layers, see schedule.inc\n' ) ;
+end
 
 fprintf( fh, '\n//Definitions for MEX:\n' ) ;
 fprintf( fh, '\n//Encoder:\n' ) ;
@@ -0,0 +1,54 @@
+function ci = simCI( nErr, nErr2, nFErr, nFrm, K )
+%simCI - 95 % confidence intervals of BER and FER of one Eb/N0 point
+%		same as SimInterval() in MEX/sim.c
+%
+%	ci = simCI( nErr, nErr2, nFErr, nFrm, K )
+%		nErr	- bit errors
+%		nErr2	- sum of squared per-frame bit errors
+%		nFErr	- frame errors
+%		nFrm	- frames simulated
+%		K		- data bits per frame
+%
+%		FER: Wilson score interval, frames are independent
+%		BER: normal interval of the mean nr. of bit errors per frame,
+%			errors within a frame are not independent
+%		ci.rel - larger of the BER and FER relative half-widths, Inf without errors
+
+	z	= 1.959963984540054 ;
+
+	ci.ber = 0 ; ci.berLo = 0 ; ci.berHi = 1 ;
+	ci.fer = 0 ; ci.ferLo = 0 ; ci.ferHi = 1 ;
+	ci.rel = Inf ;
+
+	if nFrm == 0
+		return ;
+	end
+
+	n	= nFrm ;
+	f	= nFErr / n ;
+	d	= 1 + z ^ 2 / n ;
+	m	= ( f + z ^ 2 / ( 2 * n ) ) / d ;
+	h	= z * sqrt( f * ( 1 - f ) / n + z ^ 2 / ( 4 * n ^ 2 ) ) / d ;
+
+	ci.fer		= f ;
+	ci.ferLo	= max( m - h, 0 ) * ( nFErr > 0 ) ;
+	ci.ferHi	= min( m + h, 1 ) ;
+
+	m	= nErr / n ;
+	v	= 0 ;
+	if n > 1
+		v = max( ( nErr2 - m ^ 2 * n ) / ( n - 1 ), 0 ) ;
+	end
+	h	= z * sqrt( v / n ) ;
+
+	ci.ber		= m / K ;
+	ci.berLo	= max( m - h, 0 ) / K ;
+	ci.berHi	= ( m + h ) / K ;
+	if nErr == 0
+		ci.berHi = ci.ferHi ;
+	end
+
+	if nFErr > 0
+		ci.rel = max( ( ci.ferHi - ci.ferLo ) / ( 2 * f ), h / m ) ;
+	end
+end
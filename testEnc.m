@@ -206,3 +206,43 @@ fprintf("Test OK: %d, test FAILED: %d\n", nOK, nFail ) ;
 
 
 
+
+%% Test 10: 'generic' parity encoder must match Annex G on standard codes
+std			= 'wifi' ;
+R			= 1 / 2 ;
+n			= 648 ;
+cod			= loadQCLDPC( std, R, n ) ;
+enc			= QCLDPCEncode( ) ;
+dec			= QCLDPCDecode( ) ;
+saveLDPCheader( 'ldpc', cod, enc, dec, 'MEX' ) ;
+buildMEXfile( enc ) ;
+
+Data		= randui( cod.K, chan ) ;
+CW			= QCLDPCEncode( Data, cod, enc ) ;
+enc.parity	= 'generic' ;
+CWG			= QCLDPCEncode( Data, cod, enc ) ;
+
+if areOrthogonal( CWG, cod.H ) && isequal( CW, CWG ) disp('Encoder test 10 OK') ; else disp('Encoder test 10 FAIL') ; end
+
+%% Test 11: 'generic' parity encoder with a custom code, parity part not dual-diagonal
+%block lower-triangular parity part with shifted diagonal is always invertible
+cod.std		= 'custom' ;
+Hbm			= cod.Hbm ;
+Mb			= cod.Mb ;
+Hbm( :, end - Mb + 1 : end ) = -1 ;
+for i = 1 : Mb
+	Hbm( i, cod.Nb - Mb + i ) = mod( 3 * i, cod.z ) ;
+	if i > 2
+		Hbm( i, cod.Nb - Mb + i - 2 ) = mod( 7 * i, cod.z ) ;
+	end
+end
+cod.Hbm		= Hbm ;
+cod.Hs		= LDPCUncompressH( Hbm, cod.z ) ;
+cod.H		= full( cod.Hs ) ;
+saveLDPCheader( 'ldpc', cod, enc, dec, 'MEX' ) ;
+buildMEXfile( enc ) ;
+
+Data		= randui( cod.K, chan ) ;
+CW			= QCLDPCEncode( Data, cod, enc ) ;
+
+if areOrthogonal( CW, cod.H ) disp('Encoder test 11 OK') ; else disp('Encoder test 11 FAIL') ; end
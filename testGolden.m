@@ -0,0 +1,214 @@
+%This file runs the golden-vector regression test of all decoder variants:
+%decoder.c, decoderMT.c, the float and fixed-point ( FIXED ) decoders and
+%the QCLDPCDecodeMEX and QCLDPCDecodeMEX_MTX wrappers.
+%
+%The C harness MEX/golden.c decodes frames from the counter-based RNG and
+%compares iterations, bit errors and a hash of the posterior LLRs with the
+%golden vectors in golden/<code>_<method>.txt, they must be bit-exact,
+%also for every instruction set of the kernels ( YALDPC_ISA, see MEX/kernel.h )
+%for batches of frames decoded layer by layer ( golden -B, F_B of ldpc.h )
+%and BER-equivalent with the optimized layer schedule ( YALDPC_SCHED=overlap )
+%and for libyaldpc ( MEX/yaldpc.h ) with the float decoder, which also checks
+%code files, typed decoding, streams and the standard codes of yaldpc_code_get()
+%against golden/std_hbm.txt, written from loadQCLDPC.
+%The MEX wrappers then decode the same channel LLRs and must return the
+%same posteriors and iterations as the harness.
+%Golden vectors of a new code are written with update = true, check the
+%printed BER / FER first, then commit them.
+%
+%You need a C compiler ( cc ) with POSIX threads and MEX configured for the
+%wrappers ( mexWrappers = false skips them ).
+%It should not produce any errors, and all tests should run OK.
+
+clear ;
+format compact ;
+
+path( './lib', path ) ;
+path( './MEX', path ) ;
+
+%only need to modify these values ----------------------------------------
+
+codes		= { { 'wifi', 3/4, 1944 } } ;	% std, R, N
+methods		= { 'float' 'fixed' } ;
+nthread		= 4 ;			% decoderMT.c threads, the nr. of frames must be a multiple
+batch		= 3 ;			% decoderMT.c frames per thread decoded together ( F_B ), also for the MEX wrappers
+isas		= { 'scalar' 'sse4.2' 'avx2' 'avx512' } ;	% kernels, those the CPU lacks fall back
+update		= false ;		% write missing golden vectors instead of failing
+mexWrappers	= true ;
+cc			= 'cc -O3 -DNDEBUG -pthread' ;
+ccMex		= 'cc -O2 -DNDEBUG -pthread' ;	% optimization of the MEX -O build, the kernels must vectorize there too
+
+%only need to modify these values ----------------------------------------
+
+srcs	= ' encoder.c ldpc.c debug.c sim.c rng.c demap.c latency.c kernel.c yaldpc.c ykernel.c ystd.c -lm' ;
+enc		= QCLDPCEncode() ;
+fails	= 0 ;
+
+stdFile	= fullfile( pwd, 'golden', 'std_hbm.txt' ) ;
+if ~isfile( stdFile )
+	if ~update
+		error( [ 'No standard codes: ' stdFile ', set update = true to write them.' ] ) ;
+	end
+	writeStdCodes( stdFile ) ;
+end
+
+for i = 1 : numel( codes )
+	std		= codes{ i }{ 1 } ;
+	R		= codes{ i }{ 2 } ;
+	n		= codes{ i }{ 3 } ;
+	cod		= loadQCLDPC( std, R, n ) ;
+
+	for m = 1 : numel( methods )
+		label	= [ std '_' num2str( n ) '_' rate2str( R ) '_' methods{ m } ] ;
+		file	= fullfile( pwd, 'golden', [ label '.txt' ] ) ;
+
+		dec			= QCLDPCDecode() ;
+		dec.method	= methods{ m } ;
+		dec.nthread	= nthread ;
+		dec.batch	= batch ;
+		dec			= QCLDPCDecode( dec ) ;
+		saveLDPCheader( 'ldpc', cod, enc, dec, 'MEX' ) ;
+
+		cmd = [ 'cd MEX && ' cc ' -o golden_st golden.c decoder.c' srcs ' && ' cc ' -o golden_mt golden.c decoderMT.c' srcs ' && ' ccMex ' -o golden_o2 golden.c decoderMT.c' srcs ] ;
+		if system( cmd ) ~= 0
+			error( [ 'Build FAIL: ' label ] ) ;
+		end
+
+		if ~isfile( file )
+			if ~update
+				error( [ 'No golden vectors: ' file ', set update = true to write them.' ] ) ;
+			end
+			system( [ 'MEX/golden_st -g ' file ] ) ;
+		end
+
+		%C harness: single-threaded and multi-threaded decoder
+		st = system( [ 'MEX/golden_st -d MEX/golden_st.bin ' file ] ) ;
+		fails = fails + ( st ~= 0 ) ;
+		for a = 1 : numel( isas )
+			st = system( [ 'YALDPC_ISA=' isas{ a } ' MEX/golden_mt -t ' num2str( nthread ) ' ' file ] ) ;
+			fails = fails + ( st ~= 0 ) ;
+		end
+		for a = 1 : numel( isas )
+			st = system( [ 'YALDPC_ISA=' isas{ a } ' MEX/golden_o2 -t ' num2str( nthread ) ' ' file ] ) ;
+			fails = fails + ( st ~= 0 ) ;
+		end
+		st = system( [ 'MEX/golden_mt -B -t ' num2str( nthread ) ' ' file ] ) ;
+		fails = fails + ( st ~= 0 ) ;
+		st = system( [ 'YALDPC_SCHED=overlap MEX/golden_mt -b -t ' num2str( nthread ) ' ' file ] ) ;
+		fails = fails + ( st ~= 0 ) ;
+
+		%libyaldpc: the same code made at run-time, float only
+		if strcmp( methods{ m }, 'float' )
+			st = system( [ 'MEX/golden_mt -y -t ' num2str( nthread ) ' ' file ] ) ;
+			fails = fails + ( st ~= 0 ) ;
+		end
+
+		if ~mexWrappers
+			continue ;
+		end
+
+		%MEX wrappers: same channel LLRs, same posteriors
+		D		= readDump( 'MEX/golden_st.bin', dec.type ) ;
+		Options	= [ dec.nIter, dec.lambda, dec.beta, 0, double( strcmp( dec.term, 'early' ) ) ] ;
+
+		b			= dec ;
+		b.mexfun	= 'QCLDPCBitsMEX' ;	% packed-bit utilities, code independent
+		b.sources	= [ "ykernel.c" ] ;
+		buildMEXfile( b ) ;
+
+		wrappers = { { 'QCLDPCDecodeMEX', 1 } { 'QCLDPCDecodeMEX', nthread } { 'QCLDPCDecodeMEX_MTX', nthread } } ;
+		for w = 1 : numel( wrappers )
+			d			= dec ;
+			d.mexfun	= wrappers{ w }{ 1 } ;
+			d.nthread	= wrappers{ w }{ 2 } ;
+			d			= QCLDPCDecode( d ) ;
+			saveLDPCheader( 'ldpc', cod, enc, d, 'MEX' ) ;	% N_TH selects the threading of the wrapper
+			buildMEXfile( d ) ;
+
+			[ ApLLR, nIter ] = feval( d.mexfun, D.LLch, Options ) ;
+			[ ApLLR2, nIter2 ] = feval( d.mexfun, D.LLch, Options ) ;	% reuses the decoder context and threads
+			feval( d.mexfun ) ;	% end all worker threads
+
+			ok = isequal( ApLLR, D.ApLLR ) && isequal( nIter( : ), D.nIter ) ;
+			ok = ok && isequal( ApLLR2, ApLLR ) && isequal( nIter2, nIter ) ;
+			if strcmp( d.mexfun, 'QCLDPCDecodeMEX' )
+				%double posteriors, float decoder also from double LLRs, converted in the decoder
+				LLch = D.LLch ;
+				if strcmp( d.method, 'float' )
+					LLch = double( LLch ) ;
+				end
+				[ ApLLR3, nIter3 ] = QCLDPCDecodeMEX( LLch, [ Options 1 ] ) ;
+				ok = ok && isequal( ApLLR3, double( D.ApLLR ) ) && isequal( nIter3, nIter ) ;
+
+				%bits-only: packed systematic hard decisions and posteriors
+				[ B, nIter4, Sys ] = QCLDPCDecodeMEX( D.LLch, [ Options 0 1 ] ) ;
+				K		= size( Sys, 1 ) ;
+				hd		= [ D.ApLLR( 1 : K, : ) < 0 ; false( mod( -K, 8 ), size( D.ApLLR, 2 ) ) ] ;
+				Bref	= uint8( reshape( sum( reshape( hd, 8, [], size( hd, 2 ) ) .* 2 .^ ( 7 : -1 : 0 )', 1 ), [], size( hd, 2 ) ) ) ;
+				ok = ok && isequal( B, Bref ) && isequal( Sys, D.ApLLR( 1 : K, : ) ) && isequal( nIter4, nIter ) ;
+
+				%packed-bit utilities: the same bitmap, back to the hard decisions, no bit errors
+				ok = ok && isequal( QCLDPCBitsMEX( 'pack', hd( 1 : K, : ) ), Bref ) ;
+				ok = ok && isequal( QCLDPCBitsMEX( 'unpack', B, K ), hd( 1 : K, : ) ) ;
+				ok = ok && ~any( QCLDPCBitsMEX( 'errors', B, Bref ) ) ;
+			end
+			disp( [ 'Golden ' ifelse( ok, 'OK', 'FAIL' ) ': ' label ' ' d.mexfun ' ' num2str( d.nthread ) ' threads' ] ) ;
+			fails = fails + ~ok ;
+		end
+	end
+end
+
+if fails > 0
+	error( [ 'Golden-vector regression FAIL: ' num2str( fails ) ' checks.' ] ) ;
+end
+disp( 'All golden-vector checks OK.' ) ;
+
+
+%binary dump of golden.c -d: int32 N, frames, sizeof( FP ), LLch, ApLLR, int32 iterations
+function D = readDump( name, type )
+	fid = fopen( name, 'r' ) ;
+	h	= fread( fid, 3, 'int32' ) ;
+	D.LLch	= reshape( fread( fid, h( 1 ) * h( 2 ), [ type '=>' type ] ), h( 1 ), h( 2 ) ) ;
+	D.ApLLR	= reshape( fread( fid, h( 1 ) * h( 2 ), [ type '=>' type ] ), h( 1 ), h( 2 ) ) ;
+	D.nIter	= fread( fid, h( 2 ), 'int32' ) ;
+	fclose( fid ) ;
+end
+
+%base matrices of all standard codes for golden -y: std n rnum rden variant mb z hash,
+%hash = 31 hash + shift over the shifts row by row, int8 as uint32, as golden.c hbmHash()
+function writeStdCodes( name )
+	fid = fopen( name, 'w' ) ;
+	fprintf( fid, '# yaldpc_code_get() reference: base matrices of loadQCLDPC, written by testGolden.m\n' ) ;
+	fprintf( fid, '# std n rnum rden variant mb z hash ( h = 31 h + shift over the mb x 24 shifts row by row, int8 as uint32, hex )\n' ) ;
+	R = { [ 1 2 ] [ 2 3 ] [ 3 4 ] [ 5 6 ] } ;
+	for n = [ 648 1296 1944 ]
+		for r = 1 : numel( R )
+			c = loadQCLDPC( 'wifi', R{ r }( 1 ) / R{ r }( 2 ), n ) ;
+			fprintf( fid, 'wifi %d %d %d - %d %d %08x\n', n, R{ r }, size( c.Hbm, 1 ), c.z, hbmHash( c.Hbm ) ) ;
+		end
+	end
+	R		= { [ 5 6 ] [ 3 4 ] [ 3 4 ] [ 2 3 ] [ 2 3 ] [ 1 2 ] } ;	% WiMAX code ids 0 .. 5
+	variant	= '-ABAB-' ;
+	for n = 576 + 96 * [ 0 : 1 : 18 ]
+		for id = 0 : 5
+			c = loadWIMAX_LDPC( R{ id + 1 }( 1 ) / R{ id + 1 }( 2 ), n, id ) ;
+			fprintf( fid, 'wimax %d %d %d %c %d %d %08x\n', n, R{ id + 1 }, variant( id + 1 ), size( c.Hbm, 1 ), c.z, hbmHash( c.Hbm ) ) ;
+		end
+	end
+	fclose( fid ) ;
+end
+
+function h = hbmHash( hbm )
+	h = 0 ;
+	for v = reshape( double( hbm ).', 1, [] )
+		h = mod( h * 31 + mod( v, 2^32 ), 2^32 ) ;
+	end
+end
+
+function s = ifelse( c, a, b )
+	if c
+		s = a ;
+	else
+		s = b ;
+	end
+end